@@ -42,7 +42,7 @@ const busquedaSchema = new mongoose.Schema({
 
   algoritmoUsado: {
     type: String,
-    enum: ['kmp', 'rabin-karp', 'aho-corasick'],
+    enum: ['kmp', 'rabin-karp', 'aho-corasick', 'simd', 'myers', 'hamming', 'fm-index', 'rabin-karp-multiple'],
     required: true
   },
 
@@ -21,7 +21,8 @@
  * - Fácil de cambiar (si cambias el .exe, solo modificas esto)
  */
 
-const { execFile } = require('child_process');
+const { execFile, spawn } = require('child_process');
+const readline = require('readline');
 const fs = require('fs').promises;
 const path = require('path');
 const crypto = require('crypto');
@@ -158,6 +159,62 @@ exports.ejecutarBusqueda = async (patrones, sospechosos) => {
   }
 };
 
+/**
+ * ============================================
+ * FUNCIÓN: EJECUTAR BÚSQUEDA EN STREAMING
+ * ============================================
+ *
+ * Igual que ejecutarBusqueda, pero con --stream: el motor escribe una
+ * línea JSON por evento (encabezado, cada coincidencia, resumen) mientras
+ * recorre los sospechosos, así cada coincidencia se puede guardar sin
+ * esperar a que termine la búsqueda ni cargar toda la respuesta en memoria.
+ *
+ * @param {Array<String>} patrones - Array de patrones de ADN
+ * @param {Array<Object>} sospechosos - Array de objetos sospechoso
+ * @param {Function} alCoincidir - async (coincidencia) => {...}; recibe
+ *   { nombre, cedula, patron_id, patron, posicion, distancia, hebra }
+ * @returns {Object} Encabezado + resumen (sin el array de coincidencias)
+ * @throws {Error} Con codigoError 'TIMEOUT' si el motor superó CPP_TIMEOUT_MS,
+ *   o el codigo_error del motor (INVALID_ARGUMENTS, FILE_ERROR, ...)
+ */
+exports.ejecutarBusquedaStreaming = async (patrones, sospechosos, alCoincidir) => {
+  let archivoTemporal = null;
+
+  try {
+    archivoTemporal = await crearCSVTemporal(sospechosos);
+
+    const cppEnginePath = process.env.CPP_ENGINE_PATH || '../cpp-engine/build/busqueda_adn.exe';
+    const resultado = await ejecutarComandoStreaming(
+      cppEnginePath.replace(/\\/g, '/'),
+      [patrones.join(','), archivoTemporal.replace(/\\/g, '/'), '--stream'],
+      alCoincidir
+    );
+
+    const hashArchivo = await calcularHashArchivo(archivoTemporal);
+    await fs.unlink(archivoTemporal);
+
+    return {
+      ...resultado,
+      hashSha256Archivo: hashArchivo,
+      nombreArchivoCsv: path.basename(archivoTemporal)
+    };
+
+  } catch (error) {
+    if (archivoTemporal) {
+      try {
+        await fs.unlink(archivoTemporal);
+      } catch (unlinkError) {
+        // Ignorar error al borrar (el archivo podría no existir)
+      }
+    }
+
+    // Conservar el código para que el controlador distinga un timeout
+    const errorBusqueda = new Error(`Error al ejecutar búsqueda de ADN: ${error.message}`);
+    errorBusqueda.codigoError = error.codigoError;
+    throw errorBusqueda;
+  }
+};
+
 /**
  * ============================================
  * FUNCIÓN AUXILIAR: CREAR CSV TEMPORAL
@@ -313,6 +370,96 @@ function ejecutarComandoDirecto(ejecutable, args) {
   });
 }
 
+/**
+ * ============================================
+ * FUNCIÓN AUXILIAR: EJECUTAR COMANDO EN STREAMING
+ * ============================================
+ *
+ * Lee la salida NDJSON del motor línea por línea. Cada coincidencia se
+ * pasa a alCoincidir (con el texto del patrón tomado del encabezado) y se
+ * espera a que termine antes de leer la siguiente.
+ *
+ * @returns {Promise<Object>} Encabezado + resumen
+ */
+async function ejecutarComandoStreaming(ejecutable, args, alCoincidir) {
+  const limiteMs = parseInt(process.env.CPP_TIMEOUT_MS) || 60000;
+  const proceso = spawn(ejecutable, args);
+
+  // Al vencer el plazo la salida se corta (quizás a mitad de una línea):
+  // cualquier error posterior se informa como timeout
+  let expiro = false;
+  const timeout = setTimeout(() => {
+    expiro = true;
+    proceso.kill();
+  }, limiteMs);
+
+  let stderr = '';
+  proceso.stderr.on('data', (datos) => { stderr += datos; });
+  const terminado = new Promise((resolve, reject) => {
+    proceso.on('error', reject);
+    proceso.on('close', resolve);
+  });
+
+  // Si la lectura falla antes del await, nadie espera a terminado: sin
+  // este manejador su rechazo (ej: ejecutable no encontrado) quedaría
+  // como unhandled rejection
+  terminado.catch(() => {});
+
+  let encabezado = null;
+  let resumen = null;
+
+  try {
+    const lineas = readline.createInterface({ input: proceso.stdout, crlfDelay: Infinity });
+
+    for await (const linea of lineas) {
+      if (!linea.trim()) continue;
+      const evento = JSON.parse(linea);
+
+      if (evento.tipo === 'encabezado') {
+        encabezado = evento;
+      } else if (evento.tipo === 'coincidencia') {
+        await alCoincidir({ ...evento, patron: encabezado.patrones[evento.patron_id] });
+      } else if (evento.tipo === 'resumen') {
+        resumen = evento;
+      } else if (evento.tipo === 'error') {
+        const error = new Error(`Motor C++: ${evento.error} - ${evento.detalles || ''}`);
+        error.codigoError = evento.codigo_error;
+        throw error;
+      }
+    }
+
+    await terminado;
+  } catch (error) {
+    if (!expiro) {
+      throw error;
+    }
+  } finally {
+    clearTimeout(timeout);
+    proceso.kill();
+  }
+
+  if (expiro) {
+    const error = new Error(`El motor C++ superó el tiempo límite de ${limiteMs} ms`);
+    error.codigoError = 'TIMEOUT';
+    throw error;
+  }
+
+  if (stderr) {
+    console.warn('⚠️  Warning del motor C++:', stderr);
+  }
+
+  if (!encabezado || !resumen) {
+    throw new Error('El motor C++ terminó sin completar la búsqueda');
+  }
+
+  const { tipo, ...datosEncabezado } = encabezado;
+  return {
+    ...datosEncabezado,
+    total_coincidencias: resumen.total_coincidencias,
+    tiempo_ejecucion_ms: resumen.tiempo_ejecucion_ms
+  };
+}
+
 /**
  * ============================================
  * FUNCIÓN AUXILIAR: CALCULAR HASH SHA256
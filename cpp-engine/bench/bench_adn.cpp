@@ -0,0 +1,337 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+#include <cstdio>
+#include "generador_sintetico.h"
+#include "../include/kmp.h"
+#include "../include/rabin_karp.h"
+#include "../include/aho_corasick.h"
+#include "../include/busqueda_simd.h"
+#include "../include/motor_busqueda.h"
+#include "../include/csv_parser.h"
+#include "../include/json_output.h"
+#include "../include/pool_hilos.h"
+using namespace std;
+
+const string USO =
+    "Uso: ./bench_adn [--suspects N1,N2,...] [--seed S] [--length-mean L] [--length-stddev D]\n"
+    "                 [--gc F] [--repeat-density F] [--patterns P] [--pattern-length M]\n"
+    "                 [--match-rate F] [--iterations I] [--threads N] [--temp-dir DIR]\n"
+    "                 [--engines kmp,rabin-karp,simd,aho-corasick,rabin-karp-multiple,motor,pipeline]\n"
+    "                 [-o salida.json]";
+
+const vector<string> MOTORES = {
+    "kmp", "rabin-karp", "simd", "aho-corasick", "rabin-karp-multiple", "motor", "pipeline"
+};
+
+/**
+ * Tiempo de un motor sobre una base: el mínimo y la mediana de las iteraciones
+ */
+struct Medicion {
+    string motor;
+    size_t numSospechosos = 0;
+    uint64_t totalBases = 0;
+    size_t numPatrones = 0;
+    size_t coincidencias = 0;
+    int iteraciones = 0;
+    double tiempoMinimoMs = 0;
+    double tiempoMedianaMs = 0;
+    string error;
+};
+
+/**
+ * Ejecuta la prueba "iteraciones" veces
+ * @param prueba Devuelve el número de sospechosos con coincidencia
+ */
+Medicion medir(const string& motor, int iteraciones, const function<size_t()>& prueba) {
+    Medicion medicion;
+    medicion.motor = motor;
+    medicion.iteraciones = iteraciones;
+
+    vector<double> tiempos;
+    for (int i = 0; i < iteraciones; i++) {
+        auto inicio = chrono::steady_clock::now();
+        medicion.coincidencias = prueba();
+        auto fin = chrono::steady_clock::now();
+        tiempos.push_back(chrono::duration<double, milli>(fin - inicio).count());
+    }
+
+    sort(tiempos.begin(), tiempos.end());
+    medicion.tiempoMinimoMs = tiempos.front();
+    medicion.tiempoMedianaMs = tiempos[tiempos.size() / 2];
+    return medicion;
+}
+
+/**
+ * Cuenta los sospechosos en los que "buscar" encuentra el patrón
+ */
+template <typename Buscar>
+size_t contarCoincidencias(const vector<Sospechoso>& sospechosos, Buscar buscar) {
+    size_t total = 0;
+    for (const auto& sospechoso : sospechosos) {
+        if (buscar(sospechoso.cadenaADN)) {
+            total++;
+        }
+    }
+    return total;
+}
+
+/**
+ * Mide un motor sobre los datos generados
+ */
+Medicion medirMotor(
+    const string& motor,
+    const DatosSinteticos& datos,
+    const string& rutaCSV,
+    const OpcionesBusqueda& opciones,
+    int iteraciones
+) {
+    const vector<string>& patrones = datos.patrones;
+    const string& patron = patrones[0];
+    Medicion medicion;
+
+    try {
+        if (motor == "kmp") {
+            medicion = medir(motor, iteraciones, [&]() {
+                return contarCoincidencias(datos.sospechosos, [&](const string& adn) { return KMP::buscar(adn, patron) != -1; });
+            });
+        } else if (motor == "rabin-karp") {
+            medicion = medir(motor, iteraciones, [&]() {
+                return contarCoincidencias(datos.sospechosos, [&](const string& adn) { return RabinKarp::buscar(adn, patron) != -1; });
+            });
+        } else if (motor == "simd") {
+            medicion = medir(motor, iteraciones, [&]() {
+                return contarCoincidencias(datos.sospechosos, [&](const string& adn) { return BusquedaSIMD::buscar(adn, patron) != -1; });
+            });
+        } else if (motor == "aho-corasick") {
+            // API estática: construye el autómata en cada llamada
+            medicion = medir(motor, iteraciones, [&]() {
+                return contarCoincidencias(datos.sospechosos, [&](const string& adn) {
+                    return !AhoCorasick::buscarMultiple(adn, patrones).empty();
+                });
+            });
+        } else if (motor == "rabin-karp-multiple") {
+            // Las tablas se preparan una vez por iteración, como en el motor
+            medicion = medir(motor, iteraciones, [&]() {
+                RabinKarpMultiple rabinKarpMultiple(patrones);
+                CoincidenciaMultiple coincidencia;
+                return contarCoincidencias(datos.sospechosos, [&](const string& adn) {
+                    return rabinKarpMultiple.buscarPrimera(adn, coincidencia);
+                });
+            });
+        } else if (motor == "motor") {
+            // MotorBusqueda con los sospechosos ya en memoria (modo servidor)
+            medicion = medir(motor, iteraciones, [&]() {
+                return MotorBusqueda::ejecutar(patrones, datos.sospechosos, opciones).coincidencias.size();
+            });
+        } else if (motor == "pipeline") {
+            // Lo mismo que hace main: leer el CSV, validar, buscar y generar el JSON
+            medicion = medir(motor, iteraciones, [&]() {
+                CSVMapeado csv(rutaCSV);
+                MotorBusqueda::validarPatrones(patrones);
+                MotorBusqueda::validarOpciones(patrones, opciones);
+                ResultadoBusqueda resultado = MotorBusqueda::ejecutar(patrones, csv.sospechosos(), opciones);
+                string salida = JSONOutput::generarExito(
+                    patrones, resultado.algoritmo, resultado.criterio,
+                    resultado.totalProcesados, resultado.coincidencias, 0
+                );
+                return resultado.coincidencias.size();
+            });
+        }
+    } catch (const exception& e) {
+        medicion.motor = motor;
+        medicion.error = e.what();
+    }
+
+    bool unPatron = motor == "kmp" || motor == "rabin-karp" || motor == "simd";
+    medicion.numSospechosos = datos.sospechosos.size();
+    medicion.totalBases = datos.totalBases;
+    medicion.numPatrones = unPatron ? 1 : patrones.size();
+    return medicion;
+}
+
+string escaparJSON(const string& texto) {
+    string resultado;
+    for (char c : texto) {
+        if (c == '"' || c == '\\') resultado += '\\';
+        resultado += c;
+    }
+    return resultado;
+}
+
+string generarJSON(const ConfiguracionSintetica& configuracion, int numHilos, const vector<Medicion>& mediciones) {
+    ostringstream json;
+    json.setf(ios::fixed);
+    json.precision(3);
+
+    json << "{\n";
+    json << "  \"benchmark\": \"bench_adn\",\n";
+    json << "  \"instrucciones_simd\": \"" << BusquedaSIMD::toString(BusquedaSIMD::instruccionesDisponibles()) << "\",\n";
+    json << "  \"hilos\": " << numHilos << ",\n";
+    json << "  \"configuracion\": {\n";
+    json << "    \"semilla\": " << configuracion.semilla << ",\n";
+    json << "    \"longitud_media\": " << configuracion.longitudMedia << ",\n";
+    json << "    \"longitud_desviacion\": " << configuracion.longitudDesviacion << ",\n";
+    json << "    \"contenido_gc\": " << configuracion.contenidoGC << ",\n";
+    json << "    \"densidad_repeticiones\": " << configuracion.densidadRepeticiones << ",\n";
+    json << "    \"num_patrones\": " << configuracion.numPatrones << ",\n";
+    json << "    \"longitud_patron\": " << configuracion.longitudPatron << ",\n";
+    json << "    \"tasa_coincidencias\": " << configuracion.tasaCoincidencias << "\n";
+    json << "  },\n";
+    json << "  \"resultados\": [\n";
+
+    for (size_t i = 0; i < mediciones.size(); i++) {
+        const Medicion& m = mediciones[i];
+        double segundos = m.tiempoMinimoMs / 1000.0;
+
+        json << "    {\n";
+        json << "      \"motor\": \"" << m.motor << "\",\n";
+        json << "      \"sospechosos\": " << m.numSospechosos << ",\n";
+        json << "      \"total_bases\": " << m.totalBases << ",\n";
+        json << "      \"patrones\": " << m.numPatrones << ",\n";
+        if (!m.error.empty()) {
+            json << "      \"error\": \"" << escaparJSON(m.error) << "\"\n";
+        } else {
+            json << "      \"coincidencias\": " << m.coincidencias << ",\n";
+            json << "      \"iteraciones\": " << m.iteraciones << ",\n";
+            json << "      \"tiempo_min_ms\": " << m.tiempoMinimoMs << ",\n";
+            json << "      \"tiempo_mediana_ms\": " << m.tiempoMedianaMs << ",\n";
+            json << "      \"mbases_por_segundo\": " << (segundos > 0 ? m.totalBases / 1e6 / segundos : 0.0) << ",\n";
+            json << "      \"sospechosos_por_segundo\": " << (segundos > 0 ? m.numSospechosos / segundos : 0.0) << "\n";
+        }
+        json << "    }" << (i + 1 < mediciones.size() ? "," : "") << "\n";
+    }
+
+    json << "  ]\n";
+    json << "}";
+    return json.str();
+}
+
+vector<string> dividir(const string& lista) {
+    vector<string> partes;
+    stringstream ss(lista);
+    string parte;
+    while (getline(ss, parte, ',')) {
+        if (!parte.empty()) partes.push_back(parte);
+    }
+    return partes;
+}
+
+int main(int argc, char* argv[]) {
+    map<string, string> opciones;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if ((arg.rfind("--", 0) != 0 && arg != "-o") || i + 1 >= argc) {
+            cerr << USO << endl;
+            return 1;
+        }
+        opciones[arg] = argv[++i];
+    }
+
+    ConfiguracionSintetica configuracion;
+    vector<size_t> escalas = {10000};
+    vector<string> motores = MOTORES;
+    int iteraciones = 3;
+    OpcionesBusqueda opcionesBusqueda;
+    string directorioTemporal;
+
+    try {
+        for (const auto& [opcion, valor] : opciones) {
+            if (opcion == "--suspects") {
+                escalas.clear();
+                for (const auto& escala : dividir(valor)) escalas.push_back(stoull(escala));
+            } else if (opcion == "--seed") {
+                configuracion.semilla = stoull(valor);
+            } else if (opcion == "--length-mean") {
+                configuracion.longitudMedia = stoull(valor);
+            } else if (opcion == "--length-stddev") {
+                configuracion.longitudDesviacion = stoull(valor);
+            } else if (opcion == "--gc") {
+                configuracion.contenidoGC = stod(valor);
+            } else if (opcion == "--repeat-density") {
+                configuracion.densidadRepeticiones = stod(valor);
+            } else if (opcion == "--patterns") {
+                configuracion.numPatrones = stoull(valor);
+            } else if (opcion == "--pattern-length") {
+                configuracion.longitudPatron = stoull(valor);
+            } else if (opcion == "--match-rate") {
+                configuracion.tasaCoincidencias = stod(valor);
+            } else if (opcion == "--iterations") {
+                iteraciones = stoi(valor);
+            } else if (opcion == "--threads") {
+                opcionesBusqueda.numHilos = stoi(valor);
+            } else if (opcion == "--engines") {
+                motores = dividir(valor);
+            } else if (opcion == "--temp-dir") {
+                directorioTemporal = valor;
+            } else if (opcion != "-o") {
+                throw invalid_argument("opción desconocida " + opcion);
+            }
+        }
+
+        for (const auto& motor : motores) {
+            if (find(MOTORES.begin(), MOTORES.end(), motor) == MOTORES.end()) {
+                throw invalid_argument("motor desconocido " + motor);
+            }
+        }
+        if (escalas.empty() || iteraciones < 1 || configuracion.numPatrones < 1 || configuracion.longitudPatron < 1) {
+            throw invalid_argument("valores fuera de rango");
+        }
+    } catch (const exception& e) {
+        cerr << "Argumentos inválidos: " << e.what() << "\n" << USO << endl;
+        return 1;
+    }
+
+    if (directorioTemporal.empty()) {
+        directorioTemporal = filesystem::temp_directory_path().string();
+    }
+    if (opcionesBusqueda.numHilos == 0) {
+        opcionesBusqueda.numHilos = PoolHilos::hilosDisponibles();
+    }
+
+    bool necesitaCSV = find(motores.begin(), motores.end(), "pipeline") != motores.end();
+    vector<Medicion> mediciones;
+
+    for (size_t escala : escalas) {
+        configuracion.numSospechosos = escala;
+        cerr << "[bench] Generando " << escala << " sospechosos (semilla " << configuracion.semilla << ")" << endl;
+        DatosSinteticos datos = GeneradorSintetico::generar(configuracion);
+
+        string rutaCSV = (filesystem::path(directorioTemporal) /
+                          ("bench_adn_" + to_string(configuracion.semilla) + "_" + to_string(escala) + ".csv")).string();
+        if (necesitaCSV) {
+            GeneradorSintetico::escribirCSV(datos, rutaCSV);
+        }
+
+        for (const auto& motor : motores) {
+            cerr << "[bench] " << motor << " x" << iteraciones << endl;
+            mediciones.push_back(medirMotor(motor, datos, rutaCSV, opcionesBusqueda, iteraciones));
+        }
+
+        if (necesitaCSV) {
+            remove(rutaCSV.c_str());
+        }
+    }
+
+    string json = generarJSON(configuracion, opcionesBusqueda.numHilos, mediciones);
+
+    auto salida = opciones.find("-o");
+    if (salida != opciones.end()) {
+        ofstream archivo(salida->second, ios::trunc);
+        archivo << json << endl;
+        if (!archivo.good()) {
+            cerr << "No se pudo escribir " << salida->second << endl;
+            return 1;
+        }
+    } else {
+        cout << json << endl;
+    }
+    return 0;
+}
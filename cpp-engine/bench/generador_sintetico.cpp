@@ -0,0 +1,128 @@
+#include "generador_sintetico.h"
+#include <random>
+#include <fstream>
+#include <stdexcept>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+/**
+ * Números al azar a partir de mt19937_64 (secuencia fija por estándar)
+ */
+class Azar {
+public:
+    explicit Azar(uint64_t semilla) : motor(semilla) {}
+
+    // Entero uniforme en [0, n)
+    uint64_t entero(uint64_t n) {
+        return n == 0 ? 0 : motor() % n;
+    }
+
+    // Real uniforme en [0, 1)
+    double real() {
+        return (motor() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Normal por Box-Muller
+    double normal(double media, double desviacion) {
+        double u1 = 1.0 - real();
+        double u2 = real();
+        return media + desviacion * std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+    }
+
+    char base(double contenidoGC) {
+        if (real() < contenidoGC) {
+            return real() < 0.5 ? 'C' : 'G';
+        }
+        return real() < 0.5 ? 'A' : 'T';
+    }
+
+private:
+    std::mt19937_64 motor;
+};
+
+std::string cadenaAlAzar(Azar& azar, size_t longitud, double contenidoGC) {
+    std::string cadena(longitud, 'A');
+    for (char& c : cadena) {
+        c = azar.base(contenidoGC);
+    }
+    return cadena;
+}
+
+std::string cadenaConRepeticiones(Azar& azar, size_t longitud, const ConfiguracionSintetica& configuracion) {
+    std::string cadena;
+    cadena.reserve(longitud);
+
+    while (cadena.length() < longitud) {
+        size_t tramo = std::min(GeneradorSintetico::LONGITUD_TRAMO, longitud - cadena.length());
+
+        if (azar.real() < configuracion.densidadRepeticiones) {
+            // Repetición en tándem de un motivo de 1 a 6 bases (ej. CACACA...)
+            std::string motivo = cadenaAlAzar(azar, 1 + azar.entero(6), configuracion.contenidoGC);
+            for (size_t i = 0; i < tramo; i++) {
+                cadena.push_back(motivo[i % motivo.length()]);
+            }
+        } else {
+            for (size_t i = 0; i < tramo; i++) {
+                cadena.push_back(azar.base(configuracion.contenidoGC));
+            }
+        }
+    }
+
+    return cadena;
+}
+
+}
+
+DatosSinteticos GeneradorSintetico::generar(const ConfiguracionSintetica& configuracion) {
+    Azar azar(configuracion.semilla);
+    DatosSinteticos datos;
+
+    for (size_t i = 0; i < configuracion.numPatrones; i++) {
+        datos.patrones.push_back(cadenaAlAzar(azar, configuracion.longitudPatron, configuracion.contenidoGC));
+    }
+
+    datos.sospechosos.reserve(configuracion.numSospechosos);
+    for (size_t i = 0; i < configuracion.numSospechosos; i++) {
+        double longitud = azar.normal(static_cast<double>(configuracion.longitudMedia),
+                                      static_cast<double>(configuracion.longitudDesviacion));
+        size_t longitudCadena = std::max(LONGITUD_MINIMA, static_cast<size_t>(std::max(0.0, std::round(longitud))));
+
+        Sospechoso sospechoso;
+        sospechoso.nombreCompleto = "Sospechoso " + std::to_string(i);
+        sospechoso.cedula = std::to_string(10000000 + i);
+        sospechoso.cadenaADN = cadenaConRepeticiones(azar, longitudCadena, configuracion);
+
+        // Plantar un patrón al azar en una posición al azar
+        if (!datos.patrones.empty() && azar.real() < configuracion.tasaCoincidencias) {
+            const std::string& patron = datos.patrones[azar.entero(datos.patrones.size())];
+            if (patron.length() <= sospechoso.cadenaADN.length()) {
+                size_t posicion = azar.entero(sospechoso.cadenaADN.length() - patron.length() + 1);
+                sospechoso.cadenaADN.replace(posicion, patron.length(), patron);
+                datos.plantados++;
+            }
+        }
+
+        datos.totalBases += sospechoso.cadenaADN.length();
+        datos.sospechosos.push_back(std::move(sospechoso));
+    }
+
+    return datos;
+}
+
+void GeneradorSintetico::escribirCSV(const DatosSinteticos& datos, const std::string& rutaArchivo) {
+    std::ofstream salida(rutaArchivo, std::ios::binary | std::ios::trunc);
+    if (!salida.is_open()) {
+        throw std::runtime_error("No se pudo crear el archivo: " + rutaArchivo);
+    }
+
+    salida << "nombre_completo,cedula,cadena_adn\n";
+    for (const auto& sospechoso : datos.sospechosos) {
+        salida << sospechoso.nombreCompleto << ',' << sospechoso.cedula << ',' << sospechoso.cadenaADN << '\n';
+    }
+
+    if (!salida.good()) {
+        throw std::runtime_error("Error al escribir el archivo: " + rutaArchivo);
+    }
+}
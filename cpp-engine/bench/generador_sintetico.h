@@ -0,0 +1,65 @@
+#ifndef GENERADOR_SINTETICO_H
+#define GENERADOR_SINTETICO_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "csv_parser.h"
+
+/**
+ * Parámetros de una base de sospechosos sintética
+ */
+struct ConfiguracionSintetica {
+    uint64_t semilla = 42;
+    size_t numSospechosos = 10000;
+
+    // Longitud de cada cadena: normal(media, desviación), nunca menor que
+    // LONGITUD_MINIMA (el mínimo que acepta el CSV)
+    size_t longitudMedia = 1000;
+    size_t longitudDesviacion = 200;
+
+    double contenidoGC = 0.5;           // Probabilidad de que una base sea C o G
+    double densidadRepeticiones = 0.0;  // Fracción de cada cadena en repeticiones en tándem
+
+    size_t numPatrones = 1;
+    size_t longitudPatron = 120;
+    double tasaCoincidencias = 0.01;    // Fracción de sospechosos con un patrón plantado
+};
+
+/**
+ * Base sintética generada: patrones y sospechosos
+ */
+struct DatosSinteticos {
+    std::vector<std::string> patrones;
+    std::vector<Sospechoso> sospechosos;
+    uint64_t totalBases = 0;
+    size_t plantados = 0;               // Sospechosos con un patrón insertado
+};
+
+/**
+ * Generador reproducible de bases de ADN para los benchmarks
+ *
+ * Con la misma configuración (y semilla) produce exactamente los mismos
+ * datos en cualquier plataforma: usa mt19937_64 y sus propias
+ * distribuciones, no las de <random>, cuyo resultado depende de la
+ * biblioteca estándar.
+ */
+class GeneradorSintetico {
+public:
+    static constexpr size_t LONGITUD_MINIMA = 100;
+
+    // Las cadenas se arman en tramos: cada tramo es una repetición en
+    // tándem con probabilidad densidadRepeticiones, o bases al azar
+    static constexpr size_t LONGITUD_TRAMO = 48;
+
+    static DatosSinteticos generar(const ConfiguracionSintetica& configuracion);
+
+    /**
+     * Escribe la base en el formato CSV que lee busqueda_adn
+     * @throws std::runtime_error si no se puede escribir el archivo
+     */
+    static void escribirCSV(const DatosSinteticos& datos, const std::string& rutaArchivo);
+};
+
+#endif // GENERADOR_SINTETICO_H
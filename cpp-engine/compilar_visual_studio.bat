@@ -9,7 +9,7 @@ cd build
 
 echo.
 echo Compilando con cl.exe...
-cl /EHsc /std:c++17 /O2 /I..\include ..\src\main.cpp ..\src\algorithms\kmp.cpp ..\src\algorithms\rabin_karp.cpp ..\src\algorithms\aho_corasick.cpp ..\src\utils\csv_parser.cpp ..\src\utils\algorithm_selector.cpp ..\src\utils\json_output.cpp /Fe:busqueda_adn.exe
+cl /EHsc /std:c++17 /O2 /I..\include ..\src\main.cpp ..\src\algorithms\kmp.cpp ..\src\algorithms\rabin_karp.cpp ..\src\algorithms\aho_corasick.cpp ..\src\algorithms\busqueda_simd.cpp ..\src\algorithms\busqueda_aproximada.cpp ..\src\utils\csv_parser.cpp ..\src\utils\algorithm_selector.cpp ..\src\utils\json_output.cpp ..\src\utils\motor_busqueda.cpp ..\src\utils\servidor.cpp ..\src\utils\pool_hilos.cpp ..\src\utils\secuencia_empaquetada.cpp ..\src\utils\archivo_mapeado.cpp ..\src\utils\base_datos_binaria.cpp ..\src\utils\indice_kmers.cpp ..\src\utils\indice_fm.cpp ..\src\utils\perfil_costos.cpp ..\src\utils\salida_ndjson.cpp ..\src\utils\instantanea.cpp ..\src\utils\cache_resultados.cpp ..\src\utils\lote_consultas.cpp ..\src\utils\metricas.cpp ..\src\utils\traza.cpp ..\src\utils\validacion_adn.cpp ..\src\utils\almacen_sospechosos.cpp /Fe:busqueda_adn.exe
 
 if %ERRORLEVEL% EQU 0 (
     echo.
@@ -2,18 +2,78 @@
 #define AHO_CORASICK_H
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <queue>
-#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include "secuencia_empaquetada.h"
 
 
 struct CoincidenciaMultiple {
-    int patronId;        
-    int posicion;        
+    int patronId;
+    int posicion;
 };
 
+/**
+ * Autómata de Aho-Corasick compilado para el alfabeto A, C, G, T
+ *
+ * Se construye UNA vez por consulta y se reutiliza sobre todos los
+ * sospechosos. Cada estado guarda una fila densa de 4 transiciones
+ * (goto + fallo ya resueltos), así la búsqueda hace un solo acceso
+ * a memoria por carácter.
+ */
 class AhoCorasick {
 public:
+    /**
+     * Qué coincidencias se entregan al receptor
+     */
+    enum Politica {
+        PRIMERA,             // Solo la primera del texto; se deja de recorrer
+        PRIMERA_POR_PATRON,  // La primera de cada patrón; se deja de recorrer al tener todas
+        TODAS                // Todas las ocurrencias de todos los patrones
+    };
+
+    /**
+     * Recibe cada coincidencia en el orden en que se encuentra
+     */
+    using Receptor = std::function<void(const CoincidenciaMultiple& coincidencia)>;
+
+    /**
+     * Compila el autómata para los patrones dados
+     * Los patrones con caracteres fuera de A, C, G, T nunca coinciden
+     */
+    explicit AhoCorasick(const std::vector<std::string>& patrones);
+
+    /**
+     * Busca todos los patrones en el texto
+     * @return Coincidencias ordenadas por posición final; en la misma
+     *         posición, primero el patrón más largo
+     */
+    std::vector<CoincidenciaMultiple> buscarEn(std::string_view texto) const;
+
+    /**
+     * Variante sobre cadenas empaquetadas: los códigos 2-bit se usan
+     * directamente como columna de la tabla de transiciones
+     */
+    std::vector<CoincidenciaMultiple> buscarEn(const SecuenciaEmpaquetada& texto) const;
+
+    /**
+     * Busca en el texto y entrega las coincidencias al receptor según la
+     * política, sin acumularlas en un vector
+     * @param saltosEnlace Si no es nullptr, suma los enlaces de salida
+     *        seguidos al reportar (las transiciones de fallo ya están
+     *        resueltas en la tabla: es lo único que recorre la cadena de fallos)
+     */
+    void buscarEn(std::string_view texto, Politica politica, const Receptor& receptor,
+                  uint64_t* saltosEnlace = nullptr) const;
+
+    void buscarEn(const SecuenciaEmpaquetada& texto, Politica politica, const Receptor& receptor,
+                  uint64_t* saltosEnlace = nullptr) const;
+
+    /**
+     * Número de estados del autómata (incluye la raíz)
+     */
+    int numEstados() const;
 
     static std::vector<CoincidenciaMultiple> buscarMultiple(
         const std::string& texto,
@@ -23,33 +83,42 @@ public:
     static int buscar(const std::string& texto, const std::string& patron);
 
 private:
-    // Estructura de nodo del trie
-    struct TrieNode {
-        std::unordered_map<char, int> hijos;
-        int fallo;
-        std::vector<int> patronesEncontrados; // IDs de patrones que terminan aquí
-        std::vector<int> longitudesPatrones;   // Longitudes correspondientes
-
-        TrieNode() : fallo(-1) {}
-    };
+    static const int ALFABETO = 4;
 
-    /**
-     * Construye el trie con TODOS los patrones
-     */
-    static void construirTrieMultiple(
-        const std::vector<std::string>& patrones,
-        std::vector<TrieNode>& trie
-    );
+    // Tabla de transiciones completa: transiciones[estado * ALFABETO + base]
+    std::vector<int> transiciones;
+
+    // Siguiente estado en la cadena de fallos que tiene patrones (-1 si no hay)
+    std::vector<int> enlaceSalida;
+
+    // Patrones que terminan en cada estado (formato CSR):
+    // patronesSalida[inicioSalidas[e] .. inicioSalidas[e + 1])
+    std::vector<int> inicioSalidas;
+    std::vector<int> patronesSalida;
+
+    // Longitud de cada patrón, indexada por patronId
+    std::vector<int> longitudes;
 
     /**
-     * Construye el trie de un solo patrón (compatibilidad)
+     * Recorre el texto que entrega el cursor (un código 0-3 o -1 por posición)
      */
-    static int construirTrie(const std::string& patron, std::vector<TrieNode>& trie);
+    template <typename Cursor>
+    void recorrer(Cursor cursor, size_t n, Politica politica, const Receptor& receptor, uint64_t* saltosEnlace) const;
 
     /**
-     * Construye los enlaces de fallo (failure links)
+     * Entrega las coincidencias del estado y su cadena de salidas
+     * @param encontrados Patrones ya reportados (solo PRIMERA_POR_PATRON)
+     * @return true si ya no hace falta seguir recorriendo el texto
      */
-    static void construirFallos(std::vector<TrieNode>& trie);
+    bool reportar(
+        int estado,
+        int posicionFinal,
+        Politica politica,
+        std::vector<char>& encontrados,
+        size_t& pendientes,
+        const Receptor& receptor,
+        uint64_t* saltosEnlace
+    ) const;
 };
 
 #endif // AHO_CORASICK_H
@@ -2,27 +2,77 @@
 #define ALGORITHM_SELECTOR_H
 
 #include <string>
+#include <vector>
+#include <cstdint>
+
+class PerfilCostos;
 
 /**
- * Selector automático del mejor algoritmo según características
- * del patrón y número de sospechosos
+ * Tamaño de una búsqueda: lo que el modelo de costos necesita saber
+ */
+struct CargaTrabajo {
+    // Cómo están guardadas las cadenas: cada motor tiene otro costo en cada una
+    enum Representacion {
+        TEXTO,        // Un byte por base (CSV, .adnb de texto)
+        EMPAQUETADA   // 2 bits por base (--empaquetado, .adnb empaquetada, servidor)
+    };
+
+    int numPatrones = 0;
+    int numLongitudes = 0;               // Longitudes distintas entre los patrones
+    uint64_t longitudTotalPatrones = 0;  // Suma de las longitudes de los patrones
+    uint64_t longitudMinimaPatron = 0;
+    uint64_t numSecuencias = 0;          // Sospechosos a recorrer
+    uint64_t totalBases = 0;             // Suma de las longitudes de sus cadenas
+    uint64_t basesRecorridas = 0;        // De las cadenas que alcanzan al patrón más corto
+                                         // (las demás se descartan sin leerlas)
+    Representacion representacion = TEXTO;
+};
+
+/**
+ * Selector automático del algoritmo de búsqueda exacta con un modelo de
+ * costos: estima el tiempo de cada motor para la carga de trabajo con los
+ * coeficientes de un PerfilCostos para su representación (medidos en esta
+ * máquina con busqueda_adn --calibrate) y elige el más barato
  */
 class AlgorithmSelector {
 public:
     enum Algorithm {
         KMP,
         RABIN_KARP,
-        AHO_CORASICK
+        AHO_CORASICK,
+        SIMD,
+        MYERS,      // Búsqueda aproximada con distancia de edición
+        HAMMING,    // Búsqueda aproximada con distancia de Hamming
+        FM_INDEX,   // Índice FM de la base (sin recorrer los sospechosos)
+        RABIN_KARP_MULTIPLE  // Rabin-Karp de todos los patrones, agrupados por longitud
     };
 
     /**
-     * Selecciona el algoritmo óptimo
-     * @param numPatrones Número de patrones a buscar
-     * @param longitudPromedioPatron Longitud promedio de los patrones
-     * @param numSospechosos Número de sospechosos a procesar
+     * Costo estimado de un algoritmo
+     */
+    struct Estimacion {
+        Algorithm algoritmo;
+        double costoNs;
+    };
+
+    /**
+     * Costo estimado de cada motor exacto que puede usar esta CPU, del más
+     * barato al más caro
+     */
+    static std::vector<Estimacion> estimarCostos(const CargaTrabajo& carga, const PerfilCostos& perfil);
+
+    /**
+     * Selecciona el algoritmo de menor costo estimado
+     * @param hayIndiceFM true si la base tiene un índice FM (búsqueda exacta)
      * @return Algoritmo seleccionado
      */
-    static Algorithm seleccionar(int numPatrones, int longitudPromedioPatron, int numSospechosos);
+    static Algorithm seleccionar(const CargaTrabajo& carga, const PerfilCostos& perfil, bool hayIndiceFM = false);
+
+    /**
+     * Multiplicador de los términos por base y por secuencia del modelo:
+     * cuántas veces se recorre (o consulta) cada base
+     */
+    static double pasadasPor(Algorithm algoritmo, int numPatrones, int numLongitudes);
 
     /**
      * Convierte el enum a string para el output JSON
@@ -30,9 +80,10 @@ public:
     static std::string toString(Algorithm algo);
 
     /**
-     * Obtiene la razón de selección del algoritmo
+     * Obtiene la razón de selección del algoritmo (para los motores
+     * exactos, los costos estimados de todos en milisegundos)
      */
-    static std::string obtenerCriterio(Algorithm algo, int numPatrones, int longitudPromedioPatron, int numSospechosos);
+    static std::string obtenerCriterio(Algorithm algo, const CargaTrabajo& carga, const PerfilCostos& perfil);
 };
 
 #endif // ALGORITHM_SELECTOR_H
@@ -0,0 +1,106 @@
+#ifndef ALMACEN_SOSPECHOSOS_H
+#define ALMACEN_SOSPECHOSOS_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "secuencia_empaquetada.h"
+
+/**
+ * Cédula de un SospechosoAlmacenado: un número (que se escribe en el
+ * propio valor recién al leerla como texto) o una vista al texto original
+ */
+class TextoCedula {
+public:
+    static TextoCedula deNumero(uint64_t valor);
+    static TextoCedula deTexto(std::string_view texto);
+
+    /**
+     * Texto de la cédula (válido mientras viva este valor)
+     */
+    operator std::string_view() const;
+
+    bool esNumerica() const { return numerica; }
+
+    uint64_t numero() const { return valor; }
+
+    /**
+     * Lee una cédula numérica canónica: de 1 a 18 dígitos, sin ceros a la
+     * izquierda (así el número vuelve a dar exactamente el mismo texto)
+     * @return false si el texto no es una cédula numérica canónica
+     */
+    static bool leerNumero(std::string_view texto, uint64_t& valor);
+
+private:
+    bool numerica = false;
+    uint64_t valor = 0;
+    std::string_view texto;
+    mutable char digitos[20];
+};
+
+/**
+ * Sospechoso leído del almacén (vistas a sus arenas)
+ */
+struct SospechosoAlmacenado {
+    std::string_view nombreCompleto;
+    TextoCedula cedula;
+    SecuenciaEmpaquetada cadenaADN;
+};
+
+/**
+ * Sospechosos en columnas (structure of arrays) sobre arenas contiguas
+ *
+ * Todas las cadenas de ADN están empaquetadas, una tras otra, en una sola
+ * arena de palabras (cada una alineada a su palabra y con la de relleno,
+ * como en .adnb); los nombres en otra. Las cédulas numéricas se guardan
+ * como enteros y solo las demás como texto. Los registros son columnas
+ * de offsets y longitudes: cargar reserva cada columna una vez (no hay
+ * una asignación por registro) y recorrer la base lee memoria seguida.
+ */
+class AlmacenSospechosos {
+public:
+    /**
+     * Lee un CSV con las validaciones de CSVParser (mismos mensajes)
+     * @throws std::runtime_error si el archivo no existe o está mal formado
+     */
+    explicit AlmacenSospechosos(const std::string& rutaCSV);
+
+    size_t size() const { return longitudADN.size(); }
+
+    SospechosoAlmacenado operator[](size_t i) const {
+        return {
+            std::string_view(nombres.data() + inicioNombre[i], inicioNombre[i + 1] - inicioNombre[i]),
+            cedula(i),
+            SecuenciaEmpaquetada::vista(adn.data() + inicioADN[i], longitudADN[i])
+        };
+    }
+
+private:
+    // Una cédula con este bit es el índice de su texto en inicioCedulaTexto
+    static const uint64_t BIT_TEXTO = 1ULL << 63;
+
+    std::string nombres;
+    std::vector<uint64_t> inicioNombre;        // size() + 1 offsets
+
+    std::vector<uint64_t> cedulas;             // Número, o BIT_TEXTO | índice
+    std::string cedulasTexto;
+    std::vector<uint64_t> inicioCedulaTexto;   // Una más que las cédulas de texto
+
+    std::vector<uint64_t> adn;
+    std::vector<uint64_t> inicioADN;           // En palabras
+    std::vector<uint64_t> longitudADN;         // En bases
+
+    TextoCedula cedula(size_t i) const {
+        uint64_t valor = cedulas[i];
+        if ((valor & BIT_TEXTO) == 0) {
+            return TextoCedula::deNumero(valor);
+        }
+        size_t k = valor & ~BIT_TEXTO;
+        return TextoCedula::deTexto(std::string_view(cedulasTexto.data() + inicioCedulaTexto[k],
+                                                     inicioCedulaTexto[k + 1] - inicioCedulaTexto[k]));
+    }
+};
+
+#endif // ALMACEN_SOSPECHOSOS_H
@@ -0,0 +1,41 @@
+#ifndef ARCHIVO_MAPEADO_H
+#define ARCHIVO_MAPEADO_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+/**
+ * Archivo de solo lectura mapeado en memoria (mmap / MapViewOfFile)
+ *
+ * El contenido se lee directamente de la página del sistema operativo,
+ * sin copiarlo a buffers propios. No se puede copiar; sí mover.
+ */
+class ArchivoMapeado {
+public:
+    /**
+     * @throws std::runtime_error si el archivo no existe o no se puede mapear
+     */
+    explicit ArchivoMapeado(const std::string& rutaArchivo);
+    ~ArchivoMapeado();
+
+    ArchivoMapeado(ArchivoMapeado&& otro) noexcept;
+    ArchivoMapeado& operator=(ArchivoMapeado&& otro) noexcept;
+    ArchivoMapeado(const ArchivoMapeado&) = delete;
+    ArchivoMapeado& operator=(const ArchivoMapeado&) = delete;
+
+    std::string_view contenido() const { return std::string_view(datos, tamano); }
+
+private:
+    const char* datos;
+    size_t tamano;
+
+#ifdef _WIN32
+    void* manejadorArchivo;
+    void* manejadorMapeo;
+#endif
+
+    void liberar();
+};
+
+#endif // ARCHIVO_MAPEADO_H
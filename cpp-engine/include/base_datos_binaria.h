@@ -0,0 +1,90 @@
+#ifndef BASE_DATOS_BINARIA_H
+#define BASE_DATOS_BINARIA_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include "csv_parser.h"
+#include "archivo_mapeado.h"
+#include "secuencia_empaquetada.h"
+
+/**
+ * Sospechoso leído de una base .adnb empaquetada (vistas al mapeo)
+ */
+struct SospechosoEmpaquetadoVista {
+    std::string_view nombreCompleto;
+    std::string_view cedula;
+    SecuenciaEmpaquetada cadenaADN;
+};
+
+/**
+ * Base de sospechosos en formato binario .adnb
+ *
+ * Se genera una vez desde el CSV (con todas sus validaciones) y luego se
+ * abre con mmap en tiempo constante: no se parsea ni se valida nada por
+ * registro al buscar.
+ *
+ * Formato (little-endian):
+ *   Cabecera    magia "ADNB", versión, banderas, número de registros y
+ *               offset/tamaño de cada sección
+ *   Índice      una entrada por registro: inicio/longitud de nombre,
+ *               cédula y ADN dentro de su sección
+ *   Nombres     todos los nombres seguidos
+ *   Cédulas     todas las cédulas seguidas
+ *   ADN         texto A/T/C/G seguido, o empaquetado a 2 bits (cada
+ *               registro alineado a 64 bits con una palabra de relleno)
+ */
+class BaseDatosBinaria {
+public:
+    /**
+     * Abre y mapea una base .adnb (solo valida la cabecera)
+     * @throws std::runtime_error si el archivo no existe o no es una base válida
+     */
+    explicit BaseDatosBinaria(const std::string& rutaArchivo);
+
+    BaseDatosBinaria(const BaseDatosBinaria&) = delete;
+    BaseDatosBinaria& operator=(const BaseDatosBinaria&) = delete;
+
+    /**
+     * Construye una base .adnb desde un CSV
+     * @param empaquetar Guarda el ADN a 2 bits por base
+     * @return Número de registros escritos
+     * @throws std::runtime_error si el CSV es inválido o no se puede escribir la salida
+     */
+    static size_t construir(const std::string& rutaCSV, const std::string& rutaSalida, bool empaquetar);
+
+    /**
+     * true si la ruta termina en .adnb
+     */
+    static bool esRutaBinaria(const std::string& ruta);
+
+    size_t size() const { return numRegistros; }
+
+    bool empaquetada() const { return adnEmpaquetado; }
+
+    /**
+     * Registro i de una base con ADN en texto
+     */
+    SospechosoVista registro(size_t i) const;
+
+    /**
+     * Registro i de una base con ADN empaquetado
+     */
+    SospechosoEmpaquetadoVista registroEmpaquetado(size_t i) const;
+
+private:
+    ArchivoMapeado archivo;
+    size_t numRegistros;
+    bool adnEmpaquetado;
+
+    const char* indice;
+    const char* nombres;
+    const char* cedulas;
+    const char* adn;
+    uint64_t tamanoNombres;
+    uint64_t tamanoCedulas;
+    uint64_t tamanoADN;
+};
+
+#endif // BASE_DATOS_BINARIA_H
@@ -0,0 +1,94 @@
+#ifndef BUSQUEDA_APROXIMADA_H
+#define BUSQUEDA_APROXIMADA_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "aho_corasick.h"
+#include "secuencia_empaquetada.h"
+
+/**
+ * Coincidencia aproximada: dónde empieza y cuántos errores tiene
+ */
+struct CoincidenciaAproximada {
+    int posicion;   // -1 si no hay coincidencia
+    int distancia;
+};
+
+/**
+ * Búsqueda de un patrón admitiendo hasta k errores (bases sustituidas y,
+ * con distancia de edición, también insertadas o eliminadas)
+ *
+ * - EDICION: algoritmo bit-paralelo de Myers por bloques de 64 filas
+ *   (variante de Hyyrö) con el corte de Ukkonen: solo se calculan los
+ *   bloques que todavía pueden tener un valor <= k. El inicio de la
+ *   coincidencia se recupera después con una programación dinámica en
+ *   banda de ancho 2k+1 sobre la ventana encontrada.
+ * - HAMMING: principio del palomar. Si el patrón se parte en k+1 semillas,
+ *   toda coincidencia con <= k sustituciones contiene una semilla exacta.
+ *   Las semillas se buscan juntas con Aho-Corasick y cada candidata se
+ *   verifica 32 bases por palabra. Si las semillas quedarían demasiado
+ *   cortas (< LONGITUD_MINIMA_SEMILLA) se verifica cada posición.
+ *
+ * Se construye una vez por patrón y consulta; buscarEn es const y se
+ * puede llamar desde varios hilos a la vez.
+ */
+class BusquedaAproximada {
+public:
+    enum Distancia {
+        EDICION,
+        HAMMING
+    };
+
+    static const size_t LONGITUD_MINIMA_SEMILLA = 12;
+
+    /**
+     * @param patron Patrón de ADN ya validado
+     * @param maxErrores Máximo de errores admitidos (k >= 0)
+     */
+    BusquedaAproximada(const std::string& patron, int maxErrores, Distancia distancia);
+
+    /**
+     * Primera coincidencia con <= k errores
+     *
+     * Con distancia de edición se toma el primer final de coincidencia y se
+     * extiende mientras la distancia siga bajando; el inicio es el más a la
+     * izquierda entre las alineaciones con esa distancia.
+     * @return posicion -1 si no hay ninguna
+     */
+    CoincidenciaAproximada buscarEn(std::string_view texto) const;
+
+    CoincidenciaAproximada buscarEn(const SecuenciaEmpaquetada& texto) const;
+
+    static std::string toString(Distancia distancia);
+
+private:
+    std::string patron;
+    int maxErrores;
+    Distancia distancia;
+
+    // Myers: máscaras de coincidencia peq[codigo * numBloques + bloque]
+    // (el código 4 es una base inválida, sin coincidencias)
+    int numBloques;
+    std::vector<uint64_t> peq;
+
+    // Hamming
+    SecuenciaEmpaquetada patronEmpaquetado;
+    bool usarSemillas;
+    std::vector<size_t> inicioSemillas;
+    AhoCorasick semillas;
+
+    template <typename Cursor, typename Acceso>
+    CoincidenciaAproximada buscarEdicion(Cursor cursor, size_t n, const Acceso& baseEn) const;
+
+    /**
+     * Inicio de la alineación que termina en "fin" con la distancia dada
+     */
+    template <typename Acceso>
+    size_t inicioAlineacion(const Acceso& baseEn, size_t fin, int distancia) const;
+
+    CoincidenciaAproximada buscarHamming(const SecuenciaEmpaquetada& texto) const;
+};
+
+#endif // BUSQUEDA_APROXIMADA_H
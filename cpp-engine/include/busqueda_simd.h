@@ -0,0 +1,55 @@
+#ifndef BUSQUEDA_SIMD_H
+#define BUSQUEDA_SIMD_H
+
+#include <string>
+#include <string_view>
+#include "secuencia_empaquetada.h"
+
+/**
+ * Búsqueda de un patrón con instrucciones vectoriales (AVX2, o SSE2 si no hay)
+ *
+ * Filtro de anclas: se eligen NUM_ANCLAS bases repartidas a lo largo del
+ * patrón y cada una se compara a la vez contra 32 (AVX2) o 16 (SSE2)
+ * posiciones del texto. Solo las posiciones donde coinciden todas las anclas
+ * se verifican completas. Con 4 bases posibles y 8 anclas, en ADN aleatorio
+ * pasa el filtro ~1 de cada 65,536 posiciones.
+ *
+ * El conjunto de instrucciones se detecta en tiempo de ejecución, así que el
+ * mismo binario funciona en CPUs sin AVX2 (y sin SSE2, con un filtro escalar).
+ */
+class BusquedaSIMD {
+public:
+    enum Instrucciones {
+        ESCALAR,
+        SSE2,
+        AVX2
+    };
+
+    static const int NUM_ANCLAS = 8;
+
+    /**
+     * Busca un patrón en un texto
+     * @param texto Cadena de ADN del sospechoso
+     * @param patron Patrón de ADN a buscar
+     * @return Posición de la primera coincidencia (-1 si no existe)
+     */
+    static int buscar(std::string_view texto, std::string_view patron);
+
+    /**
+     * Variante sobre cadenas empaquetadas con el mismo filtro de anclas: la
+     * base de cada ancla, repetida en una palabra, se compara a la vez contra
+     * las 32 posiciones de una ventana de 32 bases del texto (4 ventanas por
+     * instrucción con AVX2, 2 con SSE2 y 1 por operación sin ellas)
+     * @return Posición de la primera coincidencia (-1 si no existe)
+     */
+    static int buscar(const SecuenciaEmpaquetada& texto, const SecuenciaEmpaquetada& patron);
+
+    /**
+     * Mejor conjunto de instrucciones que soporta esta CPU (se detecta una vez)
+     */
+    static Instrucciones instruccionesDisponibles();
+
+    static std::string toString(Instrucciones instrucciones);
+};
+
+#endif // BUSQUEDA_SIMD_H
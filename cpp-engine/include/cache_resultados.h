@@ -0,0 +1,77 @@
+#ifndef CACHE_RESULTADOS_H
+#define CACHE_RESULTADOS_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include "motor_busqueda.h"
+
+/**
+ * Caché de resultados del modo servidor
+ *
+ * La clave es la forma canónica de la consulta: los patrones, el modo de
+ * coincidencia (exacta, o k errores de edición / Hamming; una o ambas
+ * hebras) y la versión de la instantánea de sospechosos. En la búsqueda
+ * exacta los patrones se ordenan, porque el resultado no depende de su
+ * orden salvo por los patron_id, que se reasignan al devolverlo. En la
+ * aproximada el orden desempata entre patrones y forma parte de la clave.
+ *
+ * Se descartan las entradas usadas hace más tiempo (LRU) para no pasar
+ * del presupuesto de memoria. Es segura entre hilos.
+ */
+class CacheResultados {
+public:
+    /**
+     * @param presupuestoBytes Memoria máxima estimada de las entradas (0 = no guarda nada)
+     */
+    explicit CacheResultados(size_t presupuestoBytes);
+
+    /**
+     * Clave canónica de una consulta
+     */
+    static std::string clave(
+        const std::vector<std::string>& patrones,
+        const OpcionesBusqueda& opciones,
+        uint64_t versionBase
+    );
+
+    /**
+     * Busca la consulta y, si está, la marca como la más reciente
+     * @param patrones Patrones en el orden de la consulta (para los patron_id)
+     * @return false si no está en la caché
+     */
+    bool buscar(const std::string& clave, const std::vector<std::string>& patrones, ResultadoBusqueda& resultado);
+
+    /**
+     * Guarda un resultado (si cabe en el presupuesto), descartando los
+     * menos usados
+     */
+    void guardar(const std::string& clave, const std::vector<std::string>& patrones, const ResultadoBusqueda& resultado);
+
+private:
+    // Resultado guardado: las coincidencias sin el texto del patrón, que
+    // se recupera de "patrones" por su patron_id
+    struct Guardado {
+        std::vector<std::string> patrones;
+        ResultadoBusqueda resultado;
+    };
+
+    struct Entrada {
+        std::string clave;
+        std::shared_ptr<const Guardado> guardado;
+        size_t bytes;
+    };
+
+    size_t presupuesto;
+    size_t usados = 0;
+    std::list<Entrada> entradas;  // De la más reciente a la más antigua
+    std::unordered_map<std::string_view, std::list<Entrada>::iterator> porClave;  // Vistas a Entrada::clave
+    mutable std::mutex mutex;
+};
+
+#endif // CACHE_RESULTADOS_H
@@ -2,8 +2,13 @@
 #define CSV_PARSER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <fstream>
+#include <deque>
+#include <functional>
+#include <cstdint>
+#include "secuencia_empaquetada.h"
+#include "archivo_mapeado.h"
 
 /**
  * Estructura que representa un sospechoso
@@ -14,6 +19,26 @@ struct Sospechoso {
     std::string cadenaADN;
 };
 
+/**
+ * Sospechoso con la cadena de ADN empaquetada a 2 bits por base
+ * (4 veces menos memoria que Sospechoso)
+ */
+struct SospechosoEmpaquetado {
+    std::string nombreCompleto;
+    std::string cedula;
+    SecuenciaEmpaquetada cadenaADN;
+};
+
+/**
+ * Sospechoso sin copias: los campos apuntan al archivo mapeado en memoria
+ * (válidos mientras viva el CSVMapeado que los generó)
+ */
+struct SospechosoVista {
+    std::string_view nombreCompleto;
+    std::string_view cedula;
+    std::string_view cadenaADN;
+};
+
 /**
  * Parser de archivos CSV con datos de sospechosos
  * Formato esperado: nombre_completo,cedula,cadena_adn
@@ -28,25 +53,192 @@ public:
      */
     static std::vector<Sospechoso> parsear(const std::string& rutaArchivo);
 
+    /**
+     * Igual que parsear, pero empaqueta cada cadena apenas se lee
+     * (nunca se tienen todas las cadenas en texto a la vez)
+     * @throws std::runtime_error si el archivo no existe o está mal formado
+     */
+    static std::vector<SospechosoEmpaquetado> parsearEmpaquetado(const std::string& rutaArchivo);
+
+    /**
+     * Parsea y valida un único registro "nombre,cedula,adn" (mismas reglas
+     * que una línea del archivo) y empaqueta su cadena
+     * @throws std::runtime_error si el registro es inválido
+     */
+    static SospechosoEmpaquetado parsearRegistro(std::string_view linea);
+
     /**
      * Valida que una cadena de ADN solo contenga A, T, C, G
      * @param cadenaADN Cadena a validar
      * @return true si es válida, false en caso contrario
      */
-    static bool validarCadenaADN(const std::string& cadenaADN);
+    static bool validarCadenaADN(std::string_view cadenaADN);
+
+    /**
+     * Recorre el contenido del CSV, valida cada registro y lo entrega a
+     * "alLeer" como vistas al contenido (sin copias), en el orden del archivo
+     * @param camposReescritos Guarda los campos que tenían comillas
+     *        (hay que quitarlas, así que no pueden ser vistas directas)
+     * @throws std::runtime_error si está mal formado o no tiene registros
+     */
+    static void leerRegistros(
+        std::string_view contenido,
+        std::deque<std::string>& camposReescritos,
+        const std::function<void(const SospechosoVista& sospechoso)>& alLeer
+    );
+
+    /**
+     * Igual que leerRegistros, sobre un tramo de líneas completas de un
+     * archivo (el encabezado solo se reconoce en la primera línea del
+     * archivo). Un tramo sin registros no es un error.
+     * @param lineasAnteriores Líneas del archivo antes del tramo (para
+     *        numerar las de los mensajes de error)
+     * @return Registros entregados
+     * @throws std::runtime_error con la línea en el archivo del primer registro inválido
+     */
+    static size_t leerTramo(
+        std::string_view tramo,
+        int lineasAnteriores,
+        std::deque<std::string>& camposReescritos,
+        const std::function<void(const SospechosoVista& sospechoso)>& alLeer
+    );
 
 private:
     /**
-     * Divide una línea CSV en campos
-     * @param linea Línea a dividir
-     * @return Vector con los campos separados
+     * Divide una línea CSV en campos (ya sin espacios al inicio y final)
+     * @param campos Recibe los 3 primeros campos
+     * @return Número total de campos de la línea
+     */
+    static size_t dividirLinea(
+        std::string_view linea,
+        std::string_view campos[3],
+        std::deque<std::string>& camposReescritos
+    );
+
+    /**
+     * Parte el contenido en bloques de líneas completas que se parsean y
+     * validan en paralelo; los registros se entregan en el orden del archivo
+     * @param lineasAnteriores Líneas del archivo antes del contenido (0 si
+     *        es el principio, donde puede estar el encabezado)
+     * @param validarADN false si "preparar" valida la cadena (por ejemplo,
+     *        al empaquetarla en la misma pasada)
+     * @param preparar (vista, camposConComillas, registro) → false si el
+     *        registro es inválido; corre en el hilo del bloque. Si la línea
+     *        tenía comillas, sus campos están en camposConComillas (se
+     *        pueden mover) y solo valen durante la llamada
+     * @param entregar Recibe cada registro, en el hilo que llama
+     * @return Registros entregados
+     * @throws std::runtime_error con la línea del primer registro inválido
+     *         del archivo (el mismo mensaje que daría una lectura secuencial)
+     */
+    template <typename Registro, typename Preparar, typename Entregar>
+    static size_t leerEnParalelo(
+        std::string_view contenido,
+        int lineasAnteriores,
+        bool validarADN,
+        Preparar preparar,
+        Entregar entregar
+    );
+
+    /**
+     * Valida los campos de un registro
+     * @param numeroLinea Línea del archivo para los mensajes (0 = registro suelto)
+     * @param validarADN false si quien llama valida la cadena por su cuenta
+     * @throws std::runtime_error si el registro es inválido
      */
-    static std::vector<std::string> dividirLinea(const std::string& linea);
+    static SospechosoVista validarRegistro(
+        const std::string_view campos[3],
+        size_t numCampos,
+        int numeroLinea,
+        bool validarADN = true
+    );
 
     /**
      * Elimina espacios en blanco al inicio y final
      */
-    static std::string trim(const std::string& str);
+    static std::string_view trim(std::string_view str);
+};
+
+/**
+ * Archivo CSV mapeado en memoria con sus registros ya validados
+ *
+ * Ni el contenido ni los campos se copian: cada SospechosoVista apunta
+ * al mapeo. No se puede copiar ni mover (las vistas quedarían colgando).
+ */
+class CSVMapeado {
+public:
+    /**
+     * @throws std::runtime_error si el archivo no existe o está mal formado
+     */
+    explicit CSVMapeado(const std::string& rutaArchivo);
+
+    CSVMapeado(const CSVMapeado&) = delete;
+    CSVMapeado& operator=(const CSVMapeado&) = delete;
+
+    const std::vector<SospechosoVista>& sospechosos() const { return registros; }
+
+private:
+    ArchivoMapeado archivo;
+    std::deque<std::string> camposReescritos;
+    std::vector<SospechosoVista> registros;
+};
+
+/**
+ * Archivo CSV leído de a lotes de líneas completas (--max-memory)
+ *
+ * El archivo nunca está entero en memoria: se lee con un buffer de tamaño
+ * fijo. Al crearlo se recorre una vez para validarlo (mismos mensajes que
+ * CSVMapeado, con la línea en el archivo) y contar registros y bases;
+ * recorrer() lo vuelve a leer y entrega cada lote como vistas al buffer.
+ */
+class CSVPorLotes {
+public:
+    // Un lote nunca es más chico (y crece si una sola línea no entra)
+    static constexpr size_t BYTES_MINIMOS_POR_LOTE = 1 << 16;
+
+    /**
+     * @param presupuestoBytes Memoria para el lote en curso: el buffer, las
+     *        vistas a sus registros y los campos reescritos
+     * @throws std::runtime_error si el archivo no existe o está mal formado
+     */
+    CSVPorLotes(const std::string& rutaArchivo, size_t presupuestoBytes);
+
+    size_t size() const { return numRegistros; }
+
+    uint64_t totalBases() const { return bases; }
+
+    /**
+     * Bases de las cadenas de al menos esa longitud (las que un patrón de
+     * esa longitud tiene que recorrer)
+     */
+    uint64_t basesDesde(size_t longitudMinima) const;
+
+    /**
+     * Vuelve a leer el archivo y entrega sus registros de a lotes, en orden
+     * @param alLote (registros, índice en el archivo del primero); las
+     *        vistas solo valen durante la llamada
+     * @throws std::runtime_error si el archivo ya no se puede leer o si
+     *         cambió su cantidad de registros o de bases desde la primera
+     *         pasada (un lote de más nunca llega a alLote)
+     */
+    void recorrer(const std::function<void(const std::vector<SospechosoVista>& lote, size_t primero)>& alLote) const;
+
+private:
+    std::string ruta;
+    size_t bytesPorLote;
+    size_t numRegistros = 0;
+    uint64_t bases = 0;
+    // Bases de las cadenas cortas, por longitud (los patrones miden
+    // menos de LONGITUDES_CORTAS bases, las más largas no hace falta distinguirlas)
+    static constexpr size_t LONGITUDES_CORTAS = 1024;
+    std::vector<uint64_t> basesPorLongitud;
+
+    /**
+     * Lee el archivo en tramos de líneas completas de hasta bytesPorLote
+     * (más si una línea es más larga)
+     * @param alTramo (tramo, líneas del archivo antes del tramo)
+     */
+    void leerTramos(const std::function<void(std::string_view tramo, int lineasAnteriores)>& alTramo) const;
 };
 
 #endif // CSV_PARSER_H
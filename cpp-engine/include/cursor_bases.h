@@ -0,0 +1,71 @@
+#ifndef CURSOR_BASES_H
+#define CURSOR_BASES_H
+
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include "secuencia_empaquetada.h"
+
+/**
+ * Recorrido base a base de una cadena de ADN, en texto o empaquetada,
+ * entregando el código de cada base (mismo código que SecuenciaEmpaquetada:
+ * A=0, T=1, C=2, G=3). Permite escribir un solo recorrido como plantilla
+ * para ambas representaciones.
+ */
+
+/**
+ * Tabla de códigos por carácter (-1 si no es una base válida): una
+ * lectura en lugar de un switch, que con ADN al azar no se puede predecir
+ */
+struct TablaCodigosBase {
+    signed char codigos[256];
+
+    constexpr TablaCodigosBase() : codigos() {
+        for (int i = 0; i < 256; i++) codigos[i] = -1;
+        codigos[static_cast<unsigned char>('A')] = 0;
+        codigos[static_cast<unsigned char>('T')] = 1;
+        codigos[static_cast<unsigned char>('C')] = 2;
+        codigos[static_cast<unsigned char>('G')] = 3;
+    }
+};
+
+inline constexpr TablaCodigosBase TABLA_CODIGOS_BASE{};
+
+/**
+ * Código de un nucleótido, -1 si no es una base válida
+ */
+inline int codigoBase(char c) {
+    return TABLA_CODIGOS_BASE.codigos[static_cast<unsigned char>(c)];
+}
+
+/**
+ * Entrega los códigos de una cadena de texto
+ */
+struct CursorTexto {
+    const char* actual;
+
+    int siguiente() {
+        return codigoBase(*actual++);
+    }
+};
+
+/**
+ * Entrega los códigos de una cadena empaquetada (una lectura cada 32 bases)
+ */
+struct CursorEmpaquetado {
+    const SecuenciaEmpaquetada& texto;
+    size_t posicion;
+    uint64_t palabra;
+
+    int siguiente() {
+        if ((posicion & 31) == 0) {
+            palabra = texto.ventana(posicion);
+        }
+        posicion++;
+        int codigo = palabra & 3;
+        palabra >>= 2;
+        return codigo;
+    }
+};
+
+#endif // CURSOR_BASES_H
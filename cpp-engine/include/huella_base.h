@@ -0,0 +1,106 @@
+#ifndef HUELLA_BASE_H
+#define HUELLA_BASE_H
+
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include "cursor_bases.h"
+#include "secuencia_empaquetada.h"
+
+/**
+ * Huella del contenido de una base de sospechosos: número de registros,
+ * de bases y un hash de 64 bits de las cadenas, en orden
+ *
+ * Los índices (.fm, .adnk) la guardan al construirse para reconocer una
+ * base que cambió aunque conserve la cantidad de registros y de bases.
+ * El hash se calcula sobre los códigos de cada base (ver cursor_bases.h),
+ * así una cadena da la misma huella en texto o empaquetada.
+ */
+class HuellaBase {
+public:
+    /**
+     * Agrega la siguiente cadena de la base, en texto
+     */
+    void agregar(std::string_view cadena) {
+        // Se arma la misma palabra de 32 bases que guarda SecuenciaEmpaquetada
+        uint64_t palabra = 0;
+        for (size_t i = 0; i < cadena.length(); i++) {
+            int codigo = codigoBase(cadena[i]);
+            if (codigo < 0) {
+                // No debería pasar en una base validada, pero no debe pasar inadvertido
+                mezclar(~static_cast<uint64_t>(i));
+                codigo = 0;
+            }
+            palabra |= static_cast<uint64_t>(codigo) << (2 * (i & 31));
+            if ((i & 31) == 31) {
+                mezclar(palabra);
+                palabra = 0;
+            }
+        }
+        if (cadena.length() & 31) {
+            mezclar(palabra);
+        }
+        cerrarCadena(cadena.length());
+    }
+
+    /**
+     * Agrega la siguiente cadena de la base, empaquetada (una palabra cada 32 bases)
+     */
+    void agregar(const SecuenciaEmpaquetada& cadena) {
+        size_t n = cadena.longitud();
+        for (size_t i = 0; i < n; i += 32) {
+            uint64_t palabra = cadena.ventana(i);
+            if (n - i < 32) {
+                palabra &= (1ULL << (2 * (n - i))) - 1;
+            }
+            mezclar(palabra);
+        }
+        cerrarCadena(n);
+    }
+
+    uint64_t registros() const { return numRegistros; }
+    uint64_t bases() const { return numBases; }
+    uint64_t hash() const { return estado; }
+
+    bool operator==(const HuellaBase& otra) const {
+        return numRegistros == otra.numRegistros && numBases == otra.numBases && estado == otra.estado;
+    }
+
+    /**
+     * Huella ya guardada (la cabecera de un índice)
+     */
+    static HuellaBase guardada(uint64_t numRegistros, uint64_t numBases, uint64_t hash) {
+        HuellaBase huella;
+        huella.numRegistros = numRegistros;
+        huella.numBases = numBases;
+        huella.estado = hash;
+        return huella;
+    }
+
+private:
+    uint64_t numRegistros = 0;
+    uint64_t numBases = 0;
+    uint64_t estado = 0xcbf29ce484222325ULL;
+
+    /**
+     * Cada palabra pasa por el finalizador de splitmix64 antes de entrar
+     * al estado, que depende del orden (multiplicar por un impar es biyectivo)
+     */
+    void mezclar(uint64_t palabra) {
+        palabra += 0x9e3779b97f4a7c15ULL;
+        palabra = (palabra ^ (palabra >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        palabra = (palabra ^ (palabra >> 27)) * 0x94d049bb133111ebULL;
+        palabra ^= palabra >> 31;
+        estado = (estado ^ palabra) * 0x100000001b3ULL;
+        estado ^= estado >> 29;
+    }
+
+    // La longitud separa las cadenas: "AT" + "" no es "A" + "T"
+    void cerrarCadena(size_t longitud) {
+        mezclar(static_cast<uint64_t>(longitud) | (1ULL << 63));
+        numRegistros++;
+        numBases += longitud;
+    }
+};
+
+#endif // HUELLA_BASE_H
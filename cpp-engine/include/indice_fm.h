@@ -0,0 +1,109 @@
+#ifndef INDICE_FM_H
+#define INDICE_FM_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "archivo_mapeado.h"
+#include "huella_base.h"
+
+/**
+ * Aparición de un patrón: sospechoso (fila de la base) y posición en su ADN
+ */
+struct OcurrenciaFM {
+    uint32_t fila;
+    uint32_t posicion;
+};
+
+/**
+ * Índice FM sobre todas las cadenas de ADN de la base (.fm)
+ *
+ * El texto es la concatenación de todas las cadenas, cada una seguida de un
+ * separador, y un terminador final. Su arreglo de sufijos se construye con
+ * SA-IS (tiempo lineal) y se guarda:
+ *   - la BWT en bloques de 64 filas: dos planos de bits con el código de
+ *     cada base (A=0, T=1, C=2, G=3), una máscara de separadores y el
+ *     número de cada base antes del bloque (rank en O(1))
+ *   - el arreglo de sufijos muestreado: las filas cuya posición es
+ *     múltiplo de PASO_MUESTREO o que empiezan una cadena
+ *   - el inicio de cada cadena en el texto, para pasar de una posición
+ *     global al sospechoso y la posición dentro de su ADN
+ *
+ * Contar las apariciones de un patrón cuesta O(m) y ubicar cada una como
+ * mucho PASO_MUESTREO pasos más, sin importar el tamaño de la base.
+ * Se construye una vez (busqueda_adn --build-fm) y se abre con mmap. La
+ * cabecera guarda la huella de la base (HuellaBase) para no usarlo si la
+ * base cambió después.
+ */
+class IndiceFM {
+public:
+    static const uint32_t PASO_MUESTREO = 16;
+
+    /**
+     * Abre y mapea un índice .fm (solo valida la cabecera)
+     * @throws std::runtime_error si el archivo no existe o no es un índice válido
+     */
+    explicit IndiceFM(const std::string& rutaArchivo);
+
+    IndiceFM(const IndiceFM&) = delete;
+    IndiceFM& operator=(const IndiceFM&) = delete;
+
+    /**
+     * Construye el índice FM de una base (.csv o .adnb)
+     * @return Número de registros indexados
+     * @throws std::runtime_error si la base es inválida o no se puede escribir la salida
+     */
+    static size_t construir(const std::string& rutaBase, const std::string& rutaSalida);
+
+    /**
+     * Ruta donde se busca el índice de una base: la misma ruta terminada en .fm
+     */
+    static std::string rutaPara(const std::string& rutaBase);
+
+    /**
+     * true si el índice se construyó sobre una base con esa huella (mismas
+     * cadenas en el mismo orden). Un índice de la versión 1, sin huella,
+     * nunca corresponde: hay que reconstruirlo
+     */
+    bool corresponde(const HuellaBase& base) const;
+
+    /**
+     * Número de apariciones del patrón en toda la base
+     */
+    size_t contar(std::string_view patron) const;
+
+    /**
+     * Todas las apariciones del patrón (en el orden del arreglo de sufijos)
+     */
+    std::vector<OcurrenciaFM> localizar(std::string_view patron) const;
+
+private:
+    ArchivoMapeado archivo;
+    uint64_t numRegistros;
+    HuellaBase huella;
+    bool tieneHuella;
+    uint64_t longitudTexto;
+    uint64_t anteriores[4];     // Filas que empiezan con un símbolo menor que cada base
+    const void* bloques;
+    const uint32_t* muestras;
+    const uint64_t* inicios;
+
+    /**
+     * Rango [desde, hasta) de filas cuyos sufijos empiezan con el patrón
+     */
+    void rango(std::string_view patron, uint64_t& desde, uint64_t& hasta) const;
+
+    /**
+     * Veces que aparece la base en la BWT antes de la fila
+     */
+    uint64_t rank(int codigo, uint64_t fila) const;
+
+    /**
+     * Posición en el texto del sufijo de la fila
+     */
+    uint64_t posicionDe(uint64_t fila) const;
+};
+
+#endif // INDICE_FM_H
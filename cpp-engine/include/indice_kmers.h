@@ -0,0 +1,106 @@
+#ifndef INDICE_KMERS_H
+#define INDICE_KMERS_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "archivo_mapeado.h"
+#include "huella_base.h"
+
+/**
+ * Índice invertido de k-mers (k = 12) sobre una base de sospechosos (.adnk)
+ *
+ * Para cada k-mer guarda en qué sospechosos y en qué posiciones aparece
+ * (solo las posiciones múltiplo de PASO, para que el índice ocupe menos).
+ * Una coincidencia exacta de un patrón de >= 100 bases contiene todos sus
+ * k-mers, así que solo hace falta revisar los sospechosos donde los k-mers
+ * más raros del patrón aparecen a la distancia correcta entre sí.
+ *
+ * Formato (little-endian):
+ *   Cabecera    magia "ADNK", versión, k, paso, número de registros y
+ *               bases de la base indexada, offset/tamaño de cada sección
+ *               y hash de sus cadenas (HuellaBase)
+ *   Directorio  2^16 + 1 offsets: dónde empieza cada cubeta de k-mers con
+ *               el mismo prefijo de 8 bases (código a 2 bits por base,
+ *               el de SecuenciaEmpaquetada)
+ *   Listas      por cada k-mer presente, en orden: sus últimas 4 bases
+ *               (1 byte), apariciones, bytes de la lista y la lista. Por
+ *               aparición, en orden (sospechoso, posición): diferencia de
+ *               sospechoso con la anterior y la posición (diferencia con la
+ *               anterior si es el mismo sospechoso), en varint de 7 bits
+ *
+ * Se genera una vez desde el CSV o la base .adnb y se abre con mmap.
+ */
+class IndiceKmers {
+public:
+    static const int K = 12;
+    static const int PASO = 4;
+
+    // Cuántos k-mers del patrón (sin solaparse) deben estar a la distancia correcta
+    static const int KMERS_POR_PATRON = 3;
+
+    /**
+     * Abre y mapea un índice .adnk (solo valida la cabecera)
+     * @throws std::runtime_error si el archivo no existe o no es un índice válido
+     */
+    explicit IndiceKmers(const std::string& rutaArchivo);
+
+    IndiceKmers(const IndiceKmers&) = delete;
+    IndiceKmers& operator=(const IndiceKmers&) = delete;
+
+    /**
+     * Construye el índice de una base (.csv o .adnb)
+     * @return Número de k-mers distintos
+     * @throws std::runtime_error si la base es inválida o no se puede escribir la salida
+     */
+    static size_t construir(const std::string& rutaBase, const std::string& rutaSalida);
+
+    /**
+     * true si el índice se construyó sobre una base con esa huella (mismas
+     * cadenas en el mismo orden). Un índice de la versión 1, sin huella,
+     * nunca corresponde: hay que reconstruirlo
+     */
+    bool corresponde(const HuellaBase& base) const;
+
+    /**
+     * Sospechosos que pueden contener algún patrón de forma exacta
+     * @param filas Recibe los índices de esos sospechosos, ordenados
+     * @return false si las listas no son lo bastante selectivas y conviene
+     *         recorrer toda la base (filas queda sin usar)
+     */
+    bool planificar(const std::vector<std::string>& patrones, std::vector<size_t>& filas) const;
+
+    /**
+     * Número de k-mers distintos indexados
+     */
+    size_t numKmers() const { return numEntradas; }
+
+private:
+    ArchivoMapeado archivo;
+    uint64_t numRegistros;
+    HuellaBase huella;
+    bool tieneHuella;
+    size_t numEntradas;
+    const char* directorio;
+    const char* listas;
+    uint64_t tamanoListas;
+
+    /**
+     * Apariciones del k-mer (0 si no aparece)
+     * @param inicioLista Recibe el offset de su lista
+     */
+    uint32_t frecuencia(uint32_t kmer, uint64_t& inicioLista) const;
+
+    /**
+     * Decodifica una lista como inicios de alineación (sospechoso,
+     * posición - desplazamiento), descartando los negativos
+     */
+    std::vector<std::pair<uint32_t, uint32_t>> alineaciones(
+        uint64_t inicioLista,
+        uint32_t apariciones,
+        uint32_t desplazamiento
+    ) const;
+};
+
+#endif // INDICE_KMERS_H
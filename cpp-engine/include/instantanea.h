@@ -0,0 +1,89 @@
+#ifndef INSTANTANEA_H
+#define INSTANTANEA_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "csv_parser.h"
+#include "base_datos_binaria.h"
+
+/**
+ * Instantánea inmutable de los sospechosos del modo servidor
+ *
+ * Los registros se reparten en segmentos de hasta TAMANO_SEGMENTO que
+ * varias instantáneas comparten por conteo de referencias. Agregar o
+ * quitar sospechosos no modifica la instantánea: crea una nueva que solo
+ * copia los segmentos afectados (y la lista de segmentos). Quien busca
+ * sobre una instantánea la sigue viendo igual, sin locks, mientras
+ * conserve su referencia; la memoria se libera al soltar la última.
+ *
+ * Se puede usar como colección en MotorBusqueda::ejecutar.
+ */
+class Instantanea {
+public:
+    static const size_t TAMANO_SEGMENTO = 1024;
+
+    /**
+     * Sospechoso de un segmento: la vista que se busca y el dueño de los
+     * datos a los que apunta (el registro empaquetado o la base mapeada)
+     */
+    struct Registro {
+        SospechosoEmpaquetadoVista vista;
+        std::shared_ptr<const void> dueno;
+    };
+
+    /**
+     * Lee un CSV o una base .adnb (una .adnb empaquetada se usa desde el
+     * mapeo; las de texto se empaquetan al cargar)
+     * @param version Versión de la instantánea (ver version())
+     * @throws std::runtime_error si el archivo no se puede leer
+     */
+    static std::shared_ptr<const Instantanea> cargar(const std::string& ruta, uint64_t version = 1);
+
+    /**
+     * Registro dueño de su sospechoso (para agregar)
+     */
+    static Registro crearRegistro(SospechosoEmpaquetado sospechoso);
+
+    /**
+     * Nueva instantánea con los registros al final (version() + 1)
+     */
+    std::shared_ptr<const Instantanea> agregar(const std::vector<Registro>& registros) const;
+
+    /**
+     * Nueva instantánea sin los registros de esa cédula (version() + 1)
+     * @param quitados Recibe los registros quitados, en orden
+     * @return nullptr si ningún registro tiene esa cédula
+     */
+    std::shared_ptr<const Instantanea> quitar(std::string_view cedula, std::vector<Registro>& quitados) const;
+
+    size_t size() const { return total; }
+
+    /**
+     * Registro i (búsqueda binaria del segmento)
+     */
+    const SospechosoEmpaquetadoVista& operator[](size_t i) const;
+
+    /**
+     * Crece con cada cambio: dos instantáneas con la misma versión tienen
+     * los mismos sospechosos
+     */
+    uint64_t version() const { return numeroVersion; }
+
+private:
+    using Segmento = std::vector<Registro>;
+
+    std::vector<std::shared_ptr<const Segmento>> segmentos;  // Nunca vacíos
+    std::vector<size_t> inicios;                             // Primer índice de cada segmento
+    size_t total = 0;
+    uint64_t numeroVersion = 1;
+
+    /**
+     * Recalcula inicios y total desde los segmentos
+     */
+    void indexar();
+};
+
+#endif // INSTANTANEA_H
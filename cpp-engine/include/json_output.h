@@ -3,6 +3,7 @@
 
 #include <string>
 #include <vector>
+#include "metricas.h"
 
 /**
  * Estructura para una coincidencia encontrada
@@ -13,6 +14,8 @@ struct Coincidencia {
     int patronId;          // ID del patrón que coincidió (para múltiples patrones)
     std::string patron;    // El patrón específico que coincidió
     int posicion;
+    int distancia = 0;     // Errores de la coincidencia (0 = exacta, ver --max-errors)
+    char hebra = '+';      // '-' si coincidió el complemento inverso (ver --both-strands)
 };
 
 /**
@@ -23,6 +26,9 @@ class JSONOutput {
 public:
     /**
      * Genera JSON de éxito con coincidencias (múltiples patrones)
+     * @param cacheHit true si el resultado salió de la caché del modo servidor
+     * @param metricas Si no es nullptr, se agrega la sección "metricas" (con
+     *        el tiempo de esta serialización sumado a serializacionNs)
      */
     static std::string generarExito(
         const std::vector<std::string>& patrones,
@@ -30,9 +36,79 @@ public:
         const std::string& criterioSeleccion,
         int totalProcesados,
         const std::vector<Coincidencia>& coincidencias,
+        long tiempoEjecucionMs,
+        bool cacheHit = false,
+        const Metricas* metricas = nullptr
+    );
+
+    /**
+     * Genera JSON de éxito para --build-db
+     */
+    static std::string generarBaseConstruida(
+        const std::string& rutaSalida,
+        size_t totalRegistros,
+        bool empaquetada,
+        long tiempoEjecucionMs
+    );
+
+    /**
+     * Genera JSON de éxito para --build-index
+     */
+    static std::string generarIndiceConstruido(
+        const std::string& rutaSalida,
+        size_t numKmers,
+        long tiempoEjecucionMs
+    );
+
+    /**
+     * Genera JSON de éxito para --build-fm
+     */
+    static std::string generarIndiceFMConstruido(
+        const std::string& rutaSalida,
+        size_t totalRegistros,
+        long tiempoEjecucionMs
+    );
+
+    /**
+     * Genera JSON de éxito para --calibrate
+     */
+    static std::string generarPerfilCalibrado(
+        const std::string& rutaSalida,
         long tiempoEjecucionMs
     );
 
+    /**
+     * Línea de --batch para una consulta resuelta: los campos de
+     * generarExito más su "id", en una sola línea (NDJSON)
+     * @param tiempoEjecucionMs Tiempo del lote completo (la pasada es compartida)
+     */
+    static std::string generarResultadoLote(
+        const std::string& id,
+        const std::vector<std::string>& patrones,
+        const std::string& algoritmoUsado,
+        const std::string& criterioSeleccion,
+        int totalProcesados,
+        const std::vector<Coincidencia>& coincidencias,
+        long tiempoEjecucionMs
+    );
+
+    /**
+     * Línea de --batch para una consulta que no se pudo resolver: los
+     * campos de generarError más su "id"
+     */
+    static std::string generarErrorLote(
+        const std::string& id,
+        const std::string& mensajeError,
+        const std::string& codigoError,
+        const std::string& detalles
+    );
+
+    /**
+     * Objeto "metricas" en una sola línea:
+     * {"tiempos_ns":{"parseo_argumentos":..,...},"bases_recorridas":..,...}
+     */
+    static std::string generarMetricas(const Metricas& metricas);
+
     /**
      * Genera JSON de error
      */
@@ -2,7 +2,9 @@
 #define KMP_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include "secuencia_empaquetada.h"
 
 /**
  * Algoritmo Knuth-Morris-Pratt para búsqueda de patrones
@@ -17,7 +19,15 @@ public:
      * @param patron Patrón de ADN a buscar
      * @return Posición de la primera coincidencia (-1 si no existe)
      */
-    static int buscar(const std::string& texto, const std::string& patron);
+    static int buscar(std::string_view texto, std::string_view patron);
+
+    /**
+     * Variante sobre cadenas empaquetadas a 2 bits: recorre el autómata KMP
+     * (la función de fallo resuelta por adelantado para las 4 bases) con
+     * los códigos sacados de cada palabra, una transición por base
+     * @return Posición de la primera coincidencia (-1 si no existe)
+     */
+    static int buscar(const SecuenciaEmpaquetada& texto, const SecuenciaEmpaquetada& patron);
 
 private:
     /**
@@ -25,7 +35,13 @@ private:
      * @param patron Patrón a analizar
      * @return Vector con la tabla LPS
      */
-    static std::vector<int> construirTablaLPS(const std::string& patron);
+    static std::vector<int> construirTablaLPS(std::string_view patron);
+
+    /**
+     * Autómata del patrón: automata[estado * 4 + código] es el siguiente
+     * estado (bases del patrón que coinciden) tras leer esa base
+     */
+    static std::vector<int> construirAutomata(const SecuenciaEmpaquetada& patron);
 };
 
 #endif // KMP_H
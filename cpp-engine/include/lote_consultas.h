@@ -0,0 +1,42 @@
+#ifndef LOTE_CONSULTAS_H
+#define LOTE_CONSULTAS_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Consulta de un lote (--batch)
+ */
+struct ConsultaLote {
+    std::string id;
+    std::vector<std::string> patrones;
+    std::string error;   // Vacío si la línea se pudo leer
+};
+
+/**
+ * Lector del archivo de consultas de --batch (JSON Lines)
+ *
+ * Cada línea no vacía es un objeto:
+ *   {"id": "caso-17", "patrones": ["ATCG...", "GGCC..."]}
+ * "patrones" también acepta una cadena "patron1,patron2,..." como la
+ * línea de comandos e "id" un número. Sin "id" se usa el número de línea.
+ * Las demás claves se ignoran.
+ */
+class LoteConsultas {
+public:
+    /**
+     * Lee todas las consultas. Una línea que no se puede interpretar no
+     * detiene el lote: su consulta queda con el error
+     * @throws std::runtime_error si el archivo no se puede leer o no tiene consultas
+     */
+    static std::vector<ConsultaLote> leer(const std::string& rutaArchivo);
+
+    /**
+     * Interpreta una línea
+     * @throws std::runtime_error si no es un objeto JSON con "patrones"
+     */
+    static ConsultaLote interpretarLinea(std::string_view linea, int numeroLinea);
+};
+
+#endif // LOTE_CONSULTAS_H
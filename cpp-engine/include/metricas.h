@@ -0,0 +1,62 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Tiempos por fase y contadores de una búsqueda (sección "metricas" del JSON)
+ *
+ * Los tiempos son en nanosegundos. El motor suma en lugar de asignar, así
+ * los tramos de --stream y las consultas de un mismo proceso se acumulan.
+ */
+struct Metricas {
+    // Tiempos por fase (ns)
+    uint64_t parseoArgumentosNs = 0;   // Argumentos o línea del servidor y división de patrones
+    uint64_t ingestaNs = 0;            // Carga del CSV o la base y de los índices
+    uint64_t validacionNs = 0;         // Patrones y opciones
+    uint64_t construccionNs = 0;       // Selección del algoritmo y autómata / tablas de hash
+    uint64_t recorridoNs = 0;          // Búsqueda en los sospechosos y armado del resultado
+    uint64_t serializacionNs = 0;      // JSON de la respuesta
+
+    // Contadores
+    uint64_t basesRecorridas = 0;      // Largo total de las cadenas revisadas
+    uint64_t sospechososOmitidos = 0;  // Descartados sin revisar por un índice (k-mers o FM)
+    uint64_t estadosAutomata = 0;      // Estados de Aho-Corasick (0 si no se usó)
+    uint64_t saltosEnlaceFallo = 0;    // Enlaces de salida seguidos al reportar (Aho-Corasick)
+    uint64_t colisionesHash = 0;       // Hashes iguales con texto distinto (Rabin-Karp)
+    uint64_t picoMemoriaBytes = 0;     // RSS máximo del proceso
+
+    /**
+     * RSS máximo del proceso hasta ahora, en bytes (0 si no se puede leer)
+     */
+    static uint64_t leerPicoMemoria();
+};
+
+/**
+ * Mide nanosegundos desde su creación o el último reiniciar()
+ */
+class Cronometro {
+public:
+    Cronometro() : inicio(std::chrono::steady_clock::now()) {}
+
+    uint64_t nanosegundos() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    /**
+     * @return Los nanosegundos hasta ahora; vuelve a empezar desde cero
+     */
+    uint64_t reiniciar() {
+        auto ahora = std::chrono::steady_clock::now();
+        uint64_t transcurridos = std::chrono::duration_cast<std::chrono::nanoseconds>(ahora - inicio).count();
+        inicio = ahora;
+        return transcurridos;
+    }
+
+private:
+    std::chrono::steady_clock::time_point inicio;
+};
+
+#endif // METRICAS_H
@@ -0,0 +1,257 @@
+#ifndef MOTOR_BUSQUEDA_H
+#define MOTOR_BUSQUEDA_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <stdexcept>
+#include "csv_parser.h"
+#include "json_output.h"
+#include "busqueda_aproximada.h"
+#include "metricas.h"
+
+class BaseDatosBinaria;
+class AlmacenSospechosos;
+class Instantanea;
+class IndiceFM;
+class PerfilCostos;
+
+/**
+ * Error de búsqueda con el código y detalle que se reportan en el JSON
+ * (ver JSONOutput::generarError)
+ */
+class ErrorBusqueda : public std::runtime_error {
+public:
+    ErrorBusqueda(const std::string& mensaje, const std::string& codigo, const std::string& detalles)
+        : std::runtime_error(mensaje), codigo(codigo), detalles(detalles) {}
+
+    std::string codigo;
+    std::string detalles;
+};
+
+/**
+ * Resultado de una búsqueda, listo para JSONOutput::generarExito
+ */
+struct ResultadoBusqueda {
+    std::string algoritmo;
+    std::string criterio;
+    int totalProcesados;
+    std::vector<Coincidencia> coincidencias;
+};
+
+/**
+ * Coincidencia entregada en streaming: el patrón va por su índice y
+ * nombre y cédula son vistas al sospechoso (válidas solo durante la llamada)
+ */
+struct CoincidenciaVista {
+    std::string_view nombre;
+    std::string_view cedula;
+    int patronId;
+    int posicion;
+    int distancia;
+    char hebra;
+};
+
+/**
+ * Destino de los resultados en streaming (ver SalidaNDJSON). Las
+ * coincidencias llegan en el mismo orden y con los mismos duplicados
+ * descartados que en ResultadoBusqueda::coincidencias.
+ */
+class ReceptorResultados {
+public:
+    virtual ~ReceptorResultados() = default;
+
+    /**
+     * Algoritmo, criterio y total de sospechosos, antes de la primera coincidencia
+     */
+    virtual void encabezado(const std::vector<std::string>& patrones, const ResultadoBusqueda& resultado) = 0;
+
+    virtual void coincidencia(const CoincidenciaVista& coincidencia) = 0;
+};
+
+/**
+ * Opciones de una búsqueda
+ */
+struct OpcionesBusqueda {
+    int numHilos = 1;       // El resultado es idéntico para cualquier número de hilos
+    int maxErrores = -1;    // -1 = solo coincidencias exactas (--max-errors k)
+    BusquedaAproximada::Distancia distancia = BusquedaAproximada::EDICION;
+
+    // Con varios hilos, las cadenas de al menos estas bases se recorren
+    // en tramos repartidos entre todos (--split-threshold). 0 = nunca
+    size_t umbralDivision = 1 << 20;
+
+    // Busca también el complemento inverso de cada patrón (--both-strands),
+    // en la misma pasada: cada coincidencia indica su hebra
+    bool ambasHebras = false;
+
+    // Plan del índice de k-mers: solo estos sospechosos (ordenados) pueden
+    // coincidir. nullptr = recorrer todos. El resultado es el mismo.
+    const std::vector<size_t>* filas = nullptr;
+
+    // Índice FM de la base: con él las búsquedas exactas no recorren los
+    // sospechosos (y se ignora filas). nullptr = no hay índice
+    const IndiceFM* indiceFM = nullptr;
+
+    // Coeficientes del modelo de costos del selector (--profile).
+    // nullptr = PerfilCostos::porDefecto()
+    const PerfilCostos* perfil = nullptr;
+
+    // Con receptor las coincidencias se le entregan a medida que se
+    // recorre la base (por tramos) y ResultadoBusqueda::coincidencias
+    // queda vacío. nullptr = devolverlas todas al final
+    ReceptorResultados* receptor = nullptr;
+
+    // Si no es nullptr, el motor le suma los tiempos de construcción y de
+    // recorrido y los contadores de la búsqueda
+    Metricas* metricas = nullptr;
+};
+
+/**
+ * Motor de búsqueda: valida los patrones, selecciona el algoritmo y
+ * recorre los sospechosos. Lo usan tanto la línea de comandos como el
+ * modo servidor (que mantiene los sospechosos cargados en memoria).
+ */
+class MotorBusqueda {
+public:
+    /**
+     * Divide la entrada "patron1,patron2,..." eliminando espacios
+     */
+    static std::vector<std::string> dividirPatrones(const std::string& entrada);
+
+    /**
+     * Complemento inverso de una cadena de ADN (la otra hebra leída en su
+     * sentido: A<->T, C<->G, de atrás hacia adelante)
+     */
+    static std::string complementoInverso(const std::string& patron);
+
+    /**
+     * Patrones que recorre la búsqueda: los dados y, con
+     * opciones.ambasHebras, sus complementos inversos a continuación (el
+     * patrón n + i es el complemento del i)
+     */
+    static std::vector<std::string> patronesDeBusqueda(const std::vector<std::string>& patrones,
+                                                       const OpcionesBusqueda& opciones);
+
+    /**
+     * Valida cantidad, alfabeto y longitud de los patrones
+     * @throws ErrorBusqueda con EMPTY_PATTERN, INVALID_PATTERN o INVALID_PATTERN_LENGTH
+     */
+    static void validarPatrones(const std::vector<std::string>& patrones);
+
+    /**
+     * Valida las opciones contra los patrones (ya validados)
+     * @throws ErrorBusqueda con INVALID_MAX_ERRORS si k no es menor que el patrón más corto
+     */
+    static void validarOpciones(const std::vector<std::string>& patrones, const OpcionesBusqueda& opciones);
+
+    /**
+     * Ejecuta la búsqueda de los patrones (ya validados) sobre los sospechosos
+     * Con opciones.maxErrores >= 0 cada sospechoso se reporta con la
+     * coincidencia aproximada que empieza más a la izquierda (entre patrones,
+     * a igual posición gana el de menor índice). Con opciones.ambasHebras
+     * los complementos inversos compiten con los patrones en la misma
+     * pasada (a igual coincidencia gana la hebra directa); la posición es
+     * siempre en la cadena tal como está guardada
+     * @param opciones Hilos para repartir los sospechosos y tolerancia a errores
+     * @return Algoritmo usado, criterio y coincidencias encontradas
+     */
+    static ResultadoBusqueda ejecutar(
+        const std::vector<std::string>& patrones,
+        const std::vector<Sospechoso>& sospechosos,
+        const OpcionesBusqueda& opciones = OpcionesBusqueda()
+    );
+
+    /**
+     * Igual que ejecutar, sobre los registros de un CSVMapeado (sin copias)
+     */
+    static ResultadoBusqueda ejecutar(
+        const std::vector<std::string>& patrones,
+        const std::vector<SospechosoVista>& sospechosos,
+        const OpcionesBusqueda& opciones = OpcionesBusqueda()
+    );
+
+    /**
+     * Igual que ejecutar, sobre cadenas empaquetadas a 2 bits
+     * (mismas coincidencias, 4 veces menos memoria por sospechoso)
+     */
+    static ResultadoBusqueda ejecutar(
+        const std::vector<std::string>& patrones,
+        const std::vector<SospechosoEmpaquetado>& sospechosos,
+        const OpcionesBusqueda& opciones = OpcionesBusqueda()
+    );
+
+    /**
+     * Igual que ejecutar, sobre las columnas de un AlmacenSospechosos
+     */
+    static ResultadoBusqueda ejecutar(
+        const std::vector<std::string>& patrones,
+        const AlmacenSospechosos& sospechosos,
+        const OpcionesBusqueda& opciones = OpcionesBusqueda()
+    );
+
+    /**
+     * Igual que ejecutar, sobre un CSV leído de a lotes (--max-memory): el
+     * algoritmo se elige con los totales de la primera pasada y las
+     * cédulas y los índices valen para todo el archivo, así el resultado
+     * es el mismo que sobre el CSV entero en memoria
+     */
+    static ResultadoBusqueda ejecutar(
+        const std::vector<std::string>& patrones,
+        const CSVPorLotes& csv,
+        const OpcionesBusqueda& opciones = OpcionesBusqueda()
+    );
+
+    /**
+     * Igual que ejecutar, sobre una base .adnb mapeada (texto o empaquetada)
+     */
+    static ResultadoBusqueda ejecutar(
+        const std::vector<std::string>& patrones,
+        const BaseDatosBinaria& base,
+        const OpcionesBusqueda& opciones = OpcionesBusqueda()
+    );
+
+    /**
+     * Varias consultas independientes (ya validadas) en una sola pasada por
+     * los sospechosos (--batch). Los patrones distintos de todo el lote van
+     * a un único autómata y cada consulta obtiene las mismas coincidencias
+     * que si se ejecutara sola. Con opciones.maxErrores >= 0 cada consulta
+     * se ejecuta aparte. Se ignoran filas, indiceFM y receptor.
+     * @return Un resultado por consulta, en el mismo orden
+     */
+    static std::vector<ResultadoBusqueda> ejecutarLote(
+        const std::vector<std::vector<std::string>>& consultas,
+        const std::vector<SospechosoVista>& sospechosos,
+        const OpcionesBusqueda& opciones = OpcionesBusqueda()
+    );
+
+    static std::vector<ResultadoBusqueda> ejecutarLote(
+        const std::vector<std::vector<std::string>>& consultas,
+        const std::vector<SospechosoEmpaquetado>& sospechosos,
+        const OpcionesBusqueda& opciones = OpcionesBusqueda()
+    );
+
+    static std::vector<ResultadoBusqueda> ejecutarLote(
+        const std::vector<std::vector<std::string>>& consultas,
+        const AlmacenSospechosos& sospechosos,
+        const OpcionesBusqueda& opciones = OpcionesBusqueda()
+    );
+
+    static std::vector<ResultadoBusqueda> ejecutarLote(
+        const std::vector<std::vector<std::string>>& consultas,
+        const BaseDatosBinaria& base,
+        const OpcionesBusqueda& opciones = OpcionesBusqueda()
+    );
+
+    /**
+     * Igual que ejecutar, sobre una instantánea del modo servidor (que no
+     * cambia durante la búsqueda aunque se publiquen otras)
+     */
+    static ResultadoBusqueda ejecutar(
+        const std::vector<std::string>& patrones,
+        const Instantanea& instantanea,
+        const OpcionesBusqueda& opciones = OpcionesBusqueda()
+    );
+};
+
+#endif // MOTOR_BUSQUEDA_H
@@ -0,0 +1,80 @@
+#ifndef PERFIL_COSTOS_H
+#define PERFIL_COSTOS_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include "algorithm_selector.h"
+
+/**
+ * Coeficientes del modelo de costos de AlgorithmSelector (en nanosegundos)
+ *
+ * El tiempo de un motor exacto se estima como
+ *     porBase                  × bases recorridas × pasadas
+ *   + porSecuencia             × sospechosos × pasadas
+ *   + porSecuenciaYBasePatron  × sospechosos × bases de los patrones
+ *   + porBasePatron            × bases de los patrones
+ * con una pasada por patrón (una sola para Aho-Corasick y una consulta por
+ * longitud distinta para Rabin-Karp múltiple). El tercer término es la
+ * preparación que KMP y Rabin-Karp repiten en cada llamada (tabla LPS,
+ * hash del patrón); el último, la construcción del autómata o de las tablas.
+ * Cada motor tiene un juego de coeficientes para cadenas en texto y otro
+ * para cadenas empaquetadas: el mismo motor puede ser el más rápido en una
+ * y de los más lentos en la otra.
+ *
+ * busqueda_adn --calibrate mide los motores en esta máquina con cargas
+ * sintéticas, ajusta los coeficientes por mínimos cuadrados y los guarda
+ * en un archivo de perfil (texto, una línea por motor). Sin perfil se usan
+ * coeficientes medidos en una máquina de referencia (x86-64 con AVX2).
+ */
+class PerfilCostos {
+public:
+    struct Coeficientes {
+        double porBase = 0;
+        double porSecuencia = 0;
+        double porSecuenciaYBasePatron = 0;
+        double porBasePatron = 0;
+    };
+
+    /**
+     * Coeficientes de la máquina de referencia
+     */
+    static const PerfilCostos& porDefecto();
+
+    /**
+     * Lee un perfil guardado con guardar()
+     * @throws std::runtime_error si el archivo no existe o está mal formado
+     */
+    static PerfilCostos cargar(const std::string& rutaArchivo);
+
+    /**
+     * @throws std::runtime_error si no se puede escribir el archivo
+     */
+    void guardar(const std::string& rutaArchivo) const;
+
+    /**
+     * Mide los motores exactos en esta máquina (unos segundos), sobre
+     * cadenas en texto y empaquetadas, y ajusta los coeficientes
+     */
+    static PerfilCostos calibrar();
+
+    /**
+     * Motores que cubre el modelo: KMP, Rabin-Karp, SIMD, Aho-Corasick y Rabin-Karp múltiple
+     */
+    static const std::vector<AlgorithmSelector::Algorithm>& algoritmosExactos();
+
+    const Coeficientes& coeficientes(AlgorithmSelector::Algorithm algoritmo,
+                                     CargaTrabajo::Representacion representacion) const;
+
+    /**
+     * true si los coeficientes vienen de una calibración (y no de porDefecto)
+     */
+    bool calibrado() const { return esCalibrado; }
+
+private:
+    std::map<std::pair<AlgorithmSelector::Algorithm, CargaTrabajo::Representacion>, Coeficientes> coeficientesPorMotor;
+    bool esCalibrado = false;
+};
+
+#endif // PERFIL_COSTOS_H
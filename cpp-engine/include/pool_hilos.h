@@ -0,0 +1,41 @@
+#ifndef POOL_HILOS_H
+#define POOL_HILOS_H
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * Reparto de trabajo entre hilos con robo de tareas (work-stealing)
+ *
+ * El rango [0, total) se divide en bloques. Cada hilo empieza con una
+ * porción contigua de bloques y, cuando termina la suya, roba bloques
+ * del final de la cola de otro hilo. Así se equilibra el trabajo aunque
+ * las cadenas de ADN tengan longitudes muy distintas.
+ *
+ * Los hilos se crean la primera vez que hacen falta y quedan esperando
+ * durante toda la vida del proceso: cada llamada reparte sus bloques en las
+ * colas de esos mismos hilos en lugar de crear y unir hilos nuevos. Las
+ * llamadas simultáneas desde distintos hilos se atienden de a una; una
+ * llamada desde dentro de una tarea se ejecuta en el hilo actual.
+ */
+class PoolHilos {
+public:
+    /**
+     * Ejecuta tarea(indice, hilo) para cada indice en [0, total)
+     * @param numHilos Hilos a usar (1 = ejecuta en el hilo actual)
+     * @param tarea Recibe el índice y el número de hilo [0, numHilos)
+     * @throws La primera excepción lanzada por alguna tarea
+     */
+    static void paraCada(
+        size_t total,
+        int numHilos,
+        const std::function<void(size_t indice, int hilo)>& tarea
+    );
+
+    /**
+     * Número de hilos de hardware (mínimo 1)
+     */
+    static int hilosDisponibles();
+};
+
+#endif // POOL_HILOS_H
@@ -2,11 +2,22 @@
 #define RABIN_KARP_H
 
 #include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "secuencia_empaquetada.h"
+#include "aho_corasick.h"
 
 /**
  * Algoritmo Rabin-Karp para búsqueda de patrones usando hashing
  * Complejidad: O(n + m) promedio, O(nm) peor caso
  * Ideal para: Patrones largos
+ *
+ * El hash es un polinomio sobre los códigos 2-bit de las bases con
+ * aritmética módulo 2^64 (el desborde natural de uint64_t): la ventana
+ * avanza con una multiplicación y dos sumas, sin divisiones. La base es
+ * impar y aleatoria por proceso, así ninguna entrada fija provoca
+ * colisiones sistemáticas; toda coincidencia de hash se verifica.
  */
 class RabinKarp {
 public:
@@ -14,29 +25,102 @@ public:
      * Busca un patrón en un texto usando Rabin-Karp
      * @param texto Cadena de ADN del sospechoso
      * @param patron Patrón de ADN a buscar
+     * @param colisiones Si no es nullptr, suma las ventanas con el hash del
+     *        patrón pero otro texto
      * @return Posición de la primera coincidencia (-1 si no existe)
      */
-    static int buscar(const std::string& texto, const std::string& patron);
+    static int buscar(std::string_view texto, std::string_view patron, uint64_t* colisiones = nullptr);
 
-private:
-    // Base para el hash (4 porque son 4 nucleótidos: A, T, C, G)
-    static const int BASE = 4;
-    // Número primo grande para reducir colisiones
-    static const long long PRIMO = 1000000007;
+    /**
+     * Variante sobre cadenas empaquetadas a 2 bits: las bases que entran y
+     * salen de la ventana se leen de a 32 por palabra y los candidatos se
+     * verifican comparando palabras completas
+     * @return Posición de la primera coincidencia (-1 si no existe)
+     */
+    static int buscar(const SecuenciaEmpaquetada& texto, const SecuenciaEmpaquetada& patron,
+                      uint64_t* colisiones = nullptr);
 
     /**
-     * Calcula el hash de una subcadena
-     * @param str Cadena a hashear
-     * @param longitud Longitud de la subcadena
-     * @return Valor del hash
+     * Base del polinomio (impar, elegida al azar una vez por proceso)
      */
-    static long long calcularHash(const std::string& str, int longitud);
+    static uint64_t base();
+
+    /**
+     * base()^exponente módulo 2^64 (por cuadrados sucesivos)
+     */
+    static uint64_t potencia(size_t exponente);
+
+    /**
+     * Hash de una cadena de texto (los caracteres que no son bases
+     * cuentan como G; la verificación los descarta)
+     */
+    static uint64_t calcularHash(std::string_view str);
+};
+
+/**
+ * Rabin-Karp para muchos patrones a la vez
+ *
+ * Los patrones se agrupan por longitud y se hace una pasada de hash
+ * rodante por cada longitud distinta (de la mayor a la menor). El hash de
+ * cada ventana se prueba en un filtro de bits y, si pasa, se busca en la
+ * tabla compacta (direccionamiento abierto) del grupo. Cada pasada se
+ * detiene donde ya no puede mejorar la coincidencia encontrada por las
+ * anteriores. Conviene frente a Aho-Corasick cuando hay cientos de
+ * patrones en pocas longitudes distintas.
+ */
+class RabinKarpMultiple {
+public:
+    /**
+     * Prepara las tablas para los patrones dados (índice = patronId)
+     */
+    explicit RabinKarpMultiple(const std::vector<std::string>& patrones);
+
+    /**
+     * Primera coincidencia del texto con el mismo criterio que
+     * AhoCorasick::PRIMERA: la que termina antes; a igual final la del
+     * patrón más largo y luego la de menor índice
+     * @param colisiones Si no es nullptr, suma las ventanas con el hash de
+     *        un patrón pero otro texto
+     * @return false si ningún patrón aparece
+     */
+    bool buscarPrimera(std::string_view texto, CoincidenciaMultiple& coincidencia,
+                       uint64_t* colisiones = nullptr) const;
+
+    bool buscarPrimera(const SecuenciaEmpaquetada& texto, CoincidenciaMultiple& coincidencia,
+                       uint64_t* colisiones = nullptr) const;
+
+    /**
+     * Número de longitudes distintas entre los patrones
+     */
+    size_t numLongitudes() const { return grupos.size(); }
+
+private:
+    // Patrones de una misma longitud
+    struct Grupo {
+        size_t longitud;
+        uint64_t potencia;             // base()^longitud
+
+        // Filtro de bits (64 por patrón): casi todas las ventanas se
+        // descartan con un solo bit, en un salto que se predice bien
+        int desplazamientoFiltro;      // Bit = hash >> desplazamientoFiltro
+        std::vector<uint64_t> filtro;
+
+        int desplazamiento;            // Ranura = hash >> desplazamiento
+        std::vector<uint64_t> claves;  // Hash de cada ranura
+        std::vector<int> ids;          // patronId de cada ranura (-1 = libre)
+    };
+
+    std::vector<std::string> patrones;
+    std::vector<SecuenciaEmpaquetada> patronesEmpaquetados;
+    std::vector<Grupo> grupos;         // De la longitud mayor a la menor
 
     /**
-     * Convierte un nucleótido a su valor numérico
-     * A=0, T=1, C=2, G=3
+     * @param cursorEn Crea un cursor (CursorTexto o CursorEmpaquetado) en una posición
+     * @param verificar (posicion, patronId) → true si el patrón está ahí
      */
-    static int charToInt(char c);
+    template <typename CrearCursor, typename Verificar>
+    bool recorrer(CrearCursor cursorEn, size_t n, Verificar verificar, CoincidenciaMultiple& coincidencia,
+                  uint64_t* colisiones) const;
 };
 
 #endif // RABIN_KARP_H
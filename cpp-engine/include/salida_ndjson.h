@@ -0,0 +1,75 @@
+#ifndef SALIDA_NDJSON_H
+#define SALIDA_NDJSON_H
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "motor_busqueda.h"
+
+/**
+ * Salida en streaming (--stream): un objeto JSON por línea (NDJSON)
+ *
+ *   {"tipo":"encabezado","exito":true,"patrones":[...],"num_patrones":2,
+ *    "algoritmo_usado":"...","criterio_seleccion":"...","total_procesados":N}
+ *   {"tipo":"coincidencia","nombre":"...","cedula":"...","patron_id":0,"posicion":12,"distancia":0,"hebra":"+"}
+ *   ...
+ *   {"tipo":"resumen","exito":true,"total_coincidencias":M,"tiempo_ejecucion_ms":T,"metricas":{...}}
+ *
+ * o, si algo falla, {"tipo":"error","exito":false,"error":...,"codigo_error":...,"detalles":...}
+ * (también después de coincidencias ya emitidas).
+ *
+ * Las coincidencias citan el patrón solo por patron_id (su índice en
+ * "patrones" del encabezado). Todo se escribe en un único buffer que se
+ * vacía al destino cuando se llena, sin armar la respuesta en memoria.
+ */
+class SalidaNDJSON : public ReceptorResultados {
+public:
+    /**
+     * @param destino Archivo abierto para escritura (por defecto stdout)
+     * @param capacidad Bytes del buffer
+     */
+    explicit SalidaNDJSON(std::FILE* destino = stdout, size_t capacidad = 1 << 20);
+
+    /**
+     * Vacía lo pendiente
+     */
+    ~SalidaNDJSON() override;
+
+    SalidaNDJSON(const SalidaNDJSON&) = delete;
+    SalidaNDJSON& operator=(const SalidaNDJSON&) = delete;
+
+    void encabezado(const std::vector<std::string>& patrones, const ResultadoBusqueda& resultado) override;
+
+    void coincidencia(const CoincidenciaVista& coincidencia) override;
+
+    /**
+     * Cierra una búsqueda exitosa y vacía el buffer
+     * @param metricas Si no es nullptr, se agrega "metricas" (las
+     *        coincidencias se escriben durante el recorrido y su tiempo
+     *        cuenta ahí, no en serializacion)
+     */
+    void resumen(long tiempoEjecucionMs, const Metricas* metricas = nullptr);
+
+    /**
+     * Evento de error (mismos campos que JSONOutput::generarError) y vacía el buffer
+     */
+    void error(const std::string& mensajeError, const std::string& codigoError, const std::string& detalles);
+
+    /**
+     * Escribe lo acumulado en el destino
+     */
+    void vaciar();
+
+private:
+    std::FILE* destino;
+    std::vector<char> buffer;
+    size_t usado = 0;
+    size_t totalCoincidencias = 0;
+
+    void escribir(std::string_view texto);
+    void escribirCadena(std::string_view texto);   // Entre comillas y escapada
+    void escribirNumero(long long valor);
+};
+
+#endif // SALIDA_NDJSON_H
@@ -0,0 +1,155 @@
+#ifndef SECUENCIA_EMPAQUETADA_H
+#define SECUENCIA_EMPAQUETADA_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * Cadena de ADN empaquetada a 2 bits por base (32 bases por palabra de 64 bits)
+ * Usa la misma codificación que codigoBase (cursor_bases.h): A=0, T=1, C=2, G=3
+ *
+ * La base i ocupa los bits [2*(i%32), 2*(i%32)+1] de la palabra i/32.
+ * Siempre hay una palabra extra de relleno (en cero) al final para que
+ * ventana() no tenga que revisar el límite.
+ *
+ * Puede ser dueña de sus palabras o ser una vista a memoria externa
+ * (por ejemplo, una base .adnb mapeada), ver vista().
+ */
+class SecuenciaEmpaquetada {
+public:
+    SecuenciaEmpaquetada();
+
+    /**
+     * Empaqueta una cadena ya validada (solo A, T, C, G)
+     */
+    explicit SecuenciaEmpaquetada(std::string_view cadenaADN);
+
+    /**
+     * Valida y empaqueta en una sola pasada (ver ValidacionADN)
+     * @return false si la cadena tiene algo distinto de A, T, C, G
+     *         (destino no cambia)
+     */
+    static bool empaquetarValidando(std::string_view cadenaADN, SecuenciaEmpaquetada& destino);
+
+    SecuenciaEmpaquetada(const SecuenciaEmpaquetada& otra);
+    SecuenciaEmpaquetada(SecuenciaEmpaquetada&& otra) noexcept;
+    SecuenciaEmpaquetada& operator=(const SecuenciaEmpaquetada& otra);
+    SecuenciaEmpaquetada& operator=(SecuenciaEmpaquetada&& otra) noexcept;
+
+    /**
+     * Vista sin copia a palabras ya empaquetadas
+     * @param palabras (numBases + 31) / 32 palabras seguidas de una palabra en cero;
+     *                 deben seguir vivas mientras se use la vista
+     */
+    static SecuenciaEmpaquetada vista(const uint64_t* palabras, size_t numBases);
+
+    /**
+     * Palabras empaquetadas (incluye la palabra de relleno)
+     */
+    const uint64_t* datos() const { return palabras; }
+
+    /**
+     * Número de palabras que ocupan numBases bases, con la de relleno
+     */
+    static size_t palabrasNecesarias(size_t numBases) { return (numBases + 31) / 32 + 1; }
+
+    size_t longitud() const { return numBases; }
+
+    /**
+     * Código (0-3) de la base en la posición i
+     */
+    uint8_t base(size_t i) const {
+        return (palabras[i >> 5] >> ((i & 31) * 2)) & 3;
+    }
+
+    /**
+     * 32 bases a partir de la posición i (las que pasan del final valen 0)
+     */
+    uint64_t ventana(size_t i) const {
+        size_t indice = i >> 5;
+        unsigned desplazamiento = (i & 31) * 2;
+        uint64_t valor = palabras[indice] >> desplazamiento;
+        if (desplazamiento != 0) {
+            valor |= palabras[indice + 1] << (64 - desplazamiento);
+        }
+        return valor;
+    }
+
+    /**
+     * Compara el patrón completo con el texto a partir de "posicion",
+     * 32 bases por comparación
+     * @return Número de bases que coinciden desde el inicio del patrón
+     *         (patron.longitud() si coincide completo)
+     */
+    size_t coincidenciaDesde(size_t posicion, const SecuenciaEmpaquetada& patron, size_t desde = 0) const;
+
+    /**
+     * Cuenta las bases distintas entre el patrón y el texto a partir de
+     * "posicion" (distancia de Hamming), 32 bases por palabra
+     * @param limite Deja de contar al pasar este número de diferencias
+     * @return Número de diferencias (cualquier valor > limite si se pasó)
+     */
+    size_t diferenciasDesde(size_t posicion, const SecuenciaEmpaquetada& patron, size_t limite) const;
+
+    /**
+     * Vuelve a la representación de texto
+     */
+    std::string desempaquetar() const;
+
+    /**
+     * Bytes ocupados por las bases empaquetadas
+     */
+    size_t bytesMemoria() const { return palabrasNecesarias(numBases) * sizeof(uint64_t); }
+
+    /**
+     * A=0, T=1, C=2, G=3 (cualquier otro carácter se codifica como 0)
+     */
+    static uint8_t codificar(char c);
+
+    static char decodificar(uint8_t codigo);
+
+    /**
+     * Índice de la primera base distinta en una XOR de dos ventanas (diferencia != 0)
+     */
+    static unsigned primeraDiferencia(uint64_t diferencia) {
+#ifdef _MSC_VER
+        unsigned long bit;
+        _BitScanForward64(&bit, diferencia);
+        return bit / 2;
+#else
+        return __builtin_ctzll(diferencia) / 2;
+#endif
+    }
+
+    /**
+     * Número de bases distintas en una XOR de dos ventanas
+     */
+    static unsigned contarDiferencias(uint64_t diferencia) {
+        // Una base difiere si alguno de sus 2 bits difiere
+        uint64_t bases = (diferencia | (diferencia >> 1)) & 0x5555555555555555ULL;
+#ifdef _MSC_VER
+        return static_cast<unsigned>(__popcnt64(bases));
+#else
+        return __builtin_popcountll(bases);
+#endif
+    }
+
+private:
+    /**
+     * Constructor de vista (sin reservar memoria)
+     */
+    SecuenciaEmpaquetada(const uint64_t* palabras, size_t numBases);
+
+    std::vector<uint64_t> almacen;   // Vacío si es una vista
+    const uint64_t* palabras;
+    size_t numBases;
+};
+
+#endif // SECUENCIA_EMPAQUETADA_H
@@ -0,0 +1,123 @@
+#ifndef SERVIDOR_H
+#define SERVIDOR_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "instantanea.h"
+#include "cache_resultados.h"
+#include "motor_busqueda.h"
+
+/**
+ * Modo servidor: carga los sospechosos UNA sola vez y responde
+ * consultas de patrones sin volver a leer el CSV.
+ * Las cadenas se guardan empaquetadas a 2 bits por base; una base .adnb
+ * empaquetada se usa directamente desde el mapeo.
+ *
+ * Protocolo (una consulta por línea):
+ *   patron1[,patron2,...]      → JSON de JSONOutput::generarExito / generarError
+ *   AGREGAR nombre,cedula,adn  → agrega un sospechoso (mismas validaciones que el CSV)
+ *   DESACTIVAR cedula          → deja de buscarlo, pero lo conserva para ACTIVAR
+ *   ACTIVAR cedula             → vuelve a buscar un sospechoso desactivado
+ *   ELIMINAR cedula            → lo quita (activo o no)
+ *   RECARGAR                   → vuelve a leer el CSV o la base .adnb
+ *   SALIR                      → cierra la sesión
+ *
+ * Cada respuesta termina con una línea que contiene solo "}". Una
+ * búsqueda repetida sobre los mismos sospechosos sale de la caché de
+ * resultados ("cache_hit": true).
+ *
+ * Los sospechosos viven en una Instantanea inmutable. Cada cambio arma
+ * una nueva (copiando solo los segmentos afectados) y la publica; las
+ * búsquedas toman la instantánea vigente al empezar y la recorren sin
+ * locks, así que nunca esperan a un cambio ni ven uno a medias. Con
+ * socket cada cliente se atiende en su propio hilo, y SIGINT o SIGTERM
+ * cierran el servidor esperando a que terminen.
+ */
+class Servidor {
+public:
+    // Memoria de la caché de resultados sin --cache-mb (64 MiB)
+    static const size_t PRESUPUESTO_CACHE_POR_DEFECTO = 64u << 20;
+
+    /**
+     * @param rutaCSV Archivo de sospechosos (.csv o .adnb) a mantener en memoria
+     * @param opciones Hilos y tolerancia a errores usados en cada búsqueda
+     * @param presupuestoCache Bytes para la caché de resultados (0 = sin caché)
+     * @throws std::runtime_error si el archivo no se puede leer
+     */
+    Servidor(
+        const std::string& rutaCSV,
+        const OpcionesBusqueda& opciones = OpcionesBusqueda(),
+        size_t presupuestoCache = PRESUPUESTO_CACHE_POR_DEFECTO
+    );
+
+    /**
+     * Atiende consultas desde stdin hasta SALIR o fin de entrada
+     */
+    void atenderStdin();
+
+    /**
+     * Atiende conexiones en un socket Unix (cada sesión en su propio hilo)
+     * hasta recibir SIGINT o SIGTERM. Al cerrar deja de aceptar, termina
+     * las sesiones tras la respuesta en curso, une sus hilos y borra el socket
+     * @throws std::runtime_error si no se puede crear el socket o accept
+     *         falla por algo distinto de una interrupción o falta de recursos
+     */
+    void atenderSocket(const std::string& rutaSocket);
+
+private:
+    std::string rutaCSV;
+    OpcionesBusqueda opciones;
+
+    // Instantánea vigente: se lee y se reemplaza con std::atomic_load/atomic_store
+    std::shared_ptr<const Instantanea> instantanea;
+
+    // Resultados por patrones, modo y versión de la instantánea: un cambio
+    // publica otra versión, así que nunca se devuelve un resultado viejo
+    CacheResultados cache;
+
+    // Serializa los cambios (las búsquedas no lo toman)
+    std::mutex escritura;
+
+    // Registros desactivados por cédula (protegidos por escritura)
+    std::multimap<std::string, Instantanea::Registro, std::less<>> inactivos;
+
+    /**
+     * Carga (o recarga) los sospechosos desde rutaCSV y publica la instantánea
+     */
+    void cargar();
+
+    /**
+     * Publica la instantánea para las búsquedas que empiecen desde ahora
+     */
+    void publicar(std::shared_ptr<const Instantanea> nueva);
+
+    /**
+     * Atiende una conexión del socket hasta SALIR o que el cliente cierre
+     * (el descriptor lo cierra quien une el hilo)
+     */
+    void atenderCliente(int clienteFd);
+
+    /**
+     * Procesa una línea del protocolo
+     * @param respuesta JSON a devolver al cliente (vacío si no hay respuesta)
+     * @return false si el cliente pidió SALIR
+     */
+    bool procesarLinea(const std::string& linea, std::string& respuesta);
+
+    /**
+     * Ejecuta la búsqueda de una línea de patrones
+     */
+    std::string responderBusqueda(const std::string& patronesInput);
+
+    /**
+     * Aplica AGREGAR, DESACTIVAR, ACTIVAR o ELIMINAR
+     * @param argumento Lo que sigue al comando (registro CSV o cédula)
+     */
+    std::string responderCambio(const std::string& comando, std::string_view argumento);
+};
+
+#endif // SERVIDOR_H
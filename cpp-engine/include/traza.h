@@ -0,0 +1,65 @@
+#ifndef TRAZA_H
+#define TRAZA_H
+
+#include <atomic>
+#include <sstream>
+#include <string>
+
+/**
+ * Trazas de diagnóstico por stderr, con niveles (--trace info|debug o la
+ * variable BUSQUEDA_ADN_TRAZA)
+ *
+ * Apagadas (el nivel por defecto) cuestan una lectura y un salto: el
+ * mensaje de TRAZA ni siquiera se arma. Compilando con
+ * -DBUSQUEDA_ADN_SIN_TRAZA desaparecen del binario.
+ */
+class Traza {
+public:
+    enum Nivel {
+        APAGADA = 0,
+        INFORMACION = 1,  // Plan de la consulta y tiempos por fase
+        DEPURACION = 2    // Además, la entrada byte a byte
+    };
+
+    static bool activa(Nivel nivel) {
+        return nivel <= nivelActual.load(std::memory_order_relaxed);
+    }
+
+    static void configurar(Nivel nivel) {
+        nivelActual.store(nivel, std::memory_order_relaxed);
+    }
+
+    /**
+     * "off", "info" o "debug"
+     * @throws std::invalid_argument si el nombre no es un nivel
+     */
+    static Nivel leerNivel(const std::string& nombre);
+
+    /**
+     * Escribe "[NIVEL] mensaje" en stderr (una línea completa por llamada,
+     * aunque escriban varios hilos)
+     */
+    static void escribir(Nivel nivel, const std::string& mensaje);
+
+private:
+    static inline std::atomic<int> nivelActual{APAGADA};
+};
+
+#ifdef BUSQUEDA_ADN_SIN_TRAZA
+#define TRAZA(nivel, mensaje) do { } while (0)
+#else
+/**
+ * TRAZA(DEPURACION, "Patrones: " << patrones.size()): el mensaje se evalúa solo
+ * si el nivel está activo
+ */
+#define TRAZA(nivel, mensaje)                                   \
+    do {                                                        \
+        if (Traza::activa(Traza::nivel)) {                      \
+            std::ostringstream trazaMensaje;                    \
+            trazaMensaje << mensaje;                            \
+            Traza::escribir(Traza::nivel, trazaMensaje.str());  \
+        }                                                       \
+    } while (0)
+#endif
+
+#endif // TRAZA_H
@@ -0,0 +1,33 @@
+#ifndef VALIDACION_ADN_H
+#define VALIDACION_ADN_H
+
+#include <string_view>
+#include <cstdint>
+
+/**
+ * Validación de cadenas de ADN de a 32 bases (AVX2, o dos bloques SSE2)
+ *
+ * Cada bloque se compara a la vez contra A, T, C y G. Como los códigos
+ * de 2 bits (A=0, T=1, C=2, G=3) son los bits 2 y 1 del ASCII de cada
+ * base, el mismo bloque se puede empaquetar con dos máscaras de bits sin
+ * volver a leer el texto. Igual que BusquedaSIMD, el conjunto de
+ * instrucciones se detecta en tiempo de ejecución.
+ */
+class ValidacionADN {
+public:
+    /**
+     * @return true si la cadena solo contiene A, T, C, G (la vacía también)
+     */
+    static bool validar(std::string_view cadenaADN);
+
+    /**
+     * Valida y empaqueta en la misma pasada, con el formato de
+     * SecuenciaEmpaquetada
+     * @param palabras Al menos (n + 31) / 32 palabras, que se sobrescriben
+     * @return false si hay algo distinto de A, T, C, G (las palabras
+     *         quedan a medio escribir)
+     */
+    static bool validarYEmpaquetar(std::string_view cadenaADN, uint64_t* palabras);
+};
+
+#endif // VALIDACION_ADN_H
@@ -1,170 +1,213 @@
 #include "../../include/aho_corasick.h"
+#include "../../include/cursor_bases.h"
+#include <queue>
 
-// Wrapper para un solo patrón (compatibilidad con código anterior)
-int AhoCorasick::buscar(const std::string& texto, const std::string& patron) {
-    std::vector<std::string> patrones = {patron};
-    std::vector<CoincidenciaMultiple> resultados = buscarMultiple(texto, patrones);
+AhoCorasick::AhoCorasick(const std::vector<std::string>& patrones) {
+    // Trie temporal: hijos[estado * ALFABETO + base] (-1 = sin hijo)
+    std::vector<int> hijos(ALFABETO, -1);
+    std::vector<std::vector<int>> patronesPorEstado(1);
 
-    if (resultados.empty()) {
-        return -1;
-    }
+    longitudes.reserve(patrones.size());
 
-    return resultados[0].posicion;
-}
+    // Insertar cada patrón en el trie
+    for (size_t patronId = 0; patronId < patrones.size(); patronId++) {
+        const std::string& patron = patrones[patronId];
+        longitudes.push_back(patron.length());
 
-// NUEVA FUNCIÓN: Buscar MÚLTIPLES patrones simultáneamente
-std::vector<CoincidenciaMultiple> AhoCorasick::buscarMultiple(
-    const std::string& texto,
-    const std::vector<std::string>& patrones
-) {
-    std::vector<CoincidenciaMultiple> coincidencias;
+        bool valido = true;
+        for (char c : patron) {
+            if (codigoBase(c) < 0) {
+                valido = false;
+                break;
+            }
+        }
+        if (!valido) {
+            continue;
+        }
 
-    int n = texto.length();
+        int estadoActual = 0;
+        for (char c : patron) {
+            int base = codigoBase(c);
 
-    // Validar que haya patrones
-    if (patrones.empty() || n == 0) {
-        return coincidencias;
-    }
+            // Si no existe la transición, crear nuevo nodo
+            if (hijos[estadoActual * ALFABETO + base] == -1) {
+                hijos[estadoActual * ALFABETO + base] = patronesPorEstado.size();
+                hijos.insert(hijos.end(), ALFABETO, -1);
+                patronesPorEstado.emplace_back();
+            }
 
-    // Construir el trie y los enlaces de fallo
-    std::vector<TrieNode> trie;
-    trie.push_back(TrieNode()); // Nodo raíz (índice 0)
+            estadoActual = hijos[estadoActual * ALFABETO + base];
+        }
 
-    construirTrieMultiple(patrones, trie);
-    construirFallos(trie);
+        // Marcar el último nodo como patrón
+        patronesPorEstado[estadoActual].push_back(patronId);
+    }
 
-    // Búsqueda en el texto
-    int estado = 0;
+    int totalEstados = patronesPorEstado.size();
 
-    for (int i = 0; i < n; i++) {
-        char c = texto[i];
+    // Aplanar los patrones de cada estado
+    inicioSalidas.assign(totalEstados + 1, 0);
+    for (int e = 0; e < totalEstados; e++) {
+        inicioSalidas[e + 1] = inicioSalidas[e] + patronesPorEstado[e].size();
+        patronesSalida.insert(patronesSalida.end(),
+                              patronesPorEstado[e].begin(), patronesPorEstado[e].end());
+    }
 
-        // Seguir los enlaces de fallo si no hay transición directa
-        while (estado != 0 && trie[estado].hijos.find(c) == trie[estado].hijos.end()) {
-            estado = trie[estado].fallo;
-        }
+    // BFS: calcular fallos y completar la tabla goto con las transiciones de fallo
+    transiciones.assign(totalEstados * ALFABETO, 0);
+    enlaceSalida.assign(totalEstados, -1);
+    std::vector<int> fallo(totalEstados, 0);
+    std::queue<int> cola;
 
-        // Realizar transición si existe
-        if (trie[estado].hijos.find(c) != trie[estado].hijos.end()) {
-            estado = trie[estado].hijos[c];
+    for (int base = 0; base < ALFABETO; base++) {
+        int hijo = hijos[base];
+        if (hijo != -1) {
+            transiciones[base] = hijo;
+            cola.push(hijo);
         }
+    }
 
-        // Verificar si encontramos algún patrón en este estado
-        if (!trie[estado].patronesEncontrados.empty()) {
-            // Puede haber múltiples patrones que terminan aquí
-            for (size_t j = 0; j < trie[estado].patronesEncontrados.size(); j++) {
-                int patronId = trie[estado].patronesEncontrados[j];
-                int longitudPatron = trie[estado].longitudesPatrones[j];
+    while (!cola.empty()) {
+        int estadoActual = cola.front();
+        cola.pop();
 
-                CoincidenciaMultiple coincidencia;
-                coincidencia.patronId = patronId;
-                coincidencia.posicion = i - longitudPatron + 1;
+        for (int base = 0; base < ALFABETO; base++) {
+            int hijo = hijos[estadoActual * ALFABETO + base];
+            int destinoFallo = transiciones[fallo[estadoActual] * ALFABETO + base];
 
-                coincidencias.push_back(coincidencia);
+            if (hijo == -1) {
+                // Sin hijo: la transición es la misma que la del estado de fallo
+                transiciones[estadoActual * ALFABETO + base] = destinoFallo;
+                continue;
             }
-        }
-
-        // También verificar estados alcanzables por enlaces de fallo
-        int estadoTemp = trie[estado].fallo;
-        while (estadoTemp != 0 && estadoTemp != -1) {
-            if (!trie[estadoTemp].patronesEncontrados.empty()) {
-                for (size_t j = 0; j < trie[estadoTemp].patronesEncontrados.size(); j++) {
-                    int patronId = trie[estadoTemp].patronesEncontrados[j];
-                    int longitudPatron = trie[estadoTemp].longitudesPatrones[j];
 
-                    CoincidenciaMultiple coincidencia;
-                    coincidencia.patronId = patronId;
-                    coincidencia.posicion = i - longitudPatron + 1;
+            transiciones[estadoActual * ALFABETO + base] = hijo;
+            fallo[hijo] = destinoFallo;
 
-                    coincidencias.push_back(coincidencia);
-                }
+            // Enlace de salida: el primer estado con patrones en la cadena de fallos
+            if (destinoFallo != 0 && inicioSalidas[destinoFallo + 1] > inicioSalidas[destinoFallo]) {
+                enlaceSalida[hijo] = destinoFallo;
+            } else {
+                enlaceSalida[hijo] = enlaceSalida[destinoFallo];
             }
-            estadoTemp = trie[estadoTemp].fallo;
+
+            cola.push(hijo);
         }
     }
-
-    return coincidencias;
 }
 
-void AhoCorasick::construirTrieMultiple(
-    const std::vector<std::string>& patrones,
-    std::vector<TrieNode>& trie
-) {
-    for (size_t patronId = 0; patronId < patrones.size(); patronId++) {
-        const std::string& patron = patrones[patronId];
-        int estadoActual = 0;
+template <typename Cursor>
+void AhoCorasick::recorrer(Cursor cursor, size_t n, Politica politica, const Receptor& receptor,
+                           uint64_t* saltosEnlace) const {
+    std::vector<char> encontrados;
+    size_t pendientes = 0;
 
-        // Insertar el patrón en el trie
-        for (char c : patron) {
-            // Si no existe la transición, crear nuevo nodo
-            if (trie[estadoActual].hijos.find(c) == trie[estadoActual].hijos.end()) {
-                trie[estadoActual].hijos[c] = trie.size();
-                trie.push_back(TrieNode());
-            }
+    if (politica == PRIMERA_POR_PATRON) {
+        encontrados.assign(longitudes.size(), 0);
+        pendientes = longitudes.size();
+    }
 
-            estadoActual = trie[estadoActual].hijos[c];
-        }
+    int estado = 0;
 
-        // Marcar el último nodo como patrón
-        trie[estadoActual].patronesEncontrados.push_back(patronId);
-        trie[estadoActual].longitudesPatrones.push_back(patron.length());
-    }
-}
+    for (size_t i = 0; i < n; i++) {
+        int base = cursor.siguiente();
 
-int AhoCorasick::construirTrie(const std::string& patron, std::vector<TrieNode>& trie) {
-    int estadoActual = 0;
+        // Un carácter fuera del alfabeto no pertenece a ningún patrón
+        estado = (base < 0) ? 0 : transiciones[estado * ALFABETO + base];
 
-    for (char c : patron) {
-        // Si no existe la transición, crear nuevo nodo
-        if (trie[estadoActual].hijos.find(c) == trie[estadoActual].hijos.end()) {
-            trie[estadoActual].hijos[c] = trie.size();
-            trie.push_back(TrieNode());
+        if (inicioSalidas[estado + 1] > inicioSalidas[estado] || enlaceSalida[estado] != -1) {
+            if (reportar(estado, i, politica, encontrados, pendientes, receptor, saltosEnlace)) {
+                return;
+            }
         }
-
-        estadoActual = trie[estadoActual].hijos[c];
     }
+}
 
-    // Marcar el último nodo como patrón
-    trie[estadoActual].patronesEncontrados.push_back(0);
-    trie[estadoActual].longitudesPatrones.push_back(patron.length());
+void AhoCorasick::buscarEn(std::string_view texto, Politica politica, const Receptor& receptor,
+                           uint64_t* saltosEnlace) const {
+    recorrer(CursorTexto{texto.data()}, texto.length(), politica, receptor, saltosEnlace);
+}
 
-    return estadoActual;
+void AhoCorasick::buscarEn(const SecuenciaEmpaquetada& texto, Politica politica, const Receptor& receptor,
+                           uint64_t* saltosEnlace) const {
+    recorrer(CursorEmpaquetado{texto, 0, 0}, texto.longitud(), politica, receptor, saltosEnlace);
 }
 
-void AhoCorasick::construirFallos(std::vector<TrieNode>& trie) {
-    std::queue<int> cola;
+std::vector<CoincidenciaMultiple> AhoCorasick::buscarEn(std::string_view texto) const {
+    std::vector<CoincidenciaMultiple> coincidencias;
+    buscarEn(texto, TODAS, [&](const CoincidenciaMultiple& c) { coincidencias.push_back(c); });
+    return coincidencias;
+}
 
-    // Enlaces de fallo para hijos de la raíz apuntan a la raíz
-    for (auto& par : trie[0].hijos) {
-        int hijo = par.second;
-        trie[hijo].fallo = 0;
-        cola.push(hijo);
-    }
+std::vector<CoincidenciaMultiple> AhoCorasick::buscarEn(const SecuenciaEmpaquetada& texto) const {
+    std::vector<CoincidenciaMultiple> coincidencias;
+    buscarEn(texto, TODAS, [&](const CoincidenciaMultiple& c) { coincidencias.push_back(c); });
+    return coincidencias;
+}
 
-    // BFS para construir enlaces de fallo
-    while (!cola.empty()) {
-        int estadoActual = cola.front();
-        cola.pop();
+bool AhoCorasick::reportar(
+    int estado,
+    int posicionFinal,
+    Politica politica,
+    std::vector<char>& encontrados,
+    size_t& pendientes,
+    const Receptor& receptor,
+    uint64_t* saltosEnlace
+) const {
+    // Primero los patrones del propio estado, luego los de la cadena de salidas
+    for (int e = estado; e != -1; e = enlaceSalida[e]) {
+        if (saltosEnlace != nullptr && e != estado) {
+            ++*saltosEnlace;
+        }
+        for (int k = inicioSalidas[e]; k < inicioSalidas[e + 1]; k++) {
+            int patronId = patronesSalida[k];
 
-        for (auto& par : trie[estadoActual].hijos) {
-            char c = par.first;
-            int hijo = par.second;
+            if (politica == PRIMERA_POR_PATRON) {
+                if (encontrados[patronId]) {
+                    continue;
+                }
+                encontrados[patronId] = 1;
+                pendientes--;
+            }
 
-            // Encontrar el enlace de fallo
-            int fallo = trie[estadoActual].fallo;
+            CoincidenciaMultiple coincidencia;
+            coincidencia.patronId = patronId;
+            coincidencia.posicion = posicionFinal - longitudes[patronId] + 1;
+            receptor(coincidencia);
 
-            while (fallo != 0 && fallo != -1 && trie[fallo].hijos.find(c) == trie[fallo].hijos.end()) {
-                fallo = trie[fallo].fallo;
+            if (politica == PRIMERA) {
+                return true;
             }
+        }
+    }
 
-            if (fallo != -1 && trie[fallo].hijos.find(c) != trie[fallo].hijos.end() &&
-                trie[fallo].hijos[c] != hijo) {
-                trie[hijo].fallo = trie[fallo].hijos[c];
-            } else {
-                trie[hijo].fallo = 0;
-            }
+    return politica == PRIMERA_POR_PATRON && pendientes == 0;
+}
 
-            cola.push(hijo);
-        }
+int AhoCorasick::numEstados() const {
+    return enlaceSalida.size();
+}
+
+std::vector<CoincidenciaMultiple> AhoCorasick::buscarMultiple(
+    const std::string& texto,
+    const std::vector<std::string>& patrones
+) {
+    // Validar que haya patrones
+    if (patrones.empty() || texto.empty()) {
+        return std::vector<CoincidenciaMultiple>();
     }
+
+    AhoCorasick automata(patrones);
+    return automata.buscarEn(texto);
+}
+
+// Wrapper para un solo patrón (compatibilidad con código anterior)
+int AhoCorasick::buscar(const std::string& texto, const std::string& patron) {
+    AhoCorasick automata({patron});
+
+    int posicion = -1;
+    automata.buscarEn(texto, PRIMERA, [&](const CoincidenciaMultiple& coincidencia) {
+        posicion = coincidencia.posicion;
+    });
+    return posicion;
 }
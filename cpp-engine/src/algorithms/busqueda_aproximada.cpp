@@ -0,0 +1,270 @@
+#include "../../include/busqueda_aproximada.h"
+#include "../../include/cursor_bases.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+const int BITS_BLOQUE = 64;
+const int CODIGO_INVALIDO = 4;
+
+// Diferencias verticales de un bloque de 64 filas de la matriz de Myers
+// y el valor de su última fila en la columna actual
+struct Bloque {
+    uint64_t positivas;
+    uint64_t negativas;
+    int puntaje;
+};
+
+/**
+ * Avanza un bloque una columna (Hyyrö)
+ * @param eq Filas del bloque cuya base coincide con la del texto
+ * @param entrada Diferencia horizontal que llega desde el bloque de arriba (-1, 0, +1)
+ * @param bitAlto Bit de la última fila del bloque
+ * @return Diferencia horizontal en la última fila
+ */
+int avanzarBloque(Bloque& bloque, uint64_t eq, int entrada, uint64_t bitAlto) {
+    uint64_t pv = bloque.positivas;
+    uint64_t mv = bloque.negativas;
+    uint64_t entradaNegativa = entrada < 0 ? 1 : 0;
+
+    uint64_t xv = eq | mv;
+    eq |= entradaNegativa;
+    uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+    uint64_t ph = mv | ~(xh | pv);
+    uint64_t mh = pv & xh;
+
+    int salida = 0;
+    if (ph & bitAlto) {
+        salida = 1;
+    } else if (mh & bitAlto) {
+        salida = -1;
+    }
+
+    ph <<= 1;
+    mh <<= 1;
+    mh |= entradaNegativa;
+    if (entrada > 0) {
+        ph |= 1;
+    }
+
+    bloque.positivas = mh | ~(xv | ph);
+    bloque.negativas = ph & xv;
+    return salida;
+}
+
+}
+
+BusquedaAproximada::BusquedaAproximada(const std::string& patron, int maxErrores, Distancia distancia)
+    : patron(patron),
+      maxErrores(maxErrores),
+      distancia(distancia),
+      numBloques((patron.length() + BITS_BLOQUE - 1) / BITS_BLOQUE),
+      peq((CODIGO_INVALIDO + 1) * numBloques, 0),
+      patronEmpaquetado(patron),
+      usarSemillas(false),
+      semillas(std::vector<std::string>()) {
+
+    for (size_t i = 0; i < patron.length(); i++) {
+        int codigo = codigoBase(patron[i]);
+        if (codigo >= 0) {
+            peq[codigo * numBloques + i / BITS_BLOQUE] |= 1ULL << (i % BITS_BLOQUE);
+        }
+    }
+
+    // Semillas del palomar: k+1 trozos de longitud casi igual
+    size_t numSemillas = maxErrores + 1;
+    if (distancia == HAMMING && patron.length() / numSemillas >= LONGITUD_MINIMA_SEMILLA) {
+        std::vector<std::string> trozos;
+        for (size_t s = 0; s < numSemillas; s++) {
+            size_t inicio = s * patron.length() / numSemillas;
+            size_t fin = (s + 1) * patron.length() / numSemillas;
+            inicioSemillas.push_back(inicio);
+            trozos.push_back(patron.substr(inicio, fin - inicio));
+        }
+        semillas = AhoCorasick(trozos);
+        usarSemillas = true;
+    }
+}
+
+CoincidenciaAproximada BusquedaAproximada::buscarEn(std::string_view texto) const {
+    if (distancia == HAMMING) {
+        return buscarHamming(SecuenciaEmpaquetada(texto));
+    }
+
+    auto baseEn = [&](size_t i) { return codigoBase(texto[i]); };
+    return buscarEdicion(CursorTexto{texto.data()}, texto.length(), baseEn);
+}
+
+CoincidenciaAproximada BusquedaAproximada::buscarEn(const SecuenciaEmpaquetada& texto) const {
+    if (distancia == HAMMING) {
+        return buscarHamming(texto);
+    }
+
+    auto baseEn = [&](size_t i) { return static_cast<int>(texto.base(i)); };
+    return buscarEdicion(CursorEmpaquetado{texto, 0, 0}, texto.longitud(), baseEn);
+}
+
+template <typename Cursor, typename Acceso>
+CoincidenciaAproximada BusquedaAproximada::buscarEdicion(Cursor cursor, size_t n, const Acceso& baseEn) const {
+    int m = patron.length();
+    int k = maxErrores;
+
+    // Caso especial: patrón vacío
+    if (m == 0) return {0, 0};
+
+    // El último bloque puede tener menos de 64 filas
+    int filasUltimo = m - (numBloques - 1) * BITS_BLOQUE;
+    auto filas = [&](int b) { return b == numBloques - 1 ? filasUltimo : BITS_BLOQUE; };
+    auto bitAlto = [&](int b) { return 1ULL << (filas(b) - 1); };
+
+    // Bloques activos: 0..ultimo. Los de abajo solo tienen valores > k
+    std::vector<Bloque> bloques(numBloques);
+    int ultimo = std::min(numBloques, (k + BITS_BLOQUE) / BITS_BLOQUE) - 1;
+    for (int b = 0; b <= ultimo; b++) {
+        bloques[b] = {~0ULL, 0, b * BITS_BLOQUE + filas(b)};
+    }
+
+    int mejorFin = -1;
+    int mejorDistancia = 0;
+
+    for (size_t j = 0; j < n; j++) {
+        int codigo = cursor.siguiente();
+        const uint64_t* eq = &peq[(codigo < 0 ? CODIGO_INVALIDO : codigo) * numBloques];
+
+        int salida = 0;
+        for (int b = 0; b <= ultimo; b++) {
+            salida = avanzarBloque(bloques[b], eq[b], salida, bitAlto(b));
+            bloques[b].puntaje += salida;
+        }
+
+        // Corte de Ukkonen: activar el siguiente bloque si puede bajar a <= k,
+        // o desactivar los de abajo que ya no pueden
+        if (ultimo < numBloques - 1 && bloques[ultimo].puntaje - salida <= k &&
+            ((eq[ultimo + 1] & 1) || salida < 0)) {
+            ultimo++;
+            Bloque& nuevo = bloques[ultimo];
+            nuevo.positivas = ~0ULL;
+            nuevo.negativas = 0;
+            int salidaNuevo = avanzarBloque(nuevo, eq[ultimo], salida, bitAlto(ultimo));
+            nuevo.puntaje = bloques[ultimo - 1].puntaje - salida + filas(ultimo) + salidaNuevo;
+        } else {
+            while (ultimo > 0 && bloques[ultimo].puntaje >= k + filas(ultimo)) {
+                ultimo--;
+            }
+        }
+
+        // Distancia de todo el patrón terminando en j
+        int actual = ultimo == numBloques - 1 ? bloques[ultimo].puntaje : k + 1;
+
+        if (mejorFin >= 0) {
+            // Seguir mientras la misma coincidencia mejore
+            if (actual >= mejorDistancia) break;
+            mejorFin = j;
+            mejorDistancia = actual;
+        } else if (actual <= k) {
+            mejorFin = j;
+            mejorDistancia = actual;
+            if (mejorDistancia == 0) break;
+        }
+    }
+
+    if (mejorFin < 0) {
+        return {-1, -1};
+    }
+
+    int inicio = inicioAlineacion(baseEn, mejorFin, mejorDistancia);
+    return {inicio, mejorDistancia};
+}
+
+template <typename Acceso>
+size_t BusquedaAproximada::inicioAlineacion(const Acceso& baseEn, size_t fin, int distancia) const {
+    // Programación dinámica sobre el patrón y el texto leídos hacia atrás
+    // desde "fin": fila i = últimas i bases del patrón, columna c = últimas
+    // c bases del texto. Solo la banda |i - c| <= distancia puede valer <= distancia.
+    int m = patron.length();
+    int columnas = static_cast<int>(std::min<size_t>(fin + 1, m + distancia));
+    const int INFINITO = m + distancia + 1;
+
+    std::vector<int> anterior(columnas + 2, INFINITO);
+    std::vector<int> actual(columnas + 2, INFINITO);
+    for (int c = 0; c <= std::min(columnas, distancia); c++) {
+        anterior[c] = c;
+    }
+
+    for (int i = 1; i <= m; i++) {
+        int basePatron = codigoBase(patron[m - i]);
+        int desde = std::max(1, i - distancia);
+        int hasta = std::min(columnas, i + distancia);
+
+        actual[desde - 1] = desde == 1 ? i : INFINITO;
+        for (int c = desde; c <= hasta; c++) {
+            int sustitucion = anterior[c - 1] + (baseEn(fin + 1 - c) != basePatron ? 1 : 0);
+            actual[c] = std::min({sustitucion, anterior[c] + 1, actual[c - 1] + 1});
+        }
+        actual[hasta + 1] = INFINITO;
+
+        std::swap(anterior, actual);
+    }
+
+    // La alineación más larga con la distancia encontrada
+    int mejorColumna = m;
+    for (int c = 0; c <= columnas; c++) {
+        if (anterior[c] == distancia) {
+            mejorColumna = c;
+        }
+    }
+
+    return fin + 1 - mejorColumna;
+}
+
+CoincidenciaAproximada BusquedaAproximada::buscarHamming(const SecuenciaEmpaquetada& texto) const {
+    size_t n = texto.longitud();
+    size_t m = patronEmpaquetado.longitud();
+    size_t k = maxErrores;
+
+    if (m > n) return {-1, -1};
+    size_t ultima = n - m; // Última posición de inicio posible
+
+    if (!usarSemillas) {
+        for (size_t i = 0; i <= ultima; i++) {
+            size_t diferencias = texto.diferenciasDesde(i, patronEmpaquetado, k);
+            if (diferencias <= k) {
+                return {static_cast<int>(i), static_cast<int>(diferencias)};
+            }
+        }
+        return {-1, -1};
+    }
+
+    // Cada semilla exacta propone un inicio; se verifica solo si mejora al encontrado
+    size_t mejor = std::numeric_limits<size_t>::max();
+    size_t mejorDistancia = 0;
+
+    semillas.buscarEn(texto, AhoCorasick::TODAS, [&](const CoincidenciaMultiple& semilla) {
+        size_t desplazamiento = inicioSemillas[semilla.patronId];
+        if (static_cast<size_t>(semilla.posicion) < desplazamiento) return;
+
+        size_t inicio = semilla.posicion - desplazamiento;
+        if (inicio > ultima || inicio >= mejor) return;
+
+        size_t diferencias = texto.diferenciasDesde(inicio, patronEmpaquetado, k);
+        if (diferencias <= k) {
+            mejor = inicio;
+            mejorDistancia = diferencias;
+        }
+    });
+
+    if (mejor == std::numeric_limits<size_t>::max()) {
+        return {-1, -1};
+    }
+    return {static_cast<int>(mejor), static_cast<int>(mejorDistancia)};
+}
+
+std::string BusquedaAproximada::toString(Distancia distancia) {
+    switch (distancia) {
+        case HAMMING:
+            return "hamming";
+        default:
+            return "edicion";
+    }
+}
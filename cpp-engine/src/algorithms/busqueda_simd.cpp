@@ -0,0 +1,373 @@
+#include "../../include/busqueda_simd.h"
+#include <cstring>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BUSQUEDA_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// GCC y Clang necesitan habilitar AVX2/SSE2 por función (el resto del
+// binario se compila sin ellas); MSVC acepta los intrínsecos sin banderas
+#if defined(__GNUC__) || defined(__clang__)
+#define OBJETIVO_AVX2 __attribute__((target("avx2")))
+#define OBJETIVO_SSE2 __attribute__((target("sse2")))
+#else
+#define OBJETIVO_AVX2
+#define OBJETIVO_SSE2
+#endif
+
+namespace {
+
+/**
+ * Posiciones de las anclas dentro del patrón y la base esperada en cada una
+ * (la primera y la última base siempre son anclas)
+ */
+struct Anclas {
+    size_t posicion[BusquedaSIMD::NUM_ANCLAS];
+    char base[BusquedaSIMD::NUM_ANCLAS];
+
+    explicit Anclas(std::string_view patron) {
+        size_t m = patron.length();
+        for (int k = 0; k < BusquedaSIMD::NUM_ANCLAS; k++) {
+            posicion[k] = k * (m - 1) / (BusquedaSIMD::NUM_ANCLAS - 1);
+            base[k] = patron[posicion[k]];
+        }
+    }
+};
+
+unsigned bitMenor(uint32_t mascara) {
+#ifdef _MSC_VER
+    unsigned long bit;
+    _BitScanForward(&bit, mascara);
+    return bit;
+#else
+    return __builtin_ctz(mascara);
+#endif
+}
+
+bool coincideEn(const char* texto, size_t i, std::string_view patron) {
+    return std::memcmp(texto + i, patron.data(), patron.length()) == 0;
+}
+
+// Revisa una a una las posiciones [desde, ultima]
+int buscarEscalar(const char* texto, size_t desde, size_t ultima,
+                  std::string_view patron, const Anclas& anclas) {
+    for (size_t i = desde; i <= ultima; i++) {
+        bool candidata = true;
+        for (int k = 0; k < BusquedaSIMD::NUM_ANCLAS && candidata; k++) {
+            candidata = texto[i + anclas.posicion[k]] == anclas.base[k];
+        }
+        if (candidata && coincideEn(texto, i, patron)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+/**
+ * Anclas de un patrón empaquetado: cada base esperada repetida en los 32
+ * campos de 2 bits de una palabra, para compararla contra 32 posiciones
+ */
+struct AnclasEmpaquetadas {
+    size_t posicion[BusquedaSIMD::NUM_ANCLAS];
+    uint64_t repetida[BusquedaSIMD::NUM_ANCLAS];
+
+    explicit AnclasEmpaquetadas(const SecuenciaEmpaquetada& patron) {
+        size_t m = patron.longitud();
+        for (int k = 0; k < BusquedaSIMD::NUM_ANCLAS; k++) {
+            posicion[k] = k * (m - 1) / (BusquedaSIMD::NUM_ANCLAS - 1);
+            repetida[k] = patron.base(posicion[k]) * 0x5555555555555555ULL;
+        }
+    }
+};
+
+const uint64_t BITS_PARES = 0x5555555555555555ULL;
+
+/**
+ * Verifica en orden las posiciones de inicio marcadas (bit 2t = inicio + t)
+ */
+int verificarCandidatas(const SecuenciaEmpaquetada& texto, size_t inicio, uint64_t candidatas,
+                        const SecuenciaEmpaquetada& patron) {
+    while (candidatas != 0) {
+        size_t posicion = inicio + SecuenciaEmpaquetada::primeraDiferencia(candidatas);
+        if (texto.coincidenciaDesde(posicion, patron) == patron.longitud()) {
+            return static_cast<int>(posicion);
+        }
+        candidatas &= candidatas - 1;
+    }
+    return -1;
+}
+
+// Bloques de 32 posiciones [desde, ultima] con una palabra por ancla (SWAR):
+// un campo de la XOR es cero donde el texto tiene la base del ancla
+int buscarEmpaquetadoEscalar(const SecuenciaEmpaquetada& texto, size_t desde, size_t ultima,
+                             const SecuenciaEmpaquetada& patron, const AnclasEmpaquetadas& anclas) {
+    for (size_t i = desde; i <= ultima; i += 32) {
+        uint64_t candidatas = BITS_PARES;
+        for (int k = 0; k < BusquedaSIMD::NUM_ANCLAS && candidatas != 0; k++) {
+            uint64_t diferencia = texto.ventana(i + anclas.posicion[k]) ^ anclas.repetida[k];
+            candidatas &= ~(diferencia | (diferencia >> 1));
+        }
+
+        // Último bloque: solo hasta la última posición de inicio
+        size_t restantes = ultima - i + 1;
+        if (restantes < 32) {
+            candidatas &= (1ULL << (2 * restantes)) - 1;
+        }
+
+        int encontrada = verificarCandidatas(texto, i, candidatas, patron);
+        if (encontrada != -1) {
+            return encontrada;
+        }
+    }
+    return -1;
+}
+
+#ifdef BUSQUEDA_SIMD_X86
+
+OBJETIVO_AVX2
+int buscarAVX2(const char* texto, size_t ultima, std::string_view patron, const Anclas& anclas) {
+    __m256i bases[BusquedaSIMD::NUM_ANCLAS];
+    for (int k = 0; k < BusquedaSIMD::NUM_ANCLAS; k++) {
+        bases[k] = _mm256_set1_epi8(anclas.base[k]);
+    }
+
+    // Bloques de 32 posiciones de inicio: la lectura más lejana es
+    // texto[i + 31 + (m - 1)] <= texto[n - 1]
+    size_t i = 0;
+    for (; i + 31 <= ultima; i += 32) {
+        __m256i iguales = _mm256_cmpeq_epi8(bases[0],
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(texto + i + anclas.posicion[0])));
+        for (int k = 1; k < BusquedaSIMD::NUM_ANCLAS; k++) {
+            iguales = _mm256_and_si256(iguales, _mm256_cmpeq_epi8(bases[k],
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(texto + i + anclas.posicion[k]))));
+        }
+
+        uint32_t candidatas = static_cast<uint32_t>(_mm256_movemask_epi8(iguales));
+        while (candidatas != 0) {
+            size_t posicion = i + bitMenor(candidatas);
+            if (coincideEn(texto, posicion, patron)) {
+                return static_cast<int>(posicion);
+            }
+            candidatas &= candidatas - 1;
+        }
+    }
+
+    return buscarEscalar(texto, i, ultima, patron, anclas);
+}
+
+OBJETIVO_SSE2
+int buscarSSE2(const char* texto, size_t ultima, std::string_view patron, const Anclas& anclas) {
+    __m128i bases[BusquedaSIMD::NUM_ANCLAS];
+    for (int k = 0; k < BusquedaSIMD::NUM_ANCLAS; k++) {
+        bases[k] = _mm_set1_epi8(anclas.base[k]);
+    }
+
+    size_t i = 0;
+    for (; i + 15 <= ultima; i += 16) {
+        __m128i iguales = _mm_cmpeq_epi8(bases[0],
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(texto + i + anclas.posicion[0])));
+        for (int k = 1; k < BusquedaSIMD::NUM_ANCLAS; k++) {
+            iguales = _mm_and_si128(iguales, _mm_cmpeq_epi8(bases[k],
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(texto + i + anclas.posicion[k]))));
+        }
+
+        uint32_t candidatas = static_cast<uint32_t>(_mm_movemask_epi8(iguales));
+        while (candidatas != 0) {
+            size_t posicion = i + bitMenor(candidatas);
+            if (coincideEn(texto, posicion, patron)) {
+                return static_cast<int>(posicion);
+            }
+            candidatas &= candidatas - 1;
+        }
+    }
+
+    return buscarEscalar(texto, i, ultima, patron, anclas);
+}
+
+/**
+ * Cuatro bloques de 32 posiciones por iteración: las ventanas de un ancla
+ * en bloques seguidos son palabras seguidas del texto, desplazadas lo mismo
+ */
+OBJETIVO_AVX2
+int buscarEmpaquetadoAVX2(const SecuenciaEmpaquetada& texto, size_t ultima,
+                          const SecuenciaEmpaquetada& patron, const AnclasEmpaquetadas& anclas) {
+    const uint64_t* palabras = texto.datos();
+    const __m256i pares = _mm256_set1_epi64x(static_cast<long long>(BITS_PARES));
+
+    // La lectura más lejana es la palabra siguiente a la de la base
+    // i + 127 + (m - 1) <= n - 1, que existe (la de relleno como mucho)
+    size_t i = 0;
+    for (; i + 127 <= ultima; i += 128) {
+        __m256i candidatas = pares;
+        for (int k = 0; k < BusquedaSIMD::NUM_ANCLAS; k++) {
+            size_t base = i + anclas.posicion[k];
+            const uint64_t* desde = palabras + (base >> 5);
+            unsigned desplazamiento = (base & 31) * 2;
+
+            // Los desplazamientos de 64 bits dan 0: sirve también para desplazamiento 0
+            __m256i ventanas = _mm256_or_si256(
+                _mm256_srl_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(desde)),
+                                 _mm_cvtsi32_si128(desplazamiento)),
+                _mm256_sll_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(desde + 1)),
+                                 _mm_cvtsi32_si128(64 - desplazamiento)));
+            __m256i diferencia = _mm256_xor_si256(ventanas,
+                _mm256_set1_epi64x(static_cast<long long>(anclas.repetida[k])));
+            candidatas = _mm256_andnot_si256(_mm256_or_si256(diferencia, _mm256_srli_epi64(diferencia, 1)),
+                                             candidatas);
+        }
+
+        if (_mm256_testz_si256(candidatas, candidatas)) {
+            continue;
+        }
+        alignas(32) uint64_t porBloque[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(porBloque), candidatas);
+        for (int bloque = 0; bloque < 4; bloque++) {
+            int encontrada = verificarCandidatas(texto, i + 32 * bloque, porBloque[bloque], patron);
+            if (encontrada != -1) {
+                return encontrada;
+            }
+        }
+    }
+
+    return buscarEmpaquetadoEscalar(texto, i, ultima, patron, anclas);
+}
+
+// Igual que buscarEmpaquetadoAVX2, dos bloques por iteración
+OBJETIVO_SSE2
+int buscarEmpaquetadoSSE2(const SecuenciaEmpaquetada& texto, size_t ultima,
+                          const SecuenciaEmpaquetada& patron, const AnclasEmpaquetadas& anclas) {
+    const uint64_t* palabras = texto.datos();
+    const __m128i pares = _mm_set1_epi64x(static_cast<long long>(BITS_PARES));
+
+    size_t i = 0;
+    for (; i + 63 <= ultima; i += 64) {
+        __m128i candidatas = pares;
+        for (int k = 0; k < BusquedaSIMD::NUM_ANCLAS; k++) {
+            size_t base = i + anclas.posicion[k];
+            const uint64_t* desde = palabras + (base >> 5);
+            unsigned desplazamiento = (base & 31) * 2;
+
+            __m128i ventanas = _mm_or_si128(
+                _mm_srl_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(desde)),
+                              _mm_cvtsi32_si128(desplazamiento)),
+                _mm_sll_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(desde + 1)),
+                              _mm_cvtsi32_si128(64 - desplazamiento)));
+            __m128i diferencia = _mm_xor_si128(ventanas,
+                _mm_set1_epi64x(static_cast<long long>(anclas.repetida[k])));
+            candidatas = _mm_andnot_si128(_mm_or_si128(diferencia, _mm_srli_epi64(diferencia, 1)),
+                                          candidatas);
+        }
+
+        alignas(16) uint64_t porBloque[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(porBloque), candidatas);
+        for (int bloque = 0; bloque < 2; bloque++) {
+            int encontrada = verificarCandidatas(texto, i + 32 * bloque, porBloque[bloque], patron);
+            if (encontrada != -1) {
+                return encontrada;
+            }
+        }
+    }
+
+    return buscarEmpaquetadoEscalar(texto, i, ultima, patron, anclas);
+}
+
+#endif
+
+BusquedaSIMD::Instrucciones detectarInstrucciones() {
+#if defined(BUSQUEDA_SIMD_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maximo = info[0];
+
+    __cpuid(info, 1);
+    bool sse2 = (info[3] & (1 << 26)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+
+    // AVX2 requiere que el sistema operativo guarde los registros YMM
+    if (maximo >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6) {
+        __cpuidex(info, 7, 0);
+        if ((info[1] & (1 << 5)) != 0) {
+            return BusquedaSIMD::AVX2;
+        }
+    }
+    return sse2 ? BusquedaSIMD::SSE2 : BusquedaSIMD::ESCALAR;
+#elif defined(BUSQUEDA_SIMD_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return BusquedaSIMD::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return BusquedaSIMD::SSE2;
+    }
+    return BusquedaSIMD::ESCALAR;
+#else
+    return BusquedaSIMD::ESCALAR;
+#endif
+}
+
+}
+
+int BusquedaSIMD::buscar(std::string_view texto, std::string_view patron) {
+    size_t n = texto.length();
+    size_t m = patron.length();
+
+    // Caso especial: patrón vacío
+    if (m == 0) return 0;
+    if (m > n) return -1;
+
+    Anclas anclas(patron);
+    size_t ultima = n - m; // Última posición de inicio posible
+
+    switch (instruccionesDisponibles()) {
+#ifdef BUSQUEDA_SIMD_X86
+        case AVX2:
+            return buscarAVX2(texto.data(), ultima, patron, anclas);
+        case SSE2:
+            return buscarSSE2(texto.data(), ultima, patron, anclas);
+#endif
+        default:
+            return buscarEscalar(texto.data(), 0, ultima, patron, anclas);
+    }
+}
+
+int BusquedaSIMD::buscar(const SecuenciaEmpaquetada& texto, const SecuenciaEmpaquetada& patron) {
+    size_t n = texto.longitud();
+    size_t m = patron.longitud();
+
+    // Caso especial: patrón vacío
+    if (m == 0) return 0;
+    if (m > n) return -1;
+
+    AnclasEmpaquetadas anclas(patron);
+    size_t ultima = n - m; // Última posición de inicio posible
+
+    switch (instruccionesDisponibles()) {
+#ifdef BUSQUEDA_SIMD_X86
+        case AVX2:
+            return buscarEmpaquetadoAVX2(texto, ultima, patron, anclas);
+        case SSE2:
+            return buscarEmpaquetadoSSE2(texto, ultima, patron, anclas);
+#endif
+        default:
+            return buscarEmpaquetadoEscalar(texto, 0, ultima, patron, anclas);
+    }
+}
+
+BusquedaSIMD::Instrucciones BusquedaSIMD::instruccionesDisponibles() {
+    static const Instrucciones instrucciones = detectarInstrucciones();
+    return instrucciones;
+}
+
+std::string BusquedaSIMD::toString(Instrucciones instrucciones) {
+    switch (instrucciones) {
+        case AVX2:
+            return "avx2";
+        case SSE2:
+            return "sse2";
+        default:
+            return "escalar";
+    }
+}
@@ -1,6 +1,6 @@
 #include "../../include/kmp.h"
 
-int KMP::buscar(const std::string& texto, const std::string& patron) {
+int KMP::buscar(std::string_view texto, std::string_view patron) {
     int n = texto.length();
     int m = patron.length();
 
@@ -39,7 +39,39 @@ int KMP::buscar(const std::string& texto, const std::string& patron) {
     return -1; // No encontrado
 }
 
-std::vector<int> KMP::construirTablaLPS(const std::string& patron) {
+int KMP::buscar(const SecuenciaEmpaquetada& texto, const SecuenciaEmpaquetada& patron) {
+    size_t n = texto.longitud();
+    size_t m = patron.longitud();
+
+    // Caso especial: patrón vacío
+    if (m == 0) return 0;
+    if (m > n) return -1;
+
+    // Autómata KMP: cada base del texto se lee una sola vez, nunca se retrocede
+    std::vector<int> automata = construirAutomata(patron);
+
+    // Las bases se sacan de a 2 bits de cada palabra, sin reconstruir ventanas
+    const uint64_t* palabras = texto.datos();
+    size_t estado = 0;
+    for (size_t inicio = 0; inicio < n; inicio += 32) {
+        uint64_t palabra = palabras[inicio / 32];
+        size_t fin = n - inicio < 32 ? n : inicio + 32;
+
+        for (size_t i = inicio; i < fin; i++) {
+            estado = automata[estado * 4 + (palabra & 3)];
+            palabra >>= 2;
+
+            // Patrón encontrado
+            if (estado == m) {
+                return static_cast<int>(i + 1 - m);
+            }
+        }
+    }
+
+    return -1; // No encontrado
+}
+
+std::vector<int> KMP::construirTablaLPS(std::string_view patron) {
     int m = patron.length();
     std::vector<int> lps(m, 0);
 
@@ -63,3 +95,23 @@ std::vector<int> KMP::construirTablaLPS(const std::string& patron) {
 
     return lps;
 }
+
+std::vector<int> KMP::construirAutomata(const SecuenciaEmpaquetada& patron) {
+    size_t m = patron.longitud();
+    std::vector<int> automata(m * 4, 0);
+
+    // respaldo: estado al que lleva el texto leído sin su primera base
+    // (el mismo de la tabla LPS); desde él se copian las transiciones
+    // de las bases que no continúan el patrón
+    automata[patron.base(0)] = 1;
+    size_t respaldo = 0;
+    for (size_t j = 1; j < m; j++) {
+        for (int codigo = 0; codigo < 4; codigo++) {
+            automata[j * 4 + codigo] = automata[respaldo * 4 + codigo];
+        }
+        automata[j * 4 + patron.base(j)] = static_cast<int>(j + 1);
+        respaldo = automata[respaldo * 4 + patron.base(j)];
+    }
+
+    return automata;
+}
@@ -1,70 +1,280 @@
 #include "../../include/rabin_karp.h"
-#include <cmath>
+#include "../../include/cursor_bases.h"
+#include <random>
+#include <algorithm>
+#include <map>
 
-int RabinKarp::buscar(const std::string& texto, const std::string& patron) {
-    int n = texto.length();
-    int m = patron.length();
+namespace {
+
+/**
+ * Código 2-bit de un carácter; lo que no es base cuenta como G (3)
+ */
+inline uint64_t codigoHash(char c) {
+    return static_cast<uint64_t>(codigoBase(c)) & 3;
+}
+
+}
+
+uint64_t RabinKarp::base() {
+    static const uint64_t valor = []() {
+        std::random_device dispositivo;
+        std::mt19937_64 azar((static_cast<uint64_t>(dispositivo()) << 32) ^ dispositivo());
+        // Impar y lejos de las bases chicas (que dejan los bits altos en 0)
+        return azar() | (uint64_t(1) << 63) | 1;
+    }();
+    return valor;
+}
+
+uint64_t RabinKarp::potencia(size_t exponente) {
+    uint64_t resultado = 1;
+    uint64_t factor = base();
+    while (exponente > 0) {
+        if (exponente & 1) resultado *= factor;
+        factor *= factor;
+        exponente >>= 1;
+    }
+    return resultado;
+}
+
+uint64_t RabinKarp::calcularHash(std::string_view str) {
+    const uint64_t b = base();
+    uint64_t hash = 0;
+    for (char c : str) {
+        hash = hash * b + codigoHash(c);
+    }
+    return hash;
+}
+
+int RabinKarp::buscar(std::string_view texto, std::string_view patron, uint64_t* colisiones) {
+    size_t n = texto.length();
+    size_t m = patron.length();
 
     // Casos especiales
     if (m == 0) return 0;
     if (m > n) return -1;
 
-    // Calcular hash del patrón
-    long long hashPatron = calcularHash(patron, m);
-    long long hashTexto = calcularHash(texto, m);
+    // Hash del patrón y de la primera ventana
+    const uint64_t b = base();
+    uint64_t hashPatron = calcularHash(patron);
+    uint64_t hashTexto = calcularHash(texto.substr(0, m));
 
-    // Calcular BASE^(m-1) mod PRIMO para rolling hash
-    long long h = 1;
-    for (int i = 0; i < m - 1; i++) {
-        h = (h * BASE) % PRIMO;
-    }
+    // base^m: lo que pesa la base que sale después de multiplicar
+    uint64_t potenciaSaliente = potencia(m);
 
     // Deslizar el patrón sobre el texto
-    for (int i = 0; i <= n - m; i++) {
-        // Verificar si los hashes coinciden
+    for (size_t i = 0; ; i++) {
+        // Verificar si los hashes coinciden (y descartar colisiones)
         if (hashPatron == hashTexto) {
-            // Verificación carácter por carácter (para evitar colisiones)
-            bool coincide = true;
-            for (int j = 0; j < m; j++) {
-                if (texto[i + j] != patron[j]) {
-                    coincide = false;
-                    break;
-                }
+            if (texto.compare(i, m, patron) == 0) {
+                return i; // Patrón encontrado
             }
+            if (colisiones != nullptr) ++*colisiones;
+        }
+
+        if (i + m == n) {
+            break;
+        }
+
+        // Rolling hash: entra texto[i + m], sale texto[i]
+        hashTexto = hashTexto * b + codigoHash(texto[i + m]) - codigoHash(texto[i]) * potenciaSaliente;
+    }
+
+    return -1; // No encontrado
+}
+
+int RabinKarp::buscar(const SecuenciaEmpaquetada& texto, const SecuenciaEmpaquetada& patron, uint64_t* colisiones) {
+    size_t n = texto.longitud();
+    size_t m = patron.longitud();
 
-            if (coincide) {
+    // Casos especiales
+    if (m == 0) return 0;
+    if (m > n) return -1;
+
+    // Hash del patrón y de la primera ventana (mismos códigos que el texto)
+    const uint64_t b = base();
+    uint64_t hashPatron = 0;
+    uint64_t hashTexto = 0;
+    for (size_t i = 0; i < m; i++) {
+        hashPatron = hashPatron * b + patron.base(i);
+        hashTexto = hashTexto * b + texto.base(i);
+    }
+
+    uint64_t potenciaSaliente = potencia(m);
+
+    // Palabras con las próximas 32 bases que salen y entran de la ventana
+    uint64_t salientes = 0;
+    uint64_t entrantes = 0;
+
+    for (size_t i = 0; i + m <= n; i++) {
+        // Verificar si los hashes coinciden (verificación por palabras)
+        if (hashPatron == hashTexto) {
+            if (texto.coincidenciaDesde(i, patron) == m) {
                 return i; // Patrón encontrado
             }
+            if (colisiones != nullptr) ++*colisiones;
         }
 
-        // Calcular hash para la siguiente ventana (rolling hash)
-        if (i < n - m) {
-            hashTexto = (BASE * (hashTexto - charToInt(texto[i]) * h) + charToInt(texto[i + m])) % PRIMO;
+        if (i + m == n) {
+            break;
+        }
 
-            // Asegurar que el hash sea positivo
-            if (hashTexto < 0) {
-                hashTexto += PRIMO;
-            }
+        // Recargar una palabra cada 32 bases
+        if ((i & 31) == 0) {
+            salientes = texto.ventana(i);
+            entrantes = texto.ventana(i + m);
         }
+
+        uint64_t sale = salientes & 3;
+        uint64_t entra = entrantes & 3;
+        salientes >>= 2;
+        entrantes >>= 2;
+
+        hashTexto = hashTexto * b + entra - sale * potenciaSaliente;
     }
 
     return -1; // No encontrado
 }
 
-long long RabinKarp::calcularHash(const std::string& str, int longitud) {
-    long long hash = 0;
-    for (int i = 0; i < longitud; i++) {
-        hash = (hash * BASE + charToInt(str[i])) % PRIMO;
+RabinKarpMultiple::RabinKarpMultiple(const std::vector<std::string>& patrones) : patrones(patrones) {
+    // Agrupar por longitud, de la mayor a la menor: en una misma posición
+    // final gana el patrón más largo. Como en AhoCorasick, los patrones con
+    // caracteres fuera de A, C, G, T nunca coinciden
+    std::map<size_t, std::vector<int>, std::greater<size_t>> porLongitud;
+    for (size_t id = 0; id < patrones.size(); id++) {
+        const std::string& patron = patrones[id];
+        bool valido = !patron.empty() &&
+            std::all_of(patron.begin(), patron.end(), [](char c) { return codigoBase(c) != -1; });
+
+        patronesEmpaquetados.emplace_back(valido ? std::string_view(patron) : std::string_view());
+        if (valido) {
+            porLongitud[patron.length()].push_back(id);
+        }
+    }
+
+    for (const auto& entrada : porLongitud) {
+        Grupo grupo;
+        grupo.longitud = entrada.first;
+        grupo.potencia = RabinKarp::potencia(entrada.first);
+
+        // Al menos el doble de ranuras que patrones (carga <= 50%)
+        size_t ranuras = 2;
+        int bits = 1;
+        while (ranuras < 2 * entrada.second.size()) {
+            ranuras <<= 1;
+            bits++;
+        }
+        grupo.desplazamiento = 64 - bits;
+        grupo.claves.assign(ranuras, 0);
+        grupo.ids.assign(ranuras, -1);
+
+        // Filtro: 64 bits por patrón, al menos 4096
+        size_t bitsFiltro = 4096;
+        int log2Filtro = 12;
+        while (bitsFiltro < 64 * entrada.second.size()) {
+            bitsFiltro <<= 1;
+            log2Filtro++;
+        }
+        grupo.desplazamientoFiltro = 64 - log2Filtro;
+        grupo.filtro.assign(bitsFiltro / 64, 0);
+
+        // Sondeo lineal. Se insertan por patronId creciente, así en una
+        // cadena de claves iguales el de menor índice aparece primero
+        for (int id : entrada.second) {
+            uint64_t hash = RabinKarp::calcularHash(patrones[id]);
+            size_t ranura = hash >> grupo.desplazamiento;
+            while (grupo.ids[ranura] != -1) {
+                ranura = (ranura + 1) & (ranuras - 1);
+            }
+            grupo.claves[ranura] = hash;
+            grupo.ids[ranura] = id;
+
+            size_t bit = hash >> grupo.desplazamientoFiltro;
+            grupo.filtro[bit >> 6] |= uint64_t(1) << (bit & 63);
+        }
+
+        grupos.push_back(std::move(grupo));
     }
-    return hash;
 }
 
-int RabinKarp::charToInt(char c) {
-    switch (c) {
-        case 'A': return 0;
-        case 'T': return 1;
-        case 'C': return 2;
-        case 'G': return 3;
-        default: return 0; // Por si acaso, aunque no debería pasar
+template <typename CrearCursor, typename Verificar>
+bool RabinKarpMultiple::recorrer(
+    CrearCursor cursorEn,
+    size_t n,
+    Verificar verificar,
+    CoincidenciaMultiple& coincidencia,
+    uint64_t* colisiones
+) const {
+    const uint64_t b = RabinKarp::base();
+    size_t mejorFin = n + 1;  // Fin (exclusivo) de la mejor coincidencia hasta ahora
+    bool encontrada = false;
+
+    // Del patrón más largo al más corto: una ventana más corta solo gana si
+    // termina antes (a igual final ya ganó la más larga)
+    for (const Grupo& grupo : grupos) {
+        const size_t longitud = grupo.longitud;
+        if (longitud >= mejorFin || longitud > n) continue;
+        const size_t ultimoInicio = std::min(n, mejorFin - 1) - longitud;
+
+        auto entra = cursorEn(0);
+        auto sale = cursorEn(0);
+        uint64_t hash = 0;
+        for (size_t i = 0; i < longitud; i++) {
+            hash = hash * b + (static_cast<uint64_t>(entra.siguiente()) & 3);
+        }
+
+        const uint64_t* filtro = grupo.filtro.data();
+        const int desplazamientoFiltro = grupo.desplazamientoFiltro;
+        const uint64_t potencia = grupo.potencia;
+        const size_t mascara = grupo.ids.size() - 1;
+
+        for (size_t inicio = 0; ; inicio++) {
+            size_t bit = hash >> desplazamientoFiltro;
+            if ((filtro[bit >> 6] >> (bit & 63)) & 1) {
+                // Sondeo lineal: a igual clave, primero el de menor índice
+                int id = -1;
+                for (size_t ranura = hash >> grupo.desplazamiento; grupo.ids[ranura] != -1;
+                     ranura = (ranura + 1) & mascara) {
+                    if (grupo.claves[ranura] == hash) {
+                        if (verificar(inicio, grupo.ids[ranura])) {
+                            id = grupo.ids[ranura];
+                            break;
+                        }
+                        if (colisiones != nullptr) ++*colisiones;
+                    }
+                }
+                if (id != -1) {
+                    coincidencia.patronId = id;
+                    coincidencia.posicion = inicio;
+                    mejorFin = inicio + longitud;
+                    encontrada = true;
+                    break;
+                }
+            }
+
+            if (inicio == ultimoInicio) break;
+
+            // Rolling hash: entra la base inicio + longitud, sale la base inicio
+            hash = hash * b + (static_cast<uint64_t>(entra.siguiente()) & 3)
+                 - (static_cast<uint64_t>(sale.siguiente()) & 3) * potencia;
+        }
     }
+
+    return encontrada;
+}
+
+bool RabinKarpMultiple::buscarPrimera(std::string_view texto, CoincidenciaMultiple& coincidencia,
+                                      uint64_t* colisiones) const {
+    auto cursorEn = [&](size_t posicion) { return CursorTexto{texto.data() + posicion}; };
+    return recorrer(cursorEn, texto.length(), [&](size_t posicion, int id) {
+        return texto.compare(posicion, patrones[id].length(), patrones[id]) == 0;
+    }, coincidencia, colisiones);
+}
+
+bool RabinKarpMultiple::buscarPrimera(const SecuenciaEmpaquetada& texto, CoincidenciaMultiple& coincidencia,
+                                      uint64_t* colisiones) const {
+    auto cursorEn = [&](size_t posicion) { return CursorEmpaquetado{texto, posicion, texto.ventana(posicion)}; };
+    return recorrer(cursorEn, texto.longitud(), [&](size_t posicion, int id) {
+        const SecuenciaEmpaquetada& patron = patronesEmpaquetados[id];
+        return texto.coincidenciaDesde(posicion, patron) == patron.longitud();
+    }, coincidencia, colisiones);
 }
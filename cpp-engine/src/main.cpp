@@ -3,238 +3,977 @@
 #include <vector>
 #include <string>
 #include <sstream>
+#include <map>
 #include <set>
-#include "../include/kmp.h"
-#include "../include/rabin_karp.h"
-#include "../include/aho_corasick.h"
+#include <memory>
 #include "../include/csv_parser.h"
-#include "../include/algorithm_selector.h"
 #include "../include/json_output.h"
+#include "../include/motor_busqueda.h"
+#include "../include/servidor.h"
+#include "../include/pool_hilos.h"
+#include "../include/base_datos_binaria.h"
+#include "../include/almacen_sospechosos.h"
+#include "../include/indice_kmers.h"
+#include "../include/indice_fm.h"
+#include "../include/huella_base.h"
+#include "../include/perfil_costos.h"
+#include "../include/salida_ndjson.h"
+#include "../include/lote_consultas.h"
+#include "../include/metricas.h"
+#include "../include/traza.h"
+#include <cstdlib>
+#include <cstdint>
+#include <fstream>
 using namespace std;
 
+const string USO =
+    "Uso: ./busqueda_adn <patron1[,patron2,...]> <ruta_csv|ruta_adnb> [--threads N] [--empaquetado]\n"
+    "                    [--max-errors k [--distance edit|hamming]] [--index <ruta_adnk>]\n"
+    "                    [--profile <ruta_perfil>] [--stream] [--trace off|info|debug]\n"
+    "                    [--split-threshold B] [--both-strands] [--max-memory MB]\n"
+    "     ./busqueda_adn --servidor <ruta_csv|ruta_adnb> [--socket <ruta_socket>] [--threads N]\n"
+    "                    [--max-errors k [--distance edit|hamming]] [--profile <ruta_perfil>]\n"
+    "                    [--cache-mb M] [--split-threshold B] [--both-strands]\n"
+    "     ./busqueda_adn --batch <consultas.jsonl> <ruta_csv|ruta_adnb> [--threads N] [--empaquetado]\n"
+    "                    [--max-errors k [--distance edit|hamming]] [--profile <ruta_perfil>]\n"
+    "                    [--both-strands]\n"
+    "     ./busqueda_adn --build-db <ruta_csv> -o <ruta_adnb> [--empaquetado]\n"
+    "     ./busqueda_adn --build-index <ruta_csv|ruta_adnb> -o <ruta_adnk>\n"
+    "     ./busqueda_adn --build-fm <ruta_csv|ruta_adnb> [-o <ruta_fm>]   (por defecto <ruta_base>.fm)\n"
+    "     ./busqueda_adn --calibrate -o <ruta_perfil>";
+
+/**
+ * Argumentos de línea de comandos separados en posicionales y opciones
+ */
+struct Argumentos {
+    vector<string> posicionales;
+    map<string, string> opciones;   // --opcion valor
+    set<string> banderas;           // --bandera (sin valor)
+};
+
+// Opciones que no llevan valor
+const set<string> BANDERAS = {"--servidor", "--empaquetado", "--calibrate", "--stream", "--both-strands"};
+
+// Opciones que llevan valor ("-o" es la única corta)
+const set<string> OPCIONES = {
+    "--threads", "--max-errors", "--distance", "--index", "--profile", "--trace",
+    "--split-threshold", "--max-memory", "--socket", "--cache-mb",
+    "--batch", "--build-db", "--build-index", "--build-fm", "-o"
+};
+
+// Modos en el orden en que main los elige; sin ninguno es una búsqueda
+const vector<string> MODOS = {"--servidor", "--batch", "--build-db", "--build-index", "--build-fm", "--calibrate"};
+
+// Opciones y banderas que lee cada modo ("" = búsqueda). --trace vale en todos
+const map<string, set<string>> OPCIONES_POR_MODO = {
+    {"", {"--threads", "--empaquetado", "--max-errors", "--distance", "--index", "--profile",
+          "--stream", "--split-threshold", "--both-strands", "--max-memory", "--trace"}},
+    {"--servidor", {"--servidor", "--socket", "--threads", "--max-errors", "--distance", "--profile",
+                    "--cache-mb", "--split-threshold", "--both-strands", "--trace"}},
+    {"--batch", {"--batch", "--threads", "--empaquetado", "--max-errors", "--distance", "--profile",
+                 "--both-strands", "--trace"}},
+    {"--build-db", {"--build-db", "-o", "--empaquetado", "--trace"}},
+    {"--build-index", {"--build-index", "-o", "--trace"}},
+    {"--build-fm", {"--build-fm", "-o", "--trace"}},
+    {"--calibrate", {"--calibrate", "-o", "--trace"}}
+};
+
+/**
+ * Separa argv en posicionales, opciones con valor y banderas
+ * @throws ErrorBusqueda si una opción no existe o no tiene valor
+ */
+Argumentos parsearArgumentos(int argc, char* argv[]) {
+    Argumentos args;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+
+        // Ni un patrón ni una ruta empiezan con '-': es una opción (quizás mal escrita)
+        if (arg.length() < 2 || arg[0] != '-') {
+            args.posicionales.push_back(arg);
+        } else if (BANDERAS.count(arg)) {
+            args.banderas.insert(arg);
+        } else if (!OPCIONES.count(arg)) {
+            throw ErrorBusqueda("Opción desconocida: " + arg, "INVALID_ARGUMENTS", USO);
+        } else if (i + 1 < argc) {
+            args.opciones[arg] = argv[++i];
+        } else {
+            throw ErrorBusqueda("La opción " + arg + " requiere un valor", "INVALID_ARGUMENTS", USO);
+        }
+    }
 
-vector<string> dividirPorComa(const string& str) {
-    vector<string> resultado;
-    stringstream ss(str);
-    string item;
+    return args;
+}
 
-    while (getline(ss, item, ',')) {
-        // Eliminar espacios en blanco, tabs, retornos de carro y saltos de línea
-        size_t inicio = item.find_first_not_of(" \t\r\n");
-        size_t fin = item.find_last_not_of(" \t\r\n");
+/**
+ * Rechaza las opciones que el modo elegido no lee (ej: --socket o
+ * --cache-mb en una búsqueda, o dos modos a la vez) en lugar de ignorarlas
+ * @throws ErrorBusqueda con la primera opción que el modo no usa
+ */
+void validarOpcionesDelModo(const Argumentos& args) {
+    string modo;
+    for (const string& candidato : MODOS) {
+        if (args.banderas.count(candidato) || args.opciones.count(candidato)) {
+            modo = candidato;
+            break;
+        }
+    }
 
-        if (inicio != string::npos && fin != string::npos) {
-            resultado.push_back(item.substr(inicio, fin - inicio + 1));
+    const set<string>& permitidas = OPCIONES_POR_MODO.at(modo);
+    string descripcion = modo.empty() ? "la búsqueda" : modo;
+    auto rechazar = [&](const string& opcion) {
+        if (!permitidas.count(opcion)) {
+            throw ErrorBusqueda("La opción " + opcion + " no se usa con " + descripcion,
+                                "INVALID_ARGUMENTS", USO);
         }
+    };
+
+    for (const string& bandera : args.banderas) {
+        rechazar(bandera);
+    }
+    for (const auto& opcion : args.opciones) {
+        rechazar(opcion.first);
+    }
+}
+
+/**
+ * Lee --threads N (0 = todos los núcleos). Por defecto 1 hilo.
+ * @throws ErrorBusqueda si el valor no es un entero válido
+ */
+int leerNumHilos(const Argumentos& args) {
+    auto it = args.opciones.find("--threads");
+    if (it == args.opciones.end()) {
+        return 1;
     }
 
-    return resultado;
+    int numHilos = -1;
+    try {
+        size_t leidos = 0;
+        numHilos = stoi(it->second, &leidos);
+        if (leidos != it->second.length()) numHilos = -1;
+    } catch (const exception&) {
+        numHilos = -1;
+    }
+
+    if (numHilos < 0) {
+        throw ErrorBusqueda("Número de hilos inválido: " + it->second, "INVALID_ARGUMENTS",
+                            "--threads debe ser un entero >= 0 (0 = todos los núcleos)");
+    }
+
+    return numHilos == 0 ? PoolHilos::hilosDisponibles() : numHilos;
 }
 
-int main(int argc, char* argv[]) {
-    // Validar argumentos
-    if (argc != 3) {
-        string error = JSONOutput::generarError(
-            "Argumentos insuficientes",
+/**
+ * Lee --split-threshold B: con varios hilos, las cadenas de al menos B
+ * bases se recorren en tramos paralelos (0 = nunca)
+ * @throws ErrorBusqueda si el valor no es un entero válido
+ */
+void leerUmbralDivision(const Argumentos& args, OpcionesBusqueda& opciones) {
+    auto it = args.opciones.find("--split-threshold");
+    if (it == args.opciones.end()) {
+        return;
+    }
+
+    long long bases = -1;
+    try {
+        size_t leidos = 0;
+        bases = stoll(it->second, &leidos);
+        if (leidos != it->second.length()) bases = -1;
+    } catch (const exception&) {
+        bases = -1;
+    }
+
+    if (bases < 0) {
+        throw ErrorBusqueda("Umbral de división inválido: " + it->second, "INVALID_ARGUMENTS",
+                            "--split-threshold debe ser un entero >= 0 (0 = no dividir cadenas)");
+    }
+    opciones.umbralDivision = static_cast<size_t>(bases);
+}
+
+/**
+ * Lee --max-errors k y --distance edit|hamming (por defecto edit).
+ * Sin --max-errors la búsqueda es exacta.
+ * @throws ErrorBusqueda si algún valor no es válido
+ */
+void leerTolerancia(const Argumentos& args, OpcionesBusqueda& opciones) {
+    auto it = args.opciones.find("--max-errors");
+    if (it != args.opciones.end()) {
+        int maxErrores = -1;
+        try {
+            size_t leidos = 0;
+            maxErrores = stoi(it->second, &leidos);
+            if (leidos != it->second.length()) maxErrores = -1;
+        } catch (const exception&) {
+            maxErrores = -1;
+        }
+
+        if (maxErrores < 0) {
+            throw ErrorBusqueda("Número máximo de errores inválido: " + it->second, "INVALID_ARGUMENTS",
+                                "--max-errors debe ser un entero >= 0");
+        }
+        opciones.maxErrores = maxErrores;
+    }
+
+    auto distancia = args.opciones.find("--distance");
+    if (distancia != args.opciones.end()) {
+        if (distancia->second == "edit") {
+            opciones.distancia = BusquedaAproximada::EDICION;
+        } else if (distancia->second == "hamming") {
+            opciones.distancia = BusquedaAproximada::HAMMING;
+        } else {
+            throw ErrorBusqueda("Distancia desconocida: " + distancia->second, "INVALID_ARGUMENTS",
+                                "--distance debe ser edit o hamming");
+        }
+    }
+}
+
+/**
+ * Construye la base binaria: busqueda_adn --build-db <ruta_csv> -o <ruta_adnb>
+ */
+int construirBaseDatos(const Argumentos& args) {
+    auto salida = args.opciones.find("-o");
+    if (salida == args.opciones.end() || !args.posicionales.empty()) {
+        cout << JSONOutput::generarError(
+            "Argumentos inválidos para --build-db",
             "INVALID_ARGUMENTS",
-            "Uso: ./busqueda_adn <patron1[,patron2,...]> <ruta_csv>"
-        );
-        cout << error << endl;
+            USO
+        ) << endl;
         return 1;
     }
 
-    string patronesInput = argv[1];
-    string rutaCSV = argv[2];
+    auto inicio = chrono::high_resolution_clock::now();
+    bool empaquetar = args.banderas.count("--empaquetado") > 0;
+
+    try {
+        size_t total = BaseDatosBinaria::construir(args.opciones.at("--build-db"), salida->second, empaquetar);
+
+        auto fin = chrono::high_resolution_clock::now();
+        auto duracion = chrono::duration_cast<chrono::milliseconds>(fin - inicio);
+
+        cout << JSONOutput::generarBaseConstruida(salida->second, total, empaquetar, duracion.count()) << endl;
+        return 0;
+
+    } catch (const exception& e) {
+        cout << JSONOutput::generarError(
+            "Error al construir la base binaria",
+            "FILE_ERROR",
+            string(e.what())
+        ) << endl;
+        return 1;
+    }
+}
+
+/**
+ * Construye el índice de k-mers: busqueda_adn --build-index <ruta_csv|ruta_adnb> -o <ruta_adnk>
+ */
+int construirIndice(const Argumentos& args) {
+    auto salida = args.opciones.find("-o");
+    if (salida == args.opciones.end() || !args.posicionales.empty()) {
+        cout << JSONOutput::generarError(
+            "Argumentos inválidos para --build-index",
+            "INVALID_ARGUMENTS",
+            USO
+        ) << endl;
+        return 1;
+    }
 
-    // Inicio del timer
     auto inicio = chrono::high_resolution_clock::now();
 
     try {
-        // DEBUG: Mostrar lo que recibimos
-        cerr << "[DEBUG] Argumento recibido (argv[1]): '" << patronesInput << "'" << endl;
-        cerr << "[DEBUG] Longitud: " << patronesInput.length() << endl;
-        cerr << "[DEBUG] Bytes (hex): ";
-        for (unsigned char c : patronesInput) {
-            cerr << hex << (int)c << " ";
-        }
-        cerr << dec << endl;
+        size_t numKmers = IndiceKmers::construir(args.opciones.at("--build-index"), salida->second);
 
-        // Parsear patrones (pueden ser múltiples separados por coma)
-        vector<string> patrones = dividirPorComa(patronesInput);
+        auto fin = chrono::high_resolution_clock::now();
+        auto duracion = chrono::duration_cast<chrono::milliseconds>(fin - inicio);
 
-        // DEBUG: Mostrar patrones parseados
-        cerr << "[DEBUG] Patrones parseados: " << patrones.size() << endl;
-        for (size_t i = 0; i < patrones.size(); i++) {
-            cerr << "[DEBUG] Patron " << i << ": '" << patrones[i] << "' (len=" << patrones[i].length() << ")" << endl;
-            cerr << "[DEBUG] Bytes: ";
-            for (unsigned char c : patrones[i]) {
-                cerr << hex << (int)c << " ";
-            }
-            cerr << dec << endl;
+        cout << JSONOutput::generarIndiceConstruido(salida->second, numKmers, duracion.count()) << endl;
+        return 0;
+
+    } catch (const exception& e) {
+        cout << JSONOutput::generarError(
+            "Error al construir el índice de k-mers",
+            "FILE_ERROR",
+            string(e.what())
+        ) << endl;
+        return 1;
+    }
+}
+
+/**
+ * Construye el índice FM: busqueda_adn --build-fm <ruta_csv|ruta_adnb> [-o <ruta_fm>]
+ * Sin -o se guarda junto a la base, donde la búsqueda lo encuentra sola
+ */
+int construirIndiceFM(const Argumentos& args) {
+    if (!args.posicionales.empty()) {
+        cout << JSONOutput::generarError(
+            "Argumentos inválidos para --build-fm",
+            "INVALID_ARGUMENTS",
+            USO
+        ) << endl;
+        return 1;
+    }
+
+    string rutaBase = args.opciones.at("--build-fm");
+    auto salida = args.opciones.find("-o");
+    string rutaSalida = salida != args.opciones.end() ? salida->second : IndiceFM::rutaPara(rutaBase);
+
+    auto inicio = chrono::high_resolution_clock::now();
+
+    try {
+        size_t total = IndiceFM::construir(rutaBase, rutaSalida);
+
+        auto fin = chrono::high_resolution_clock::now();
+        auto duracion = chrono::duration_cast<chrono::milliseconds>(fin - inicio);
+
+        cout << JSONOutput::generarIndiceFMConstruido(rutaSalida, total, duracion.count()) << endl;
+        return 0;
+
+    } catch (const exception& e) {
+        cout << JSONOutput::generarError(
+            "Error al construir el índice FM",
+            "FILE_ERROR",
+            string(e.what())
+        ) << endl;
+        return 1;
+    }
+}
+
+/**
+ * Calibra el modelo de costos: busqueda_adn --calibrate -o <ruta_perfil>
+ * Mide los motores en esta máquina y guarda los coeficientes
+ */
+int calibrarPerfil(const Argumentos& args) {
+    auto salida = args.opciones.find("-o");
+    if (salida == args.opciones.end() || !args.posicionales.empty()) {
+        cout << JSONOutput::generarError(
+            "Argumentos inválidos para --calibrate",
+            "INVALID_ARGUMENTS",
+            USO
+        ) << endl;
+        return 1;
+    }
+
+    auto inicio = chrono::high_resolution_clock::now();
+
+    try {
+        PerfilCostos perfil = PerfilCostos::calibrar();
+        perfil.guardar(salida->second);
+
+        auto fin = chrono::high_resolution_clock::now();
+        auto duracion = chrono::duration_cast<chrono::milliseconds>(fin - inicio);
+
+        cout << JSONOutput::generarPerfilCalibrado(salida->second, duracion.count()) << endl;
+        return 0;
+
+    } catch (const exception& e) {
+        cout << JSONOutput::generarError(
+            "Error al guardar el perfil de costos",
+            "FILE_ERROR",
+            string(e.what())
+        ) << endl;
+        return 1;
+    }
+}
+
+/**
+ * Lee --profile <ruta> (o la variable BUSQUEDA_ADN_PERFIL). Sin perfil el
+ * selector usa los coeficientes por defecto.
+ * @return true si se cargó un perfil en 'perfil'
+ * @throws ErrorBusqueda si el archivo no existe o está mal formado
+ */
+bool leerPerfil(const Argumentos& args, PerfilCostos& perfil) {
+    string ruta;
+    auto it = args.opciones.find("--profile");
+    if (it != args.opciones.end()) {
+        ruta = it->second;
+    } else if (const char* variable = getenv("BUSQUEDA_ADN_PERFIL")) {
+        ruta = variable;
+    }
+    if (ruta.empty()) {
+        return false;
+    }
+
+    try {
+        perfil = PerfilCostos::cargar(ruta);
+        return true;
+    } catch (const exception& e) {
+        throw ErrorBusqueda("Error al leer el perfil de costos", "FILE_ERROR", string(e.what()));
+    }
+}
+
+/**
+ * Lee --trace off|info|debug (o la variable BUSQUEDA_ADN_TRAZA). Por
+ * defecto las trazas están apagadas.
+ * @throws ErrorBusqueda si el nivel no existe
+ */
+void leerTraza(const Argumentos& args) {
+    string nivel;
+    auto it = args.opciones.find("--trace");
+    if (it != args.opciones.end()) {
+        nivel = it->second;
+    } else if (const char* variable = getenv("BUSQUEDA_ADN_TRAZA")) {
+        nivel = variable;
+    }
+    if (nivel.empty()) {
+        return;
+    }
+
+    try {
+        Traza::configurar(Traza::leerNivel(nivel));
+    } catch (const exception&) {
+        throw ErrorBusqueda("Nivel de traza desconocido: " + nivel, "INVALID_ARGUMENTS",
+                            "--trace debe ser off, info o debug");
+    }
+}
+
+/**
+ * Bytes de un texto en hexadecimal ("41 54 ..."), para las trazas
+ */
+string bytesHex(const string& texto) {
+    ostringstream hex;
+    hex << std::hex;
+    for (unsigned char c : texto) {
+        hex << static_cast<int>(c) << " ";
+    }
+    return hex.str();
+}
+
+/**
+ * Huella de los sospechosos cargados (para validar los índices)
+ */
+template <typename TColeccion>
+HuellaBase calcularHuella(const TColeccion& sospechosos) {
+    HuellaBase huella;
+    for (const auto& sospechoso : sospechosos) {
+        huella.agregar(sospechoso.cadenaADN);
+    }
+    return huella;
+}
+
+HuellaBase calcularHuella(const AlmacenSospechosos& almacen) {
+    HuellaBase huella;
+    for (size_t i = 0; i < almacen.size(); i++) {
+        huella.agregar(almacen[i].cadenaADN);
+    }
+    return huella;
+}
+
+HuellaBase calcularHuella(const BaseDatosBinaria& base) {
+    HuellaBase huella;
+    for (size_t i = 0; i < base.size(); i++) {
+        if (base.empaquetada()) {
+            huella.agregar(base.registroEmpaquetado(i).cadenaADN);
+        } else {
+            huella.agregar(base.registro(i).cadenaADN);
         }
+    }
+    return huella;
+}
 
-        if (patrones.empty()) {
-            string error = JSONOutput::generarError(
-                "No se especificaron patrones",
-                "EMPTY_PATTERN",
-                "Debe proporcionar al menos un patrón de ADN"
-            );
-            cout << error << endl;
-            return 1;
+// Vuelve a leer el archivo: solo se paga si hay un índice que validar
+HuellaBase calcularHuella(const CSVPorLotes& csv) {
+    HuellaBase huella;
+    csv.recorrer([&](const vector<SospechosoVista>& lote, size_t) {
+        for (const auto& sospechoso : lote) {
+            huella.agregar(sospechoso.cadenaADN);
         }
+    });
+    return huella;
+}
 
-        // Validar todos los patrones
-        for (size_t i = 0; i < patrones.size(); i++) {
-            const string& patron = patrones[i];
+/**
+ * Lee --max-memory M: el CSV se lee y se busca de a lotes que caben en M
+ * MiB en lugar de cargarlo entero (0 = sin límite, si no se indica)
+ * @return Límite en bytes
+ * @throws ErrorBusqueda si el valor no es un entero positivo
+ */
+size_t leerMemoriaMaxima(const Argumentos& args) {
+    auto it = args.opciones.find("--max-memory");
+    if (it == args.opciones.end()) {
+        return 0;
+    }
 
-            cerr << "[DEBUG] Validando patron " << i << ": '" << patron << "'" << endl;
+    long megabytes = -1;
+    try {
+        size_t leidos = 0;
+        megabytes = stol(it->second, &leidos);
+        if (leidos != it->second.length()) megabytes = -1;
+    } catch (const exception&) {
+        megabytes = -1;
+    }
 
-            if (!CSVParser::validarCadenaADN(patron)) {
-                ostringstream msg;
-                msg << "Patrón " << (i + 1) << " inválido: \"" << patron << "\"";
-                string error = JSONOutput::generarError(
-                    msg.str(),
-                    "INVALID_PATTERN",
-                    "Los patrones solo pueden contener los caracteres A, T, C, G"
-                );
-                cout << error << endl;
-                return 1;
-            }
+    if (megabytes <= 0) {
+        throw ErrorBusqueda("Límite de memoria inválido: " + it->second, "INVALID_ARGUMENTS",
+                            "--max-memory debe ser un entero > 0 (MiB)");
+    }
 
-            if (patron.length() < 100 || patron.length() > 1000) {
-                ostringstream msg;
-                msg << "Patrón " << (i + 1) << " tiene longitud inválida: " << patron.length();
-                string error = JSONOutput::generarError(
-                    msg.str(),
-                    "INVALID_PATTERN_LENGTH",
-                    "Cada patrón debe tener entre 100 y 1000 caracteres"
-                );
-                cout << error << endl;
-                return 1;
-            }
+    return static_cast<size_t>(megabytes) << 20;
+}
+
+/**
+ * --max-memory solo se aplica a una búsqueda sobre un CSV sin
+ * --empaquetado: en cualquier otro caso se rechaza en lugar de ignorarlo
+ * (la base .adnb ya se abre con mmap sin copiarla; el modo lote, el
+ * servidor y --empaquetado cargan la base entera)
+ * @throws ErrorBusqueda si se combina con otro modo o con una base .adnb
+ */
+void validarMemoriaMaxima(const Argumentos& args) {
+    if (!args.opciones.count("--max-memory")) {
+        return;
+    }
+
+    string incompatible;
+    for (const char* bandera : {"--servidor", "--calibrate", "--empaquetado"}) {
+        if (args.banderas.count(bandera)) incompatible = bandera;
+    }
+    for (const char* opcion : {"--batch", "--build-db", "--build-index", "--build-fm"}) {
+        if (args.opciones.count(opcion)) incompatible = opcion;
+    }
+    if (!incompatible.empty()) {
+        throw ErrorBusqueda("--max-memory no se puede combinar con " + incompatible, "INVALID_ARGUMENTS",
+                            "--max-memory solo limita la búsqueda sobre un CSV sin --empaquetado");
+    }
+
+    if (args.posicionales.size() == 2 && BaseDatosBinaria::esRutaBinaria(args.posicionales[1])) {
+        throw ErrorBusqueda("--max-memory no se puede usar con una base .adnb", "INVALID_ARGUMENTS",
+                            "La base .adnb se mapea en memoria sin cargarla: no necesita límite");
+    }
+}
+
+/**
+ * Lee --cache-mb M del modo servidor (0 = sin caché de resultados)
+ * @return Presupuesto de la caché en bytes
+ * @throws ErrorBusqueda si el valor no es un entero válido
+ */
+size_t leerPresupuestoCache(const Argumentos& args) {
+    auto it = args.opciones.find("--cache-mb");
+    if (it == args.opciones.end()) {
+        return Servidor::PRESUPUESTO_CACHE_POR_DEFECTO;
+    }
+
+    long megabytes = -1;
+    try {
+        size_t leidos = 0;
+        megabytes = stol(it->second, &leidos);
+        if (leidos != it->second.length()) megabytes = -1;
+    } catch (const exception&) {
+        megabytes = -1;
+    }
+
+    if (megabytes < 0) {
+        throw ErrorBusqueda("Tamaño de caché inválido: " + it->second, "INVALID_ARGUMENTS",
+                            "--cache-mb debe ser un entero >= 0 (0 = sin caché)");
+    }
+
+    return static_cast<size_t>(megabytes) << 20;
+}
+
+/**
+ * Modo servidor: busqueda_adn --servidor <ruta_csv> [--socket <ruta>]
+ * Carga el CSV una vez y atiende consultas por stdin o socket Unix
+ */
+int ejecutarServidor(const Argumentos& args, const OpcionesBusqueda& opciones) {
+    if (args.posicionales.size() != 1) {
+        cout << JSONOutput::generarError(
+            "Argumentos inválidos para el modo servidor",
+            "INVALID_ARGUMENTS",
+            USO
+        ) << endl;
+        return 1;
+    }
+
+    size_t presupuestoCache;
+    try {
+        presupuestoCache = leerPresupuestoCache(args);
+    } catch (const ErrorBusqueda& e) {
+        cout << JSONOutput::generarError(e.what(), e.codigo, e.detalles) << endl;
+        return 1;
+    }
+
+    try {
+        Servidor servidor(args.posicionales[0], opciones, presupuestoCache);
+
+        auto socket = args.opciones.find("--socket");
+        if (socket != args.opciones.end()) {
+            servidor.atenderSocket(socket->second);
+        } else {
+            servidor.atenderStdin();
         }
+        return 0;
+
+    } catch (const exception& e) {
+        cout << JSONOutput::generarError(
+            "Error al iniciar el servidor",
+            "FILE_ERROR",
+            string(e.what())
+        ) << endl;
+        return 1;
+    }
+}
+
+/**
+ * Modo lote: busqueda_adn --batch <consultas.jsonl> <ruta_csv|ruta_adnb>
+ * Resuelve todas las consultas con una sola pasada por la base y escribe
+ * una línea JSON por consulta, en el orden del archivo. Una consulta
+ * inválida tiene su línea de error y no detiene a las demás.
+ */
+int ejecutarLote(const Argumentos& args, const OpcionesBusqueda& opciones) {
+    if (args.posicionales.size() != 1) {
+        cout << JSONOutput::generarError(
+            "Argumentos inválidos para --batch",
+            "INVALID_ARGUMENTS",
+            USO
+        ) << endl;
+        return 1;
+    }
+
+    auto inicio = chrono::high_resolution_clock::now();
+
+    vector<ConsultaLote> consultas;
+    try {
+        consultas = LoteConsultas::leer(args.opciones.at("--batch"));
+    } catch (const exception& e) {
+        cout << JSONOutput::generarError(
+            "Error al leer el archivo de consultas",
+            "FILE_ERROR",
+            string(e.what())
+        ) << endl;
+        return 1;
+    }
 
-        // Parsear archivo CSV
-        vector<Sospechoso> sospechosos;
+    // Cada consulta se valida por separado; solo las válidas van al motor
+    vector<vector<string>> validas;
+    vector<size_t> posicionValida(consultas.size(), SIZE_MAX);
+    vector<ErrorBusqueda> errores;
+    vector<size_t> posicionError(consultas.size(), SIZE_MAX);
+    for (size_t i = 0; i < consultas.size(); i++) {
+        if (!consultas[i].error.empty()) {
+            continue;
+        }
         try {
-            sospechosos = CSVParser::parsear(rutaCSV);
-        } catch (const exception& e) {
-            string error = JSONOutput::generarError(
-                "Error al leer archivo CSV",
-                "FILE_ERROR",
-                string(e.what())
-            );
-            cout << error << endl;
-            return 1;
+            MotorBusqueda::validarPatrones(consultas[i].patrones);
+            MotorBusqueda::validarOpciones(consultas[i].patrones, opciones);
+            posicionValida[i] = validas.size();
+            validas.push_back(consultas[i].patrones);
+        } catch (const ErrorBusqueda& e) {
+            posicionError[i] = errores.size();
+            errores.push_back(e);
         }
+    }
+
+    string rutaBase = args.posicionales[0];
+    bool binaria = BaseDatosBinaria::esRutaBinaria(rutaBase);
+    bool empaquetado = args.banderas.count("--empaquetado") > 0;
 
-        // Calcular longitud promedio de los patrones
-        int longitudTotal = 0;
-        for (const auto& patron : patrones) {
-            longitudTotal += patron.length();
+    vector<ResultadoBusqueda> resultados;
+    try {
+        if (!validas.empty()) {
+            if (binaria) {
+                BaseDatosBinaria base(rutaBase);
+                resultados = MotorBusqueda::ejecutarLote(validas, base, opciones);
+            } else if (empaquetado) {
+                resultados = MotorBusqueda::ejecutarLote(validas, AlmacenSospechosos(rutaBase), opciones);
+            } else {
+                CSVMapeado csv(rutaBase);
+                resultados = MotorBusqueda::ejecutarLote(validas, csv.sospechosos(), opciones);
+            }
         }
-        int longitudPromedioPatron = longitudTotal / patrones.size();
+    } catch (const exception& e) {
+        cout << JSONOutput::generarError(
+            binaria ? "Error al leer la base binaria" : "Error al leer archivo CSV",
+            "FILE_ERROR",
+            string(e.what())
+        ) << endl;
+        return 1;
+    }
 
-        int numPatrones = patrones.size();
-        int numSospechosos = sospechosos.size();
+    auto fin = chrono::high_resolution_clock::now();
+    auto duracion = chrono::duration_cast<chrono::milliseconds>(fin - inicio);
 
-        // Seleccionar algoritmo óptimo
-        AlgorithmSelector::Algorithm algoritmoSeleccionado =
-            AlgorithmSelector::seleccionar(numPatrones, longitudPromedioPatron, numSospechosos);
+    for (size_t i = 0; i < consultas.size(); i++) {
+        const ConsultaLote& consulta = consultas[i];
+        if (!consulta.error.empty()) {
+            cout << JSONOutput::generarErrorLote(consulta.id, "Consulta inválida", "INVALID_QUERY", consulta.error) << '\n';
+        } else if (posicionError[i] != SIZE_MAX) {
+            const ErrorBusqueda& e = errores[posicionError[i]];
+            cout << JSONOutput::generarErrorLote(consulta.id, e.what(), e.codigo, e.detalles) << '\n';
+        } else {
+            const ResultadoBusqueda& resultado = resultados[posicionValida[i]];
+            cout << JSONOutput::generarResultadoLote(
+                consulta.id,
+                consulta.patrones,
+                resultado.algoritmo,
+                resultado.criterio,
+                resultado.totalProcesados,
+                resultado.coincidencias,
+                duracion.count()
+            ) << '\n';
+        }
+    }
+    cout << flush;
+    return 0;
+}
 
-        string nombreAlgoritmo = AlgorithmSelector::toString(algoritmoSeleccionado);
-        string criterioSeleccion = AlgorithmSelector::obtenerCriterio(
-            algoritmoSeleccionado, numPatrones, longitudPromedioPatron, numSospechosos
-        );
+int main(int argc, char* argv[]) {
+    Cronometro cronometro;
+    Metricas metricas;
+    Argumentos args;
+    OpcionesBusqueda opciones;
+    PerfilCostos perfil;
+    size_t memoriaMaxima = 0;
+
+    try {
+        args = parsearArgumentos(argc, argv);
+        leerTraza(args);
+        opciones.numHilos = leerNumHilos(args);
+        memoriaMaxima = leerMemoriaMaxima(args);
+        validarMemoriaMaxima(args);
+        validarOpcionesDelModo(args);
+        leerUmbralDivision(args, opciones);
+        leerTolerancia(args, opciones);
+        opciones.ambasHebras = args.banderas.count("--both-strands") > 0;
+        if (leerPerfil(args, perfil)) {
+            opciones.perfil = &perfil;
+        }
+    } catch (const ErrorBusqueda& e) {
+        cout << JSONOutput::generarError(e.what(), e.codigo, e.detalles) << endl;
+        return 1;
+    }
 
-        // Buscar coincidencias en todos los sospechosos
-        vector<Coincidencia> coincidencias;
-        set<string> cedulasEncontradas;  // Para evitar duplicados
+    if (args.banderas.count("--servidor")) {
+        return ejecutarServidor(args, opciones);
+    }
 
-        if (numPatrones >= 2) {
-            // CASO: MÚLTIPLES PATRONES → Usar Aho-Corasick (búsqueda simultánea)
-            for (const auto& sospechoso : sospechosos) {
-                // Si ya encontramos esta persona, saltarla
-                if (cedulasEncontradas.find(sospechoso.cedula) != cedulasEncontradas.end()) {
-                    continue;
-                }
+    if (args.opciones.count("--batch")) {
+        return ejecutarLote(args, opciones);
+    }
 
-                vector<CoincidenciaMultiple> resultados =
-                    AhoCorasick::buscarMultiple(sospechoso.cadenaADN, patrones);
-
-                // Solo registrar la PRIMERA coincidencia encontrada para esta persona
-                if (!resultados.empty()) {
-                    const auto& res = resultados[0];  // Primera coincidencia
-                    Coincidencia coincidencia;
-                    coincidencia.nombre = sospechoso.nombreCompleto;
-                    coincidencia.cedula = sospechoso.cedula;
-                    coincidencia.patronId = res.patronId;
-                    coincidencia.patron = patrones[res.patronId];
-                    coincidencia.posicion = res.posicion;
-                    coincidencias.push_back(coincidencia);
-                    cedulasEncontradas.insert(sospechoso.cedula);  // Marcar como encontrado
-                }
-            }
+    if (args.opciones.count("--build-db")) {
+        return construirBaseDatos(args);
+    }
+
+    if (args.opciones.count("--build-index")) {
+        return construirIndice(args);
+    }
+
+    if (args.opciones.count("--build-fm")) {
+        return construirIndiceFM(args);
+    }
+
+    if (args.banderas.count("--calibrate")) {
+        return calibrarPerfil(args);
+    }
+
+    // Validar argumentos
+    if (args.posicionales.size() != 2) {
+        string error = JSONOutput::generarError(
+            "Argumentos insuficientes",
+            "INVALID_ARGUMENTS",
+            USO
+        );
+        cout << error << endl;
+        return 1;
+    }
 
+    string patronesInput = args.posicionales[0];
+    string rutaCSV = args.posicionales[1];
+
+    // --stream: NDJSON (encabezado, cada coincidencia, resumen) a medida
+    // que se recorre la base; los errores también son una línea
+    unique_ptr<SalidaNDJSON> salidaStream;
+    if (args.banderas.count("--stream")) {
+        salidaStream.reset(new SalidaNDJSON());
+        opciones.receptor = salidaStream.get();
+    }
+    auto reportarError = [&](const string& mensaje, const string& codigo, const string& detalles) {
+        if (salidaStream) {
+            salidaStream->error(mensaje, codigo, detalles);
         } else {
-            // CASO: UN SOLO PATRÓN → Usar algoritmo seleccionado
-            const string& patron = patrones[0];
+            cout << JSONOutput::generarError(mensaje, codigo, detalles) << endl;
+        }
+        return 1;
+    };
 
-            for (const auto& sospechoso : sospechosos) {
-                int posicion = -1;
+    // Inicio del timer
+    auto inicio = chrono::high_resolution_clock::now();
 
-                // Ejecutar algoritmo seleccionado
-                switch (algoritmoSeleccionado) {
-                    case AlgorithmSelector::KMP:
-                        posicion = KMP::buscar(sospechoso.cadenaADN, patron);
-                        break;
+    try {
+        // La entrada tal como llegó (útil con consolas que cambian la codificación)
+        TRAZA(DEPURACION, "Argumento recibido (argv[1]): '" << patronesInput << "'");
+        TRAZA(DEPURACION, "Longitud: " << patronesInput.length());
+        TRAZA(DEPURACION, "Bytes (hex): " << bytesHex(patronesInput));
+
+        // Parsear patrones (pueden ser múltiples separados por coma)
+        vector<string> patrones = MotorBusqueda::dividirPatrones(patronesInput);
+        metricas.parseoArgumentosNs = cronometro.reiniciar();
 
-                    case AlgorithmSelector::RABIN_KARP:
-                        posicion = RabinKarp::buscar(sospechoso.cadenaADN, patron);
-                        break;
+        TRAZA(DEPURACION, "Patrones parseados: " << patrones.size());
+        for (size_t i = 0; i < patrones.size(); i++) {
+            TRAZA(DEPURACION, "Patron " << i << ": '" << patrones[i] << "' (len=" << patrones[i].length() << ")");
+            TRAZA(DEPURACION, "Bytes: " << bytesHex(patrones[i]));
+        }
+
+        try {
+            MotorBusqueda::validarPatrones(patrones);
+            MotorBusqueda::validarOpciones(patrones, opciones);
+        } catch (const ErrorBusqueda& e) {
+            return reportarError(e.what(), e.codigo, e.detalles);
+        }
+        metricas.validacionNs = cronometro.reiniciar();
+
+        // Parsear archivo CSV (con --empaquetado, a 2 bits por base en un
+        // AlmacenSospechosos; con --max-memory, solo validarlo y medirlo:
+        // se lee de a lotes durante la búsqueda)
+        // o abrir la base .adnb (ya validada al construirla)
+        bool binaria = BaseDatosBinaria::esRutaBinaria(rutaCSV);
+        bool porLotes = memoriaMaxima > 0;
+        bool empaquetado = args.banderas.count("--empaquetado") > 0;
+        // Sin --empaquetado, el CSV se mapea en memoria y se busca sin copiar las cadenas
+        unique_ptr<CSVMapeado> csvMapeado;
+        unique_ptr<BaseDatosBinaria> baseBinaria;
+        unique_ptr<AlmacenSospechosos> almacen;
+        unique_ptr<CSVPorLotes> csvPorLotes;
+        try {
+            if (binaria) {
+                baseBinaria.reset(new BaseDatosBinaria(rutaCSV));
+            } else if (porLotes) {
+                csvPorLotes.reset(new CSVPorLotes(rutaCSV, memoriaMaxima));
+            } else if (empaquetado) {
+                almacen.reset(new AlmacenSospechosos(rutaCSV));
+            } else {
+                csvMapeado.reset(new CSVMapeado(rutaCSV));
+            }
+        } catch (const exception& e) {
+            return reportarError(
+                binaria ? "Error al leer la base binaria" : "Error al leer archivo CSV",
+                "FILE_ERROR",
+                string(e.what())
+            );
+        }
 
-                    case AlgorithmSelector::AHO_CORASICK:
-                        posicion = AhoCorasick::buscar(sospechoso.cadenaADN, patron);
-                        break;
+        size_t numRegistros = binaria ? baseBinaria->size()
+            : porLotes ? csvPorLotes->size()
+            : empaquetado ? almacen->size()
+            : csvMapeado->sospechosos().size();
+        // Se calcula (una vez) solo si hay un índice que validar
+        unique_ptr<HuellaBase> huella;
+        auto huellaBase = [&]() -> const HuellaBase& {
+            if (!huella) {
+                huella.reset(new HuellaBase(
+                    binaria ? calcularHuella(*baseBinaria)
+                    : porLotes ? calcularHuella(*csvPorLotes)
+                    : empaquetado ? calcularHuella(*almacen)
+                    : calcularHuella(csvMapeado->sospechosos())));
+            }
+            return *huella;
+        };
+
+        // Índice FM: si la base tiene uno al lado (<ruta_base>.fm), las
+        // búsquedas exactas lo usan en lugar de recorrer los sospechosos.
+        // Uno desactualizado (la base cambió, aunque conserve el tamaño:
+        // se compara la huella de sus cadenas) se ignora.
+        unique_ptr<IndiceFM> indiceFM;
+        string rutaIndiceFM = IndiceFM::rutaPara(rutaCSV);
+        if (opciones.maxErrores < 0 && ifstream(rutaIndiceFM).good()) {
+            try {
+                indiceFM.reset(new IndiceFM(rutaIndiceFM));
+                if (indiceFM->corresponde(huellaBase())) {
+                    opciones.indiceFM = indiceFM.get();
+                }
+            } catch (const exception& e) {
+                return reportarError(
+                    "Error al leer el índice FM",
+                    "FILE_ERROR",
+                    string(e.what())
+                );
+            }
+        }
+
+        // Plan de consulta: con --index solo se revisan los sospechosos donde
+        // los k-mers raros de algún patrón coinciden. Si las listas no son
+        // selectivas (o la búsqueda es aproximada o hay índice FM) se recorre toda la base.
+        vector<size_t> filasCandidatas;
+        auto rutaIndice = args.opciones.find("--index");
+        if (rutaIndice != args.opciones.end() && opciones.maxErrores < 0 && opciones.indiceFM == nullptr) {
+            try {
+                IndiceKmers indice(rutaIndice->second);
+
+                if (!indice.corresponde(huellaBase())) {
+                    throw runtime_error("El índice " + rutaIndice->second + " no corresponde a " + rutaCSV);
                 }
 
-                // Si se encontró coincidencia, agregarla
-                if (posicion != -1) {
-                    Coincidencia coincidencia;
-                    coincidencia.nombre = sospechoso.nombreCompleto;
-                    coincidencia.cedula = sospechoso.cedula;
-                    coincidencia.patronId = 0;
-                    coincidencia.patron = patron;
-                    coincidencia.posicion = posicion;
-                    coincidencias.push_back(coincidencia);
+                // Con ambas hebras, también los k-mers de los complementos
+                if (indice.planificar(MotorBusqueda::patronesDeBusqueda(patrones, opciones), filasCandidatas)) {
+                    opciones.filas = &filasCandidatas;
                 }
+            } catch (const exception& e) {
+                return reportarError(
+                    "Error al leer el índice de k-mers",
+                    "FILE_ERROR",
+                    string(e.what())
+                );
             }
         }
 
+        metricas.ingestaNs = cronometro.reiniciar();
+        TRAZA(INFORMACION, "Base: " << rutaCSV << " (" << numRegistros << " sospechosos)"
+              << (opciones.indiceFM != nullptr ? ", con índice FM" : "")
+              << (opciones.filas != nullptr ? ", " + to_string(filasCandidatas.size()) + " candidatos del índice de k-mers" : ""));
+
+        opciones.metricas = &metricas;
+        ResultadoBusqueda resultado;
+        if (porLotes) {
+            // El CSV se vuelve a leer durante la búsqueda: puede fallar o haber cambiado
+            try {
+                resultado = MotorBusqueda::ejecutar(patrones, *csvPorLotes, opciones);
+            } catch (const ErrorBusqueda& e) {
+                return reportarError(e.what(), e.codigo, e.detalles);
+            } catch (const runtime_error& e) {
+                return reportarError("Error al leer archivo CSV", "FILE_ERROR", string(e.what()));
+            }
+        } else {
+            resultado = binaria
+                ? MotorBusqueda::ejecutar(patrones, *baseBinaria, opciones)
+                : empaquetado
+                ? MotorBusqueda::ejecutar(patrones, *almacen, opciones)
+                : MotorBusqueda::ejecutar(patrones, csvMapeado->sospechosos(), opciones);
+        }
+
         // Fin del timer
         auto fin = chrono::high_resolution_clock::now();
         auto duracion = chrono::duration_cast<chrono::milliseconds>(fin - inicio);
 
+        TRAZA(INFORMACION, "Algoritmo: " << resultado.algoritmo << " (" << resultado.criterio << ")");
+        TRAZA(INFORMACION, "Fases (ns): parseo=" << metricas.parseoArgumentosNs
+              << " validacion=" << metricas.validacionNs << " ingesta=" << metricas.ingestaNs
+              << " construccion=" << metricas.construccionNs << " recorrido=" << metricas.recorridoNs);
+
+        metricas.picoMemoriaBytes = Metricas::leerPicoMemoria();
+
+        if (salidaStream) {
+            salidaStream->resumen(duracion.count(), &metricas);
+            return 0;
+        }
+
         // Generar salida JSON
         string salidaJSON = JSONOutput::generarExito(
             patrones,
-            nombreAlgoritmo,
-            criterioSeleccion,
-            numSospechosos,
-            coincidencias,
-            duracion.count()
+            resultado.algoritmo,
+            resultado.criterio,
+            resultado.totalProcesados,
+            resultado.coincidencias,
+            duracion.count(),
+            false,
+            &metricas
         );
 
         cout << salidaJSON << endl;
         return 0;
 
     } catch (const exception& e) {
-        string error = JSONOutput::generarError(
+        return reportarError(
             "Error inesperado",
             "UNEXPECTED_ERROR",
             string(e.what())
         );
-        cout << error << endl;
-        return 1;
     }
 }
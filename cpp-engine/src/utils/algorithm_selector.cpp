@@ -1,40 +1,66 @@
 #include "../../include/algorithm_selector.h"
+#include "../../include/perfil_costos.h"
+#include "../../include/busqueda_simd.h"
+#include <sstream>
+#include <algorithm>
 
-AlgorithmSelector::Algorithm AlgorithmSelector::seleccionar(
-    int numPatrones,
-    int longitudPromedioPatron,
-    int numSospechosos
-) {
-    // REGLA 1: Si hay 2 o más patrones → Aho-Corasick SIEMPRE
-    // Razón: Aho-Corasick busca todos los patrones en UNA sola pasada
-    // Ejemplo: 3 patrones + 10,000 sospechosos
-    //   - KMP: 3 × 10,000 = 30,000 comparaciones
-    //   - Aho-Corasick: 1 × 10,000 = 10,000 comparaciones ⚡
-    if (numPatrones >= 2) {
-        return AHO_CORASICK;
+double AlgorithmSelector::pasadasPor(Algorithm algoritmo, int numPatrones, int numLongitudes) {
+    switch (algoritmo) {
+        case AHO_CORASICK:
+            // Todos los patrones en UNA sola pasada
+            return 1.0;
+        case RABIN_KARP_MULTIPLE:
+            // Una pasada, pero una consulta a la tabla por longitud distinta
+            return numLongitudes;
+        default:
+            // Los motores de un solo patrón recorren los sospechosos una vez por patrón
+            return numPatrones;
     }
+}
 
-    // A partir de aquí: 1 solo patrón
+std::vector<AlgorithmSelector::Estimacion> AlgorithmSelector::estimarCostos(
+    const CargaTrabajo& carga,
+    const PerfilCostos& perfil
+) {
+    std::vector<Estimacion> estimaciones;
 
-    // REGLA 2: Patrón corto + muchos textos → KMP
-    // KMP es eficiente para patrones cortos y tiene complejidad lineal garantizada
-    if (longitudPromedioPatron <= 15 && numSospechosos > 500) {
-        return KMP;
-    }
+    for (Algorithm algoritmo : PerfilCostos::algoritmosExactos()) {
+        // Sin SSE2/AVX2 el filtro SIMD es escalar y nunca conviene
+        if (algoritmo == SIMD && BusquedaSIMD::instruccionesDisponibles() == BusquedaSIMD::ESCALAR) {
+            continue;
+        }
+
+        double pasadas = pasadasPor(algoritmo, carga.numPatrones, carga.numLongitudes);
+        const PerfilCostos::Coeficientes& c = perfil.coeficientes(algoritmo, carga.representacion);
+
+        double costo = c.porBase * carga.basesRecorridas * pasadas
+                     + c.porSecuencia * carga.numSecuencias * pasadas
+                     + c.porSecuenciaYBasePatron * carga.numSecuencias * carga.longitudTotalPatrones
+                     + c.porBasePatron * carga.longitudTotalPatrones;
 
-    // REGLA 3: Patrón largo → Rabin-Karp
-    // Rabin-Karp es eficiente para patrones largos debido al hashing
-    if (longitudPromedioPatron > 30) {
-        return RABIN_KARP;
+        estimaciones.push_back({algoritmo, costo});
     }
 
-    // REGLA 4: Patrón medio + muchos textos → Aho-Corasick
-    if (longitudPromedioPatron >= 15 && longitudPromedioPatron <= 30 && numSospechosos > 1000) {
-        return AHO_CORASICK;
+    std::stable_sort(estimaciones.begin(), estimaciones.end(), [](const Estimacion& a, const Estimacion& b) {
+        return a.costoNs < b.costoNs;
+    });
+    return estimaciones;
+}
+
+AlgorithmSelector::Algorithm AlgorithmSelector::seleccionar(
+    const CargaTrabajo& carga,
+    const PerfilCostos& perfil,
+    bool hayIndiceFM
+) {
+    // REGLA 0: Si la base tiene índice FM → usarlo
+    // Razón: cuesta O(m) por patrón más O(1) por aparición, sin recorrer
+    // ningún sospechoso; cualquier otro algoritmo lee toda la base
+    if (hayIndiceFM) {
+        return FM_INDEX;
     }
 
-    // Default: KMP (más confiable y sin overhead de construcción compleja)
-    return KMP;
+    // REGLA 1: el motor con menor tiempo estimado en esta máquina
+    return estimarCostos(carga, perfil).front().algoritmo;
 }
 
 std::string AlgorithmSelector::toString(Algorithm algo) {
@@ -45,6 +71,16 @@ std::string AlgorithmSelector::toString(Algorithm algo) {
             return "rabin-karp";
         case AHO_CORASICK:
             return "aho-corasick";
+        case SIMD:
+            return "simd";
+        case MYERS:
+            return "myers";
+        case HAMMING:
+            return "hamming";
+        case FM_INDEX:
+            return "fm-index";
+        case RABIN_KARP_MULTIPLE:
+            return "rabin-karp-multiple";
         default:
             return "kmp";
     }
@@ -52,29 +88,30 @@ std::string AlgorithmSelector::toString(Algorithm algo) {
 
 std::string AlgorithmSelector::obtenerCriterio(
     Algorithm algo,
-    int numPatrones,
-    int longitudPromedioPatron,
-    int numSospechosos
+    const CargaTrabajo& carga,
+    const PerfilCostos& perfil
 ) {
-    // Si hay múltiples patrones, siempre es por esa razón
-    if (numPatrones >= 2) {
-        return "multiples_patrones_busqueda_simultanea";
+    // La búsqueda aproximada la pide el usuario (--max-errors)
+    if (algo == MYERS) {
+        return "max_errores_distancia_edicion";
+    }
+    if (algo == HAMMING) {
+        return "max_errores_distancia_hamming";
     }
 
-    switch (algo) {
-        case KMP:
-            if (longitudPromedioPatron <= 15 && numSospechosos > 500) {
-                return "patron_corto_muchos_textos";
-            }
-            return "default_mas_confiable";
-
-        case RABIN_KARP:
-            return "patron_largo";
-
-        case AHO_CORASICK:
-            return "patron_medio_muchos_textos";
+    if (algo == FM_INDEX) {
+        return "indice_fm_disponible";
+    }
 
-        default:
-            return "default";
+    // Ej: "costo_estimado_calibrado: simd=1.204ms aho-corasick=3.400ms kmp=8.013ms rabin-karp=9.100ms"
+    // (con cadenas empaquetadas: "costo_estimado_calibrado_empaquetado: ...")
+    std::ostringstream criterio;
+    criterio.setf(std::ios::fixed);
+    criterio.precision(3);
+    criterio << (perfil.calibrado() ? "costo_estimado_calibrado" : "costo_estimado_por_defecto")
+             << (carga.representacion == CargaTrabajo::EMPAQUETADA ? "_empaquetado:" : ":");
+    for (const Estimacion& estimacion : estimarCostos(carga, perfil)) {
+        criterio << " " << toString(estimacion.algoritmo) << "=" << estimacion.costoNs / 1e6 << "ms";
     }
+    return criterio.str();
 }
@@ -0,0 +1,116 @@
+#include "../../include/almacen_sospechosos.h"
+#include "../../include/csv_parser.h"
+#include "../../include/archivo_mapeado.h"
+#include "../../include/validacion_adn.h"
+#include "../../include/pool_hilos.h"
+#include <algorithm>
+#include <deque>
+
+TextoCedula TextoCedula::deNumero(uint64_t valor) {
+    TextoCedula cedula;
+    cedula.numerica = true;
+    cedula.valor = valor;
+    return cedula;
+}
+
+TextoCedula TextoCedula::deTexto(std::string_view texto) {
+    TextoCedula cedula;
+    cedula.texto = texto;
+    return cedula;
+}
+
+TextoCedula::operator std::string_view() const {
+    if (!numerica) {
+        return texto;
+    }
+
+    // Los dígitos se escriben de atrás hacia adelante
+    size_t inicio = sizeof(digitos);
+    uint64_t resto = valor;
+    do {
+        digitos[--inicio] = static_cast<char>('0' + resto % 10);
+        resto /= 10;
+    } while (resto != 0);
+
+    return std::string_view(digitos + inicio, sizeof(digitos) - inicio);
+}
+
+bool TextoCedula::leerNumero(std::string_view texto, uint64_t& valor) {
+    if (texto.empty() || texto.length() > 18 || (texto[0] == '0' && texto.length() > 1)) {
+        return false;
+    }
+
+    valor = 0;
+    for (char c : texto) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        valor = valor * 10 + (c - '0');
+    }
+    return true;
+}
+
+AlmacenSospechosos::AlmacenSospechosos(const std::string& rutaCSV) {
+    ArchivoMapeado archivo(rutaCSV);
+    std::string_view contenido = archivo.contenido();
+
+    // Primero las vistas (una por línea como máximo), para conocer el
+    // tamaño exacto de cada columna
+    std::deque<std::string> camposReescritos;
+    std::vector<SospechosoVista> vistas;
+    vistas.reserve(std::count(contenido.begin(), contenido.end(), '\n') + 1);
+    CSVParser::leerRegistros(contenido, camposReescritos, [&](const SospechosoVista& vista) {
+        vistas.push_back(vista);
+    });
+
+    size_t totalNombres = 0;
+    size_t totalCedulasTexto = 0;
+    size_t numCedulasTexto = 0;
+    size_t totalPalabras = 0;
+    for (const SospechosoVista& vista : vistas) {
+        uint64_t numero;
+        totalNombres += vista.nombreCompleto.length();
+        if (!TextoCedula::leerNumero(vista.cedula, numero)) {
+            totalCedulasTexto += vista.cedula.length();
+            numCedulasTexto++;
+        }
+        totalPalabras += SecuenciaEmpaquetada::palabrasNecesarias(vista.cadenaADN.length());
+    }
+
+    size_t n = vistas.size();
+    nombres.reserve(totalNombres);
+    inicioNombre.reserve(n + 1);
+    cedulas.reserve(n);
+    cedulasTexto.reserve(totalCedulasTexto);
+    inicioCedulaTexto.reserve(numCedulasTexto + 1);
+    inicioADN.reserve(n);
+    longitudADN.reserve(n);
+
+    inicioNombre.push_back(0);
+    inicioCedulaTexto.push_back(0);
+    uint64_t palabra = 0;
+    for (const SospechosoVista& vista : vistas) {
+        nombres.append(vista.nombreCompleto);
+        inicioNombre.push_back(nombres.size());
+
+        uint64_t numero;
+        if (TextoCedula::leerNumero(vista.cedula, numero)) {
+            cedulas.push_back(numero);
+        } else {
+            cedulas.push_back(BIT_TEXTO | (inicioCedulaTexto.size() - 1));
+            cedulasTexto.append(vista.cedula);
+            inicioCedulaTexto.push_back(cedulasTexto.size());
+        }
+
+        inicioADN.push_back(palabra);
+        longitudADN.push_back(vista.cadenaADN.length());
+        palabra += SecuenciaEmpaquetada::palabrasNecesarias(vista.cadenaADN.length());
+    }
+
+    // Cada hilo empaqueta sus cadenas en su lugar de la arena (las
+    // palabras de relleno quedan en cero). Ya están validadas.
+    adn.assign(totalPalabras, 0);
+    PoolHilos::paraCada(n, PoolHilos::hilosDisponibles(), [&](size_t i, int) {
+        ValidacionADN::validarYEmpaquetar(vistas[i].cadenaADN, adn.data() + inicioADN[i]);
+    });
+}
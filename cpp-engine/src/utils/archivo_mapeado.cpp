@@ -0,0 +1,119 @@
+#include "../../include/archivo_mapeado.h"
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+ArchivoMapeado::ArchivoMapeado(const std::string& rutaArchivo) : datos(nullptr), tamano(0) {
+#ifdef _WIN32
+    manejadorArchivo = nullptr;
+    manejadorMapeo = nullptr;
+
+    HANDLE archivo = CreateFileA(rutaArchivo.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                 OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (archivo == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("No se pudo abrir el archivo: " + rutaArchivo);
+    }
+    manejadorArchivo = archivo;
+
+    LARGE_INTEGER tamanoArchivo;
+    if (!GetFileSizeEx(archivo, &tamanoArchivo)) {
+        liberar();
+        throw std::runtime_error("No se pudo abrir el archivo: " + rutaArchivo);
+    }
+    tamano = static_cast<size_t>(tamanoArchivo.QuadPart);
+
+    // Un archivo vacío no se puede mapear: se deja el contenido vacío
+    if (tamano > 0) {
+        manejadorMapeo = CreateFileMappingA(archivo, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (manejadorMapeo == nullptr) {
+            liberar();
+            throw std::runtime_error("No se pudo mapear el archivo: " + rutaArchivo);
+        }
+
+        datos = static_cast<const char*>(MapViewOfFile(manejadorMapeo, FILE_MAP_READ, 0, 0, 0));
+        if (datos == nullptr) {
+            liberar();
+            throw std::runtime_error("No se pudo mapear el archivo: " + rutaArchivo);
+        }
+    }
+#else
+    int descriptor = open(rutaArchivo.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error("No se pudo abrir el archivo: " + rutaArchivo);
+    }
+
+    struct stat info;
+    if (fstat(descriptor, &info) < 0 || !S_ISREG(info.st_mode)) {
+        close(descriptor);
+        throw std::runtime_error("No se pudo abrir el archivo: " + rutaArchivo);
+    }
+    tamano = static_cast<size_t>(info.st_size);
+
+    // Un archivo vacío no se puede mapear: se deja el contenido vacío
+    if (tamano > 0) {
+        void* mapeo = mmap(nullptr, tamano, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapeo == MAP_FAILED) {
+            close(descriptor);
+            throw std::runtime_error("No se pudo mapear el archivo: " + rutaArchivo);
+        }
+
+        // Se recorre de principio a fin: pedir lectura anticipada al kernel
+        madvise(mapeo, tamano, MADV_SEQUENTIAL);
+        datos = static_cast<const char*>(mapeo);
+    }
+
+    // El mapeo sigue válido después de cerrar el descriptor
+    close(descriptor);
+#endif
+}
+
+ArchivoMapeado::~ArchivoMapeado() {
+    liberar();
+}
+
+ArchivoMapeado::ArchivoMapeado(ArchivoMapeado&& otro) noexcept
+    : datos(otro.datos), tamano(otro.tamano) {
+#ifdef _WIN32
+    manejadorArchivo = otro.manejadorArchivo;
+    manejadorMapeo = otro.manejadorMapeo;
+    otro.manejadorArchivo = nullptr;
+    otro.manejadorMapeo = nullptr;
+#endif
+    otro.datos = nullptr;
+    otro.tamano = 0;
+}
+
+ArchivoMapeado& ArchivoMapeado::operator=(ArchivoMapeado&& otro) noexcept {
+    if (this != &otro) {
+        liberar();
+        datos = std::exchange(otro.datos, nullptr);
+        tamano = std::exchange(otro.tamano, 0);
+#ifdef _WIN32
+        manejadorArchivo = std::exchange(otro.manejadorArchivo, nullptr);
+        manejadorMapeo = std::exchange(otro.manejadorMapeo, nullptr);
+#endif
+    }
+    return *this;
+}
+
+void ArchivoMapeado::liberar() {
+#ifdef _WIN32
+    if (datos != nullptr) UnmapViewOfFile(datos);
+    if (manejadorMapeo != nullptr) CloseHandle(manejadorMapeo);
+    if (manejadorArchivo != nullptr) CloseHandle(manejadorArchivo);
+    manejadorMapeo = nullptr;
+    manejadorArchivo = nullptr;
+#else
+    if (datos != nullptr) munmap(const_cast<char*>(datos), tamano);
+#endif
+    datos = nullptr;
+    tamano = 0;
+}
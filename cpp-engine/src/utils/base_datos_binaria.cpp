@@ -0,0 +1,219 @@
+#include "../../include/base_datos_binaria.h"
+#include <fstream>
+#include <stdexcept>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const char MAGIA[4] = {'A', 'D', 'N', 'B'};
+const uint32_t VERSION = 1;
+const uint32_t BANDERA_EMPAQUETADO = 1;
+
+struct Cabecera {
+    char magia[4];
+    uint32_t version;
+    uint32_t banderas;
+    uint32_t reservado;
+    uint64_t numRegistros;
+    uint64_t offsetIndice;
+    uint64_t offsetNombres;
+    uint64_t tamanoNombres;
+    uint64_t offsetCedulas;
+    uint64_t tamanoCedulas;
+    uint64_t offsetADN;
+    uint64_t tamanoADN;     // En bytes
+    uint64_t tamanoArchivo;
+};
+
+struct EntradaIndice {
+    uint64_t inicioNombre;  // Offset dentro de la sección de nombres
+    uint64_t inicioCedula;  // Offset dentro de la sección de cédulas
+    uint64_t inicioADN;     // Offset en bytes dentro de la sección de ADN
+    uint64_t longitudADN;   // En bases
+    uint32_t longitudNombre;
+    uint32_t longitudCedula;
+};
+
+static_assert(sizeof(Cabecera) == 88, "La cabecera .adnb debe ocupar 88 bytes");
+static_assert(sizeof(EntradaIndice) == 40, "Cada entrada del índice .adnb debe ocupar 40 bytes");
+
+// Las secciones empiezan alineadas a 8 bytes para leer palabras de 64 bits
+uint64_t alinear8(uint64_t offset) {
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+void escribirRelleno(std::ofstream& salida, uint64_t desde, uint64_t hasta) {
+    static const char CEROS[8] = {0};
+    salida.write(CEROS, hasta - desde);
+}
+
+// Lee la entrada i y verifica que apunte dentro de sus secciones
+EntradaIndice leerEntrada(const char* indice, size_t i, uint64_t tamanoNombres,
+                          uint64_t tamanoCedulas, uint64_t tamanoADN, bool empaquetado) {
+    EntradaIndice entrada;
+    std::memcpy(&entrada, indice + i * sizeof(EntradaIndice), sizeof(entrada));
+
+    uint64_t bytesADN = empaquetado
+        ? SecuenciaEmpaquetada::palabrasNecesarias(entrada.longitudADN) * sizeof(uint64_t)
+        : entrada.longitudADN;
+
+    if (entrada.inicioNombre > tamanoNombres || entrada.longitudNombre > tamanoNombres - entrada.inicioNombre ||
+        entrada.inicioCedula > tamanoCedulas || entrada.longitudCedula > tamanoCedulas - entrada.inicioCedula ||
+        entrada.inicioADN > tamanoADN || bytesADN > tamanoADN - entrada.inicioADN ||
+        (empaquetado && entrada.inicioADN % 8 != 0)) {
+        throw std::runtime_error("Base binaria inválida: registro " + std::to_string(i) + " fuera de rango");
+    }
+
+    return entrada;
+}
+
+}
+
+BaseDatosBinaria::BaseDatosBinaria(const std::string& rutaArchivo) : archivo(rutaArchivo) {
+    std::string_view contenido = archivo.contenido();
+
+    Cabecera cabecera;
+    if (contenido.size() < sizeof(cabecera)) {
+        throw std::runtime_error("Base binaria inválida (archivo truncado): " + rutaArchivo);
+    }
+    std::memcpy(&cabecera, contenido.data(), sizeof(cabecera));
+
+    if (std::memcmp(cabecera.magia, MAGIA, sizeof(MAGIA)) != 0) {
+        throw std::runtime_error("El archivo no es una base .adnb: " + rutaArchivo);
+    }
+    if (cabecera.version != VERSION) {
+        throw std::runtime_error("Versión de base .adnb no soportada: " + std::to_string(cabecera.version));
+    }
+
+    // Verificar que cada sección quepa en el archivo
+    uint64_t tamano = contenido.size();
+    bool valida = cabecera.tamanoArchivo == tamano &&
+        cabecera.offsetIndice <= tamano &&
+        cabecera.numRegistros <= (tamano - cabecera.offsetIndice) / sizeof(EntradaIndice) &&
+        cabecera.offsetNombres <= tamano && cabecera.tamanoNombres <= tamano - cabecera.offsetNombres &&
+        cabecera.offsetCedulas <= tamano && cabecera.tamanoCedulas <= tamano - cabecera.offsetCedulas &&
+        cabecera.offsetADN <= tamano && cabecera.tamanoADN <= tamano - cabecera.offsetADN &&
+        cabecera.offsetADN % 8 == 0;
+
+    if (!valida) {
+        throw std::runtime_error("Base binaria inválida (secciones fuera del archivo): " + rutaArchivo);
+    }
+
+    numRegistros = cabecera.numRegistros;
+    adnEmpaquetado = (cabecera.banderas & BANDERA_EMPAQUETADO) != 0;
+    indice = contenido.data() + cabecera.offsetIndice;
+    nombres = contenido.data() + cabecera.offsetNombres;
+    cedulas = contenido.data() + cabecera.offsetCedulas;
+    adn = contenido.data() + cabecera.offsetADN;
+    tamanoNombres = cabecera.tamanoNombres;
+    tamanoCedulas = cabecera.tamanoCedulas;
+    tamanoADN = cabecera.tamanoADN;
+}
+
+SospechosoVista BaseDatosBinaria::registro(size_t i) const {
+    EntradaIndice entrada = leerEntrada(indice, i, tamanoNombres, tamanoCedulas, tamanoADN, false);
+
+    SospechosoVista sospechoso;
+    sospechoso.nombreCompleto = std::string_view(nombres + entrada.inicioNombre, entrada.longitudNombre);
+    sospechoso.cedula = std::string_view(cedulas + entrada.inicioCedula, entrada.longitudCedula);
+    sospechoso.cadenaADN = std::string_view(adn + entrada.inicioADN, entrada.longitudADN);
+    return sospechoso;
+}
+
+SospechosoEmpaquetadoVista BaseDatosBinaria::registroEmpaquetado(size_t i) const {
+    EntradaIndice entrada = leerEntrada(indice, i, tamanoNombres, tamanoCedulas, tamanoADN, true);
+
+    return SospechosoEmpaquetadoVista{
+        std::string_view(nombres + entrada.inicioNombre, entrada.longitudNombre),
+        std::string_view(cedulas + entrada.inicioCedula, entrada.longitudCedula),
+        SecuenciaEmpaquetada::vista(reinterpret_cast<const uint64_t*>(adn + entrada.inicioADN),
+                                    entrada.longitudADN)
+    };
+}
+
+size_t BaseDatosBinaria::construir(
+    const std::string& rutaCSV,
+    const std::string& rutaSalida,
+    bool empaquetar
+) {
+    // Parseo y validación del CSV: es la única vez que se hacen
+    CSVMapeado csv(rutaCSV);
+    const std::vector<SospechosoVista>& sospechosos = csv.sospechosos();
+
+    // Calcular el índice y el tamaño de cada sección
+    std::vector<EntradaIndice> entradas(sospechosos.size());
+    uint64_t tamanoNombres = 0;
+    uint64_t tamanoCedulas = 0;
+    uint64_t tamanoADN = 0;
+
+    for (size_t i = 0; i < sospechosos.size(); i++) {
+        const SospechosoVista& s = sospechosos[i];
+        EntradaIndice& entrada = entradas[i];
+
+        entrada.inicioNombre = tamanoNombres;
+        entrada.longitudNombre = s.nombreCompleto.length();
+        entrada.inicioCedula = tamanoCedulas;
+        entrada.longitudCedula = s.cedula.length();
+        entrada.inicioADN = tamanoADN;
+        entrada.longitudADN = s.cadenaADN.length();
+
+        tamanoNombres += s.nombreCompleto.length();
+        tamanoCedulas += s.cedula.length();
+        tamanoADN += empaquetar
+            ? SecuenciaEmpaquetada::palabrasNecesarias(s.cadenaADN.length()) * sizeof(uint64_t)
+            : s.cadenaADN.length();
+    }
+
+    Cabecera cabecera;
+    std::memset(&cabecera, 0, sizeof(cabecera));
+    std::memcpy(cabecera.magia, MAGIA, sizeof(MAGIA));
+    cabecera.version = VERSION;
+    cabecera.banderas = empaquetar ? BANDERA_EMPAQUETADO : 0;
+    cabecera.numRegistros = sospechosos.size();
+    cabecera.offsetIndice = sizeof(Cabecera);
+    cabecera.offsetNombres = cabecera.offsetIndice + entradas.size() * sizeof(EntradaIndice);
+    cabecera.tamanoNombres = tamanoNombres;
+    cabecera.offsetCedulas = cabecera.offsetNombres + tamanoNombres;
+    cabecera.tamanoCedulas = tamanoCedulas;
+    cabecera.offsetADN = alinear8(cabecera.offsetCedulas + tamanoCedulas);
+    cabecera.tamanoADN = tamanoADN;
+    cabecera.tamanoArchivo = cabecera.offsetADN + tamanoADN;
+
+    std::ofstream salida(rutaSalida, std::ios::binary | std::ios::trunc);
+    if (!salida.is_open()) {
+        throw std::runtime_error("No se pudo crear el archivo: " + rutaSalida);
+    }
+
+    salida.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+    salida.write(reinterpret_cast<const char*>(entradas.data()), entradas.size() * sizeof(EntradaIndice));
+
+    for (const auto& s : sospechosos) {
+        salida.write(s.nombreCompleto.data(), s.nombreCompleto.length());
+    }
+    for (const auto& s : sospechosos) {
+        salida.write(s.cedula.data(), s.cedula.length());
+    }
+    escribirRelleno(salida, cabecera.offsetCedulas + tamanoCedulas, cabecera.offsetADN);
+
+    for (const auto& s : sospechosos) {
+        if (empaquetar) {
+            SecuenciaEmpaquetada empaquetada(s.cadenaADN);
+            salida.write(reinterpret_cast<const char*>(empaquetada.datos()), empaquetada.bytesMemoria());
+        } else {
+            salida.write(s.cadenaADN.data(), s.cadenaADN.length());
+        }
+    }
+
+    if (!salida.good()) {
+        throw std::runtime_error("Error al escribir el archivo: " + rutaSalida);
+    }
+
+    return sospechosos.size();
+}
+
+bool BaseDatosBinaria::esRutaBinaria(const std::string& ruta) {
+    const std::string extension = ".adnb";
+    return ruta.length() >= extension.length() &&
+           ruta.compare(ruta.length() - extension.length(), extension.length(), extension) == 0;
+}
@@ -0,0 +1,119 @@
+#include "../../include/cache_resultados.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+// Lo que ocupa una entrada además de sus cadenas (nodos, punteros, bloques)
+const size_t BYTES_FIJOS_ENTRADA = 256;
+
+size_t estimarBytes(const std::string& clave, const std::vector<std::string>& patrones, const ResultadoBusqueda& resultado) {
+    size_t bytes = BYTES_FIJOS_ENTRADA + clave.capacity() + resultado.algoritmo.capacity() + resultado.criterio.capacity();
+    for (const auto& patron : patrones) {
+        bytes += sizeof(std::string) + patron.capacity();
+    }
+    for (const auto& coincidencia : resultado.coincidencias) {
+        bytes += sizeof(Coincidencia) + coincidencia.nombre.capacity() + coincidencia.cedula.capacity();
+    }
+    return bytes;
+}
+
+}
+
+CacheResultados::CacheResultados(size_t presupuestoBytes) : presupuesto(presupuestoBytes) {}
+
+std::string CacheResultados::clave(
+    const std::vector<std::string>& patrones,
+    const OpcionesBusqueda& opciones,
+    uint64_t versionBase
+) {
+    std::string clave = "v" + std::to_string(versionBase) + "|";
+    if (opciones.maxErrores < 0) {
+        clave += "exacta";
+    } else {
+        clave += opciones.distancia == BusquedaAproximada::HAMMING ? "hamming:" : "edicion:";
+        clave += std::to_string(opciones.maxErrores);
+    }
+    if (opciones.ambasHebras) {
+        clave += "|ambas";
+    }
+
+    // Con varios patrones cada cédula se reporta una vez: la cantidad
+    // también cuenta, así que se conservan los repetidos
+    std::vector<std::string> canonicos = patrones;
+    if (opciones.maxErrores < 0) {
+        std::sort(canonicos.begin(), canonicos.end());
+    }
+    for (const auto& patron : canonicos) {
+        clave += "|" + patron;
+    }
+    return clave;
+}
+
+bool CacheResultados::buscar(
+    const std::string& clave,
+    const std::vector<std::string>& patrones,
+    ResultadoBusqueda& resultado
+) {
+    std::shared_ptr<const Guardado> guardado;
+    {
+        std::lock_guard<std::mutex> bloqueo(mutex);
+        auto it = porClave.find(clave);
+        if (it == porClave.end()) {
+            return false;
+        }
+        entradas.splice(entradas.begin(), entradas, it->second);
+        guardado = it->second->guardado;
+    }
+
+    // Cada patrón guardado pasa al primer índice con el mismo texto en
+    // esta consulta (el que hubiera ganado un empate en el recorrido)
+    std::unordered_map<std::string_view, int> primerIndice;
+    for (int i = static_cast<int>(patrones.size()) - 1; i >= 0; i--) {
+        primerIndice[patrones[i]] = i;
+    }
+
+    resultado = guardado->resultado;
+    for (auto& coincidencia : resultado.coincidencias) {
+        coincidencia.patronId = primerIndice.at(guardado->patrones[coincidencia.patronId]);
+        coincidencia.patron = patrones[coincidencia.patronId];
+    }
+    return true;
+}
+
+void CacheResultados::guardar(
+    const std::string& clave,
+    const std::vector<std::string>& patrones,
+    const ResultadoBusqueda& resultado
+) {
+    auto guardado = std::make_shared<Guardado>();
+    guardado->patrones = patrones;
+    guardado->resultado = resultado;
+    for (auto& coincidencia : guardado->resultado.coincidencias) {
+        coincidencia.patron.clear();
+        coincidencia.patron.shrink_to_fit();
+    }
+
+    size_t bytes = estimarBytes(clave, guardado->patrones, guardado->resultado);
+    if (bytes > presupuesto) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> bloqueo(mutex);
+
+    // Otro hilo pudo guardar la misma consulta mientras tanto
+    if (porClave.count(clave)) {
+        return;
+    }
+
+    while (usados + bytes > presupuesto) {
+        const Entrada& antigua = entradas.back();
+        porClave.erase(antigua.clave);
+        usados -= antigua.bytes;
+        entradas.pop_back();
+    }
+
+    entradas.push_front({clave, std::move(guardado), bytes});
+    porClave.emplace(entradas.front().clave, entradas.begin());
+    usados += bytes;
+}
@@ -1,130 +1,506 @@
 #include "../../include/csv_parser.h"
-#include <sstream>
-#include <stdexcept>
+#include "../../include/validacion_adn.h"
+#include "../../include/pool_hilos.h"
+#include "../../include/traza.h"
 #include <algorithm>
+#include <iterator>
+#include <stdexcept>
 #include <cctype>
+#include <cstring>
+#include <cstdio>
+#include <memory>
 
-std::vector<Sospechoso> CSVParser::parsear(const std::string& rutaArchivo) {
-    std::vector<Sospechoso> sospechosos;
-    std::ifstream archivo(rutaArchivo);
+namespace {
 
-    if (!archivo.is_open()) {
-        throw std::runtime_error("No se pudo abrir el archivo: " + rutaArchivo);
-    }
+// Con menos bytes por bloque no compensa repartir entre hilos
+const size_t BYTES_MINIMOS_POR_BLOQUE = 1 << 20;
 
-    std::string linea;
-    int numeroLinea = 0;
+// Bloques por hilo: los de líneas más caras se compensan robando otros
+const size_t BLOQUES_POR_HILO = 4;
 
-    // Leer archivo línea por línea
-    while (std::getline(archivo, linea)) {
-        numeroLinea++;
+// El buffer de CSVPorLotes es un octavo del presupuesto: el lote en curso
+// ocupa hasta unas 3 veces su buffer (las vistas de cada bloque mientras
+// se parsea, las del lote y, si todas las líneas tienen comillas, los
+// campos reescritos) y queda margen para el resto del proceso
+const size_t PARTES_DEL_PRESUPUESTO = 8;
 
-        // Saltar líneas vacías
-        if (trim(linea).empty()) {
-            continue;
-        }
+/**
+ * Inicios de los bloques (cada uno justo después de un salto de línea)
+ * seguidos del final del contenido
+ */
+std::vector<size_t> cortarEnBloques(std::string_view contenido, size_t numBloques) {
+    std::vector<size_t> inicios{0};
 
-        // Saltar la línea de encabezado (si existe)
-        if (numeroLinea == 1 &&
-            (linea.find("nombre") != std::string::npos ||
-             linea.find("Nombre") != std::string::npos)) {
-            continue;
+    for (size_t k = 1; k < numBloques; k++) {
+        size_t corte = std::max(inicios.back(), k * contenido.size() / numBloques);
+        if (corte > 0 && corte < contenido.size() && contenido[corte - 1] != '\n') {
+            const char* saltoLinea = static_cast<const char*>(
+                std::memchr(contenido.data() + corte, '\n', contenido.size() - corte));
+            corte = saltoLinea ? saltoLinea - contenido.data() + 1 : contenido.size();
         }
+        inicios.push_back(corte);
+    }
+
+    inicios.push_back(contenido.size());
+    return inicios;
+}
+
+/**
+ * Registro de leerRegistros: si la línea tenía comillas, sus campos viajan
+ * aquí y las vistas se rehacen al guardarlos en camposReescritos
+ */
+struct RegistroVista {
+    SospechosoVista vista;
+    std::vector<std::string> camposConComillas;
+};
+
+void exigirRegistros(size_t totalRegistros) {
+    if (totalRegistros == 0) {
+        throw std::runtime_error("El archivo CSV no contiene registros válidos");
+    }
+}
+
+}
+
+template <typename Registro, typename Preparar, typename Entregar>
+size_t CSVParser::leerEnParalelo(
+    std::string_view contenido,
+    int lineasAnteriores,
+    bool validarADN,
+    Preparar preparar,
+    Entregar entregar
+) {
+    struct Bloque {
+        std::vector<Registro> registros;
+        int lineas = 0;
+        int lineaError = 0;              // Línea del bloque (0 = sin error)
+        std::string_view lineaInvalida;
+    };
+
+    int numHilos = PoolHilos::hilosDisponibles();
+    size_t numBloques = std::max<size_t>(1, std::min(
+        static_cast<size_t>(numHilos) * BLOQUES_POR_HILO,
+        contenido.size() / BYTES_MINIMOS_POR_BLOQUE));
+
+    std::vector<size_t> inicios = cortarEnBloques(contenido, numBloques);
+    std::vector<Bloque> bloques(numBloques);
+
+    TRAZA(Traza::INFORMACION, "CSV: " << contenido.size() << " bytes en " << numBloques << " bloques");
+
+    PoolHilos::paraCada(numBloques, numHilos, [&](size_t b, int) {
+        Bloque& bloque = bloques[b];
+        const char* actual = contenido.data() + inicios[b];
+        const char* finBloque = contenido.data() + inicios[b + 1];
+        std::deque<std::string> camposConComillas;
+
+        // Mismas líneas que std::getline; la numeración es local al bloque
+        while (actual < finBloque) {
+            const char* saltoLinea = static_cast<const char*>(
+                std::memchr(actual, '\n', finBloque - actual));
+            const char* finLinea = saltoLinea ? saltoLinea : finBloque;
 
-        // Dividir la línea en campos
-        std::vector<std::string> campos = dividirLinea(linea);
+            std::string_view linea(actual, finLinea - actual);
+            actual = saltoLinea ? saltoLinea + 1 : finBloque;
+            bloque.lineas++;
 
-        // Validar que tenga exactamente 3 campos
-        if (campos.size() != 3) {
-            throw std::runtime_error(
-                "Error en línea " + std::to_string(numeroLinea) +
-                ": se esperaban 3 campos, se encontraron " + std::to_string(campos.size())
-            );
+            // Saltar líneas vacías
+            if (trim(linea).empty()) {
+                continue;
+            }
+
+            // Saltar la línea de encabezado (si existe)
+            if (lineasAnteriores == 0 && b == 0 && bloque.lineas == 1 &&
+                (linea.find("nombre") != std::string_view::npos ||
+                 linea.find("Nombre") != std::string_view::npos)) {
+                continue;
+            }
+
+            std::string_view campos[3];
+            camposConComillas.clear();
+            size_t numCampos = dividirLinea(linea, campos, camposConComillas);
+
+            Registro registro;
+            bool valido;
+            try {
+                SospechosoVista vista = validarRegistro(campos, numCampos, bloque.lineas, validarADN);
+                valido = preparar(vista, camposConComillas, registro);
+            } catch (const std::runtime_error&) {
+                valido = false;
+            }
+
+            // El mensaje se arma después, cuando se conoce la línea en el archivo
+            if (!valido) {
+                bloque.lineaError = bloque.lineas;
+                bloque.lineaInvalida = linea;
+                return;
+            }
+
+            bloque.registros.push_back(std::move(registro));
         }
+    });
 
-        Sospechoso sospechoso;
-        sospechoso.nombreCompleto = trim(campos[0]);
-        sospechoso.cedula = trim(campos[1]);
-        sospechoso.cadenaADN = trim(campos[2]);
+    // Primer error en el orden del archivo: se valida otra vez con su línea global
+    int lineasPrevias = lineasAnteriores;
+    for (const Bloque& bloque : bloques) {
+        if (bloque.lineaError > 0) {
+            int numeroLinea = lineasPrevias + bloque.lineaError;
+            std::deque<std::string> camposReescritos;
+            std::string_view campos[3];
+            size_t numCampos = dividirLinea(bloque.lineaInvalida, campos, camposReescritos);
+            validarRegistro(campos, numCampos, numeroLinea);
 
-        // Validaciones
-        if (sospechoso.nombreCompleto.empty()) {
-            throw std::runtime_error(
-                "Error en línea " + std::to_string(numeroLinea) + ": nombre vacío"
-            );
+            throw std::runtime_error("Error en línea " + std::to_string(numeroLinea) + ": registro inválido");
         }
+        lineasPrevias += bloque.lineas;
+    }
 
-        if (sospechoso.cedula.empty()) {
-            throw std::runtime_error(
-                "Error en línea " + std::to_string(numeroLinea) + ": cédula vacía"
-            );
+    size_t totalRegistros = 0;
+    for (Bloque& bloque : bloques) {
+        for (Registro& registro : bloque.registros) {
+            entregar(std::move(registro));
         }
+        totalRegistros += bloque.registros.size();
+        std::vector<Registro>().swap(bloque.registros);
+    }
+
+    return totalRegistros;
+}
+
+std::vector<Sospechoso> CSVParser::parsear(const std::string& rutaArchivo) {
+    std::vector<Sospechoso> sospechosos;
+    ArchivoMapeado archivo(rutaArchivo);
+
+    // Las copias se hacen en los hilos de cada bloque
+    size_t total = leerEnParalelo<Sospechoso>(
+        archivo.contenido(), 0, true,
+        [](const SospechosoVista& vista, std::deque<std::string>&, Sospechoso& sospechoso) {
+            sospechoso.nombreCompleto = std::string(vista.nombreCompleto);
+            sospechoso.cedula = std::string(vista.cedula);
+            sospechoso.cadenaADN = std::string(vista.cadenaADN);
+            return true;
+        },
+        [&](Sospechoso&& sospechoso) { sospechosos.push_back(std::move(sospechoso)); });
+
+    exigirRegistros(total);
+    return sospechosos;
+}
+
+std::vector<SospechosoEmpaquetado> CSVParser::parsearEmpaquetado(const std::string& rutaArchivo) {
+    std::vector<SospechosoEmpaquetado> sospechosos;
+    ArchivoMapeado archivo(rutaArchivo);
+
+    // Se valida y empaqueta en la misma pasada, directamente desde el mapeo:
+    // la cadena nunca se copia como texto
+    size_t total = leerEnParalelo<SospechosoEmpaquetado>(
+        archivo.contenido(), 0, false,
+        [](const SospechosoVista& vista, std::deque<std::string>&, SospechosoEmpaquetado& empaquetado) {
+            if (!SecuenciaEmpaquetada::empaquetarValidando(vista.cadenaADN, empaquetado.cadenaADN)) {
+                return false;
+            }
+            empaquetado.nombreCompleto = std::string(vista.nombreCompleto);
+            empaquetado.cedula = std::string(vista.cedula);
+            return true;
+        },
+        [&](SospechosoEmpaquetado&& empaquetado) { sospechosos.push_back(std::move(empaquetado)); });
+
+    exigirRegistros(total);
+    return sospechosos;
+}
+
+CSVMapeado::CSVMapeado(const std::string& rutaArchivo) : archivo(rutaArchivo) {
+    CSVParser::leerRegistros(archivo.contenido(), camposReescritos, [&](const SospechosoVista& vista) {
+        registros.push_back(vista);
+    });
+}
+
+CSVPorLotes::CSVPorLotes(const std::string& rutaArchivo, size_t presupuestoBytes)
+    : ruta(rutaArchivo),
+      bytesPorLote(std::max(BYTES_MINIMOS_POR_LOTE, presupuestoBytes / PARTES_DEL_PRESUPUESTO)) {
+    // Primera pasada: validar y medir, sin guardar nada de cada lote
+    std::deque<std::string> camposReescritos;
+    basesPorLongitud.assign(LONGITUDES_CORTAS, 0);
+    leerTramos([&](std::string_view tramo, int lineasAnteriores) {
+        camposReescritos.clear();
+        numRegistros += CSVParser::leerTramo(tramo, lineasAnteriores, camposReescritos,
+                                             [&](const SospechosoVista& vista) {
+            size_t longitud = vista.cadenaADN.length();
+            bases += longitud;
+            if (longitud < LONGITUDES_CORTAS) {
+                basesPorLongitud[longitud] += longitud;
+            }
+        });
+    });
+    exigirRegistros(numRegistros);
+}
+
+uint64_t CSVPorLotes::basesDesde(size_t longitudMinima) const {
+    uint64_t cortas = 0;
+    for (size_t longitud = 0; longitud < std::min(longitudMinima, LONGITUDES_CORTAS); longitud++) {
+        cortas += basesPorLongitud[longitud];
+    }
+    return bases - cortas;
+}
+
+void CSVPorLotes::recorrer(
+    const std::function<void(const std::vector<SospechosoVista>& lote, size_t primero)>& alLote
+) const {
+    std::deque<std::string> camposReescritos;
+    std::vector<SospechosoVista> lote;
+    size_t primero = 0;
+    uint64_t basesLeidas = 0;
 
-        if (!validarCadenaADN(sospechoso.cadenaADN)) {
-            throw std::runtime_error(
-                "Error en línea " + std::to_string(numeroLinea) +
-                ": cadena de ADN inválida (solo se permiten A, T, C, G)"
-            );
+    // Quien recorre confía en la primera pasada (total de registros, filas
+    // de los índices): un archivo que cambió no debe llegar a alLote
+    auto exigirSinCambios = [&](size_t registrosLeidos, bool completo) {
+        bool cambio = completo ? registrosLeidos != numRegistros || basesLeidas != bases
+                               : registrosLeidos > numRegistros || basesLeidas > bases;
+        if (cambio) {
+            throw std::runtime_error("El archivo cambió durante la búsqueda: " + ruta);
         }
+    };
 
-        if (sospechoso.cadenaADN.length() < 100) {
-            throw std::runtime_error(
-                "Error en línea " + std::to_string(numeroLinea) +
-                ": cadena de ADN muy corta (mínimo 100 caracteres)"
-            );
+    leerTramos([&](std::string_view tramo, int lineasAnteriores) {
+        camposReescritos.clear();
+        lote.clear();
+        CSVParser::leerTramo(tramo, lineasAnteriores, camposReescritos, [&](const SospechosoVista& vista) {
+            lote.push_back(vista);
+            basesLeidas += vista.cadenaADN.length();
+        });
+        if (lote.empty()) {
+            return;
         }
+        exigirSinCambios(primero + lote.size(), false);
+
+        TRAZA(Traza::DEPURACION, "Lote de " << lote.size() << " registros desde el " << primero);
+        alLote(lote, primero);
+        primero += lote.size();
+    });
 
-        sospechosos.push_back(sospechoso);
+    exigirSinCambios(primero, true);
+}
+
+void CSVPorLotes::leerTramos(
+    const std::function<void(std::string_view tramo, int lineasAnteriores)>& alTramo
+) const {
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> archivo(std::fopen(ruta.c_str(), "rb"), std::fclose);
+    if (!archivo) {
+        throw std::runtime_error("No se pudo abrir el archivo: " + ruta);
     }
 
-    archivo.close();
+    // Al principio del buffer queda la línea incompleta del tramo anterior
+    std::vector<char> buffer(bytesPorLote);
+    size_t usados = 0;
+    int lineasAnteriores = 0;
+    bool finArchivo = false;
 
-    if (sospechosos.empty()) {
-        throw std::runtime_error("El archivo CSV no contiene registros válidos");
+    bool primeraLectura = true;
+    while (!finArchivo) {
+        if (usados == buffer.size()) {
+            // Una sola línea no entra en el lote
+            buffer.resize(buffer.size() * 2);
+            TRAZA(Traza::INFORMACION, "Lote ampliado a " << buffer.size() << " bytes por una línea larga");
+        }
+
+        usados += std::fread(buffer.data() + usados, 1, buffer.size() - usados, archivo.get());
+        if (std::ferror(archivo.get())) {
+            // Un directorio se abre pero no se puede leer (como en ArchivoMapeado)
+            throw std::runtime_error(std::string(primeraLectura ? "No se pudo abrir el archivo: "
+                                                                : "No se pudo leer el archivo: ") + ruta);
+        }
+        primeraLectura = false;
+        finArchivo = std::feof(archivo.get()) != 0;
+
+        // Hasta el último salto de línea; al final del archivo, todo
+        size_t corte = usados;
+        if (!finArchivo) {
+            size_t ultimoSalto = std::string_view(buffer.data(), usados).rfind('\n');
+            corte = ultimoSalto != std::string_view::npos ? ultimoSalto + 1 : 0;
+        }
+        if (corte == 0) {
+            continue;
+        }
+
+        alTramo(std::string_view(buffer.data(), corte), lineasAnteriores);
+        lineasAnteriores += static_cast<int>(std::count(buffer.data(), buffer.data() + corte, '\n'));
+        std::memmove(buffer.data(), buffer.data() + corte, usados - corte);
+        usados -= corte;
     }
+}
 
-    return sospechosos;
+void CSVParser::leerRegistros(
+    std::string_view contenido,
+    std::deque<std::string>& camposReescritos,
+    const std::function<void(const SospechosoVista& sospechoso)>& alLeer
+) {
+    exigirRegistros(leerTramo(contenido, 0, camposReescritos, alLeer));
+}
+
+size_t CSVParser::leerTramo(
+    std::string_view tramo,
+    int lineasAnteriores,
+    std::deque<std::string>& camposReescritos,
+    const std::function<void(const SospechosoVista& sospechoso)>& alLeer
+) {
+    return leerEnParalelo<RegistroVista>(
+        tramo, lineasAnteriores, true,
+        [](const SospechosoVista& vista, std::deque<std::string>& camposConComillas, RegistroVista& registro) {
+            registro.vista = vista;
+            registro.camposConComillas.assign(std::make_move_iterator(camposConComillas.begin()),
+                                              std::make_move_iterator(camposConComillas.end()));
+            return true;
+        },
+        [&](RegistroVista&& registro) {
+            // Con comillas se reescribieron los 3 campos, en orden
+            if (!registro.camposConComillas.empty()) {
+                for (std::string& campo : registro.camposConComillas) {
+                    camposReescritos.push_back(std::move(campo));
+                }
+                auto campos = camposReescritos.end() - 3;
+                registro.vista = SospechosoVista{campos[0], campos[1], campos[2]};
+            }
+            alLeer(registro.vista);
+        });
+}
+
+SospechosoEmpaquetado CSVParser::parsearRegistro(std::string_view linea) {
+    std::deque<std::string> camposReescritos;
+    std::string_view campos[3];
+    size_t numCampos = dividirLinea(linea, campos, camposReescritos);
+    SospechosoVista vista = validarRegistro(campos, numCampos, 0);
+
+    SospechosoEmpaquetado sospechoso;
+    sospechoso.nombreCompleto = std::string(vista.nombreCompleto);
+    sospechoso.cedula = std::string(vista.cedula);
+    sospechoso.cadenaADN = SecuenciaEmpaquetada(vista.cadenaADN);
+    return sospechoso;
 }
 
-bool CSVParser::validarCadenaADN(const std::string& cadenaADN) {
-    if (cadenaADN.empty()) {
-        return false;
+SospechosoVista CSVParser::validarRegistro(
+    const std::string_view campos[3],
+    size_t numCampos,
+    int numeroLinea,
+    bool validarADN
+) {
+    // El mensaje solo se arma si hay error
+    auto contexto = [numeroLinea]() {
+        return numeroLinea > 0 ? "Error en línea " + std::to_string(numeroLinea) : std::string("Registro inválido");
+    };
+
+    // Validar que tenga exactamente 3 campos
+    if (numCampos != 3) {
+        throw std::runtime_error(
+            contexto() + ": se esperaban 3 campos, se encontraron " + std::to_string(numCampos)
+        );
     }
 
-    for (char c : cadenaADN) {
-        if (c != 'A' && c != 'T' && c != 'C' && c != 'G') {
-            return false;
-        }
+    SospechosoVista sospechoso;
+    sospechoso.nombreCompleto = campos[0];
+    sospechoso.cedula = campos[1];
+    sospechoso.cadenaADN = campos[2];
+
+    // Validaciones
+    if (sospechoso.nombreCompleto.empty()) {
+        throw std::runtime_error(contexto() + ": nombre vacío");
+    }
+
+    if (sospechoso.cedula.empty()) {
+        throw std::runtime_error(contexto() + ": cédula vacía");
+    }
+
+    if (validarADN && !validarCadenaADN(sospechoso.cadenaADN)) {
+        throw std::runtime_error(
+            contexto() + ": cadena de ADN inválida (solo se permiten A, T, C, G)"
+        );
+    }
+
+    if (sospechoso.cadenaADN.length() < 100) {
+        throw std::runtime_error(
+            contexto() + ": cadena de ADN muy corta (mínimo 100 caracteres)"
+        );
     }
 
-    return true;
+    return sospechoso;
 }
 
-std::vector<std::string> CSVParser::dividirLinea(const std::string& linea) {
-    std::vector<std::string> campos;
+bool CSVParser::validarCadenaADN(std::string_view cadenaADN) {
+    return !cadenaADN.empty() && ValidacionADN::validar(cadenaADN);
+}
+
+size_t CSVParser::dividirLinea(
+    std::string_view linea,
+    std::string_view campos[3],
+    std::deque<std::string>& camposReescritos
+) {
+    size_t numCampos = 0;
+
+    // Caso común: sin comillas, cada campo es una vista a la línea
+    if (linea.find('"') == std::string_view::npos) {
+        size_t inicio = 0;
+        while (true) {
+            size_t coma = linea.find(',', inicio);
+            size_t fin = (coma == std::string_view::npos) ? linea.length() : coma;
+
+            if (numCampos < 3) {
+                campos[numCampos] = trim(linea.substr(inicio, fin - inicio));
+            }
+            numCampos++;
+
+            if (coma == std::string_view::npos) {
+                return numCampos;
+            }
+            inicio = coma + 1;
+        }
+    }
+
+    // Con comillas: se quitan, así que el campo se reescribe
     std::string campoActual;
     bool dentroComillas = false;
 
-    for (size_t i = 0; i < linea.length(); i++) {
-        char c = linea[i];
+    auto cerrarCampo = [&]() {
+        if (numCampos < 3) {
+            camposReescritos.emplace_back(trim(campoActual));
+            campos[numCampos] = camposReescritos.back();
+        }
+        numCampos++;
+        campoActual.clear();
+    };
+
+    // Se copian tramos completos hasta la siguiente comilla (o coma fuera de comillas)
+    size_t inicio = 0;
+    while (inicio < linea.length()) {
+        size_t especial = inicio;
+        if (dentroComillas) {
+            especial = linea.find('"', inicio);
+        } else {
+            while (especial < linea.length() && linea[especial] != '"' && linea[especial] != ',') {
+                especial++;
+            }
+            if (especial == linea.length()) {
+                especial = std::string_view::npos;
+            }
+        }
+
+        if (especial == std::string_view::npos) {
+            campoActual.append(linea.substr(inicio));
+            break;
+        }
 
-        if (c == '"') {
+        campoActual.append(linea.substr(inicio, especial - inicio));
+        if (linea[especial] == '"') {
             dentroComillas = !dentroComillas;
-        } else if (c == ',' && !dentroComillas) {
-            campos.push_back(campoActual);
-            campoActual.clear();
         } else {
-            campoActual += c;
+            cerrarCampo();
         }
+        inicio = especial + 1;
     }
 
     // Agregar el último campo
-    campos.push_back(campoActual);
+    cerrarCampo();
 
-    return campos;
+    return numCampos;
 }
 
-std::string CSVParser::trim(const std::string& str) {
+std::string_view CSVParser::trim(std::string_view str) {
     size_t inicio = 0;
     size_t fin = str.length();
 
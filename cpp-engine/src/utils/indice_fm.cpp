@@ -0,0 +1,449 @@
+#include "../../include/indice_fm.h"
+#include "../../include/base_datos_binaria.h"
+#include "../../include/csv_parser.h"
+#include "../../include/cursor_bases.h"
+#include "../../include/huella_base.h"
+#include <fstream>
+#include <stdexcept>
+#include <cstring>
+#include <memory>
+#include <algorithm>
+#include <limits>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+const char MAGIA[4] = {'A', 'D', 'N', 'F'};
+const uint32_t VERSION = 2;
+// Los índices de la versión 1 no guardan huella: se abren, pero nunca corresponden
+const uint32_t VERSION_SIN_HUELLA = 1;
+const uint64_t FILAS_BLOQUE = 64;
+
+// Símbolos del texto: el terminador es el menor y único; el separador
+// cierra cada cadena (y reemplaza cualquier carácter que no sea base)
+const int TERMINADOR = 0;
+const int SEPARADOR = 1;
+const int PRIMERA_BASE = 2;
+
+struct Cabecera {
+    char magia[4];
+    uint32_t version;
+    uint32_t pasoMuestreo;
+    uint32_t reservado;
+    uint64_t numRegistros;
+    uint64_t totalBases;
+    uint64_t longitudTexto;
+    uint64_t anteriores[4];
+    uint64_t numBloques;
+    uint64_t numMuestras;
+    uint64_t offsetBloques;
+    uint64_t offsetMuestras;
+    uint64_t offsetInicios;
+    uint64_t tamanoArchivo;
+    uint64_t huella;            // Hash de las cadenas (HuellaBase)
+};
+
+static_assert(sizeof(Cabecera) == 128, "La cabecera .fm debe ocupar 128 bytes");
+
+// 64 filas de la BWT
+struct Bloque {
+    uint32_t ocurrencias[4];   // De cada base antes del bloque
+    uint32_t muestrasAntes;    // Filas muestreadas antes del bloque
+    uint32_t reservado;
+    uint64_t planoBajo;        // Bit 0 del código de cada fila
+    uint64_t planoAlto;        // Bit 1 del código de cada fila
+    uint64_t separadores;      // Filas cuyo carácter no es una base
+    uint64_t muestreadas;      // Filas con posición guardada
+};
+
+static_assert(sizeof(Bloque) == 56, "El bloque de la BWT debe ocupar 56 bytes");
+
+inline uint64_t contarBits(uint64_t x) {
+#ifdef _MSC_VER
+    return __popcnt64(x);
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+
+// Filas del bloque anteriores a "desplazamiento"
+inline uint64_t mascaraHasta(uint64_t desplazamiento) {
+    return desplazamiento == 0 ? 0 : ~0ULL >> (FILAS_BLOQUE - desplazamiento);
+}
+
+/**
+ * Arreglo de sufijos de s (símbolos en [0, maximo]) por SA-IS
+ * (Nong, Zhang y Chan): se ordenan los sufijos LMS, se inducen los demás
+ * y, si hay subcadenas LMS repetidas, se resuelve recursivamente sobre sus
+ * nombres
+ */
+std::vector<int> arregloSufijos(const std::vector<int>& s, int maximo) {
+    int n = static_cast<int>(s.size());
+    if (n == 0) return {};
+    if (n == 1) return {0};
+
+    // Cadenas muy cortas: comparar sufijos directamente
+    if (n < 10) {
+        std::vector<int> sa(n);
+        for (int i = 0; i < n; i++) sa[i] = i;
+        std::sort(sa.begin(), sa.end(), [&](int a, int b) {
+            return std::lexicographical_compare(s.begin() + a, s.end(), s.begin() + b, s.end());
+        });
+        return sa;
+    }
+
+    // Tipo de cada sufijo: S (menor que el siguiente) o L
+    std::vector<int> sa(n);
+    std::vector<bool> tipoS(n);
+    for (int i = n - 2; i >= 0; i--) {
+        tipoS[i] = s[i] == s[i + 1] ? tipoS[i + 1] : s[i] < s[i + 1];
+    }
+
+    // Inicio de la zona L y de la zona S de cada cubeta
+    std::vector<int> inicioL(maximo + 1), inicioS(maximo + 1);
+    for (int i = 0; i < n; i++) {
+        if (!tipoS[i]) {
+            inicioS[s[i]]++;
+        } else {
+            inicioL[s[i] + 1]++;
+        }
+    }
+    for (int c = 0; c <= maximo; c++) {
+        inicioS[c] += inicioL[c];
+        if (c < maximo) inicioL[c + 1] += inicioS[c];
+    }
+
+    auto inducir = [&](const std::vector<int>& lms) {
+        std::fill(sa.begin(), sa.end(), -1);
+        std::vector<int> cubeta(maximo + 1);
+
+        std::copy(inicioS.begin(), inicioS.end(), cubeta.begin());
+        for (int d : lms) {
+            if (d == n) continue;
+            sa[cubeta[s[d]]++] = d;
+        }
+
+        std::copy(inicioL.begin(), inicioL.end(), cubeta.begin());
+        sa[cubeta[s[n - 1]]++] = n - 1;
+        for (int i = 0; i < n; i++) {
+            int v = sa[i];
+            if (v >= 1 && !tipoS[v - 1]) {
+                sa[cubeta[s[v - 1]]++] = v - 1;
+            }
+        }
+
+        std::copy(inicioL.begin(), inicioL.end(), cubeta.begin());
+        for (int i = n - 1; i >= 0; i--) {
+            int v = sa[i];
+            if (v >= 1 && tipoS[v - 1]) {
+                sa[--cubeta[s[v - 1] + 1]] = v - 1;
+            }
+        }
+    };
+
+    // Sufijos LMS: tipo S precedidos por uno de tipo L
+    std::vector<int> numeroLms(n + 1, -1);
+    std::vector<int> lms;
+    for (int i = 1; i < n; i++) {
+        if (!tipoS[i - 1] && tipoS[i]) {
+            numeroLms[i] = static_cast<int>(lms.size());
+            lms.push_back(i);
+        }
+    }
+    int m = static_cast<int>(lms.size());
+
+    inducir(lms);
+
+    if (m > 0) {
+        std::vector<int> ordenados;
+        ordenados.reserve(m);
+        for (int v : sa) {
+            if (numeroLms[v] != -1) ordenados.push_back(v);
+        }
+
+        // Nombrar cada subcadena LMS; iguales reciben el mismo nombre
+        std::vector<int> reducida(m);
+        int maximoReducida = 0;
+        reducida[numeroLms[ordenados[0]]] = 0;
+        for (int i = 1; i < m; i++) {
+            int l = ordenados[i - 1];
+            int r = ordenados[i];
+            int finL = numeroLms[l] + 1 < m ? lms[numeroLms[l] + 1] : n;
+            int finR = numeroLms[r] + 1 < m ? lms[numeroLms[r] + 1] : n;
+
+            bool iguales = true;
+            if (finL - l != finR - r) {
+                iguales = false;
+            } else {
+                while (l < finL && s[l] == s[r]) {
+                    l++;
+                    r++;
+                }
+                if (l == n || s[l] != s[r]) iguales = false;
+            }
+            if (!iguales) maximoReducida++;
+            reducida[numeroLms[ordenados[i]]] = maximoReducida;
+        }
+
+        std::vector<int> saReducido = arregloSufijos(reducida, maximoReducida);
+        for (int i = 0; i < m; i++) {
+            ordenados[i] = lms[saReducido[i]];
+        }
+        inducir(ordenados);
+    }
+
+    return sa;
+}
+
+}
+
+IndiceFM::IndiceFM(const std::string& rutaArchivo) : archivo(rutaArchivo) {
+    std::string_view contenido = archivo.contenido();
+
+    Cabecera cabecera;
+    if (contenido.size() < sizeof(cabecera)) {
+        throw std::runtime_error("Índice FM inválido (archivo truncado): " + rutaArchivo);
+    }
+    std::memcpy(&cabecera, contenido.data(), sizeof(cabecera));
+
+    if (std::memcmp(cabecera.magia, MAGIA, sizeof(MAGIA)) != 0) {
+        throw std::runtime_error("El archivo no es un índice .fm: " + rutaArchivo);
+    }
+    bool sinHuella = cabecera.version == VERSION_SIN_HUELLA;
+    if ((cabecera.version != VERSION && !sinHuella) || cabecera.pasoMuestreo != PASO_MUESTREO) {
+        throw std::runtime_error("Versión de índice .fm no soportada: " + std::to_string(cabecera.version));
+    }
+
+    // Las secciones se leen en su lugar: deben estar alineadas y dentro del archivo
+    uint64_t tamano = contenido.size();
+    auto cabe = [&](uint64_t offset, uint64_t elementos, uint64_t tamanoElemento) {
+        return offset % sizeof(uint64_t) == 0 && offset <= tamano &&
+            elementos <= (tamano - offset) / tamanoElemento;
+    };
+    bool valido = cabecera.tamanoArchivo == tamano &&
+        cabecera.numBloques == cabecera.longitudTexto / FILAS_BLOQUE + 1 &&
+        cabe(cabecera.offsetBloques, cabecera.numBloques, sizeof(Bloque)) &&
+        cabe(cabecera.offsetMuestras, cabecera.numMuestras, sizeof(uint32_t)) &&
+        cabe(cabecera.offsetInicios, cabecera.numRegistros + 1, sizeof(uint64_t));
+
+    if (!valido) {
+        throw std::runtime_error("Índice FM inválido (secciones fuera del archivo): " + rutaArchivo);
+    }
+
+    numRegistros = cabecera.numRegistros;
+    tieneHuella = !sinHuella;
+    huella = HuellaBase::guardada(cabecera.numRegistros, cabecera.totalBases, cabecera.huella);
+    longitudTexto = cabecera.longitudTexto;
+    std::copy(cabecera.anteriores, cabecera.anteriores + 4, anteriores);
+    bloques = contenido.data() + cabecera.offsetBloques;
+    muestras = reinterpret_cast<const uint32_t*>(contenido.data() + cabecera.offsetMuestras);
+    inicios = reinterpret_cast<const uint64_t*>(contenido.data() + cabecera.offsetInicios);
+}
+
+size_t IndiceFM::construir(const std::string& rutaBase, const std::string& rutaSalida) {
+    std::unique_ptr<BaseDatosBinaria> base;
+    std::unique_ptr<CSVMapeado> csv;
+    if (BaseDatosBinaria::esRutaBinaria(rutaBase)) {
+        base.reset(new BaseDatosBinaria(rutaBase));
+    } else {
+        csv.reset(new CSVMapeado(rutaBase));
+    }
+
+    uint64_t numRegistros = base ? base->size() : csv->sospechosos().size();
+
+    // Texto: cada cadena seguida de un separador y, al final, el terminador
+    std::vector<int> texto;
+    std::vector<uint64_t> iniciosCadenas;
+    iniciosCadenas.reserve(numRegistros + 1);
+    HuellaBase huella;
+
+    auto agregar = [&](auto cursor, size_t n) {
+        iniciosCadenas.push_back(texto.size());
+        for (size_t i = 0; i < n; i++) {
+            int codigo = cursor.siguiente();
+            texto.push_back(codigo < 0 ? SEPARADOR : PRIMERA_BASE + codigo);
+        }
+        texto.push_back(SEPARADOR);
+    };
+
+    for (size_t fila = 0; fila < numRegistros; fila++) {
+        if (base && base->empaquetada()) {
+            SecuenciaEmpaquetada cadena = base->registroEmpaquetado(fila).cadenaADN;
+            agregar(CursorEmpaquetado{cadena, 0, 0}, cadena.longitud());
+            huella.agregar(cadena);
+        } else {
+            std::string_view cadena = base ? base->registro(fila).cadenaADN : csv->sospechosos()[fila].cadenaADN;
+            agregar(CursorTexto{cadena.data()}, cadena.length());
+            huella.agregar(cadena);
+        }
+    }
+    uint64_t totalBases = texto.size() - numRegistros;
+    iniciosCadenas.push_back(texto.size());
+    texto.push_back(TERMINADOR);
+
+    if (texto.size() > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+        throw std::runtime_error("La base es demasiado grande para un índice .fm");
+    }
+
+    std::vector<int> sufijos = arregloSufijos(texto, PRIMERA_BASE + 3);
+
+    // BWT por bloques y muestras del arreglo de sufijos. Se guarda la
+    // posición de toda fila cuyo carácter anterior no es una base, así
+    // ubicar una aparición nunca necesita retroceder sobre un separador
+    uint64_t n = texto.size();
+    std::vector<Bloque> bloquesBwt(n / FILAS_BLOQUE + 1);
+    std::vector<uint32_t> muestrasSufijos;
+    uint32_t ocurrencias[4] = {0, 0, 0, 0};
+
+    for (uint64_t fila = 0; fila <= n; fila++) {
+        Bloque& bloque = bloquesBwt[fila / FILAS_BLOQUE];
+        uint64_t bit = 1ULL << (fila % FILAS_BLOQUE);
+
+        if (fila % FILAS_BLOQUE == 0) {
+            std::memset(&bloque, 0, sizeof(bloque));
+            std::copy(ocurrencias, ocurrencias + 4, bloque.ocurrencias);
+            bloque.muestrasAntes = static_cast<uint32_t>(muestrasSufijos.size());
+        }
+        if (fila == n) break;
+
+        uint32_t posicion = static_cast<uint32_t>(sufijos[fila]);
+        int anterior = texto[posicion == 0 ? n - 1 : posicion - 1];
+
+        if (anterior >= PRIMERA_BASE) {
+            int codigo = anterior - PRIMERA_BASE;
+            if (codigo & 1) bloque.planoBajo |= bit;
+            if (codigo & 2) bloque.planoAlto |= bit;
+            ocurrencias[codigo]++;
+        } else {
+            bloque.separadores |= bit;
+        }
+
+        if (anterior < PRIMERA_BASE || posicion % PASO_MUESTREO == 0) {
+            bloque.muestreadas |= bit;
+            muestrasSufijos.push_back(posicion);
+        }
+    }
+
+    // Las filas empiezan por el terminador, los separadores y luego cada base
+    Cabecera cabecera;
+    std::memset(&cabecera, 0, sizeof(cabecera));
+    std::memcpy(cabecera.magia, MAGIA, sizeof(MAGIA));
+    cabecera.version = VERSION;
+    cabecera.pasoMuestreo = PASO_MUESTREO;
+    cabecera.numRegistros = numRegistros;
+    cabecera.totalBases = totalBases;
+    cabecera.longitudTexto = n;
+    cabecera.huella = huella.hash();
+
+    uint64_t acumuladas = n - totalBases;
+    for (int codigo = 0; codigo < 4; codigo++) {
+        cabecera.anteriores[codigo] = acumuladas;
+        acumuladas += ocurrencias[codigo];
+    }
+
+    cabecera.numBloques = bloquesBwt.size();
+    cabecera.numMuestras = muestrasSufijos.size();
+    cabecera.offsetBloques = sizeof(Cabecera);
+    cabecera.offsetMuestras = cabecera.offsetBloques + bloquesBwt.size() * sizeof(Bloque);
+    uint64_t bytesMuestras = muestrasSufijos.size() * sizeof(uint32_t);
+    uint64_t relleno = (sizeof(uint64_t) - bytesMuestras % sizeof(uint64_t)) % sizeof(uint64_t);
+    cabecera.offsetInicios = cabecera.offsetMuestras + bytesMuestras + relleno;
+    cabecera.tamanoArchivo = cabecera.offsetInicios + iniciosCadenas.size() * sizeof(uint64_t);
+
+    std::ofstream salida(rutaSalida, std::ios::binary | std::ios::trunc);
+    if (!salida.is_open()) {
+        throw std::runtime_error("No se pudo crear el archivo: " + rutaSalida);
+    }
+
+    const char ceros[sizeof(uint64_t)] = {0};
+    salida.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+    salida.write(reinterpret_cast<const char*>(bloquesBwt.data()), bloquesBwt.size() * sizeof(Bloque));
+    salida.write(reinterpret_cast<const char*>(muestrasSufijos.data()), bytesMuestras);
+    salida.write(ceros, relleno);
+    salida.write(reinterpret_cast<const char*>(iniciosCadenas.data()), iniciosCadenas.size() * sizeof(uint64_t));
+
+    if (!salida.good()) {
+        throw std::runtime_error("Error al escribir el archivo: " + rutaSalida);
+    }
+
+    return numRegistros;
+}
+
+std::string IndiceFM::rutaPara(const std::string& rutaBase) {
+    return rutaBase + ".fm";
+}
+
+bool IndiceFM::corresponde(const HuellaBase& base) const {
+    return tieneHuella && huella == base;
+}
+
+uint64_t IndiceFM::rank(int codigo, uint64_t fila) const {
+    const Bloque& bloque = static_cast<const Bloque*>(bloques)[fila / FILAS_BLOQUE];
+    uint64_t iguales = (codigo & 1 ? bloque.planoBajo : ~bloque.planoBajo) &
+                       (codigo & 2 ? bloque.planoAlto : ~bloque.planoAlto) &
+                       ~bloque.separadores;
+    return bloque.ocurrencias[codigo] + contarBits(iguales & mascaraHasta(fila % FILAS_BLOQUE));
+}
+
+void IndiceFM::rango(std::string_view patron, uint64_t& desde, uint64_t& hasta) const {
+    // Búsqueda hacia atrás: se agrega una base del patrón por paso, de la última a la primera
+    desde = 0;
+    hasta = longitudTexto;
+    for (size_t i = patron.length(); i > 0 && desde < hasta; i--) {
+        int codigo = codigoBase(patron[i - 1]);
+        if (codigo < 0) {
+            desde = hasta = 0;
+            return;
+        }
+        desde = anteriores[codigo] + rank(codigo, desde);
+        hasta = anteriores[codigo] + rank(codigo, hasta);
+    }
+}
+
+uint64_t IndiceFM::posicionDe(uint64_t fila) const {
+    // Retroceder en el texto (LF) hasta una fila muestreada
+    uint64_t pasos = 0;
+    for (;;) {
+        const Bloque& bloque = static_cast<const Bloque*>(bloques)[fila / FILAS_BLOQUE];
+        uint64_t desplazamiento = fila % FILAS_BLOQUE;
+        uint64_t bit = 1ULL << desplazamiento;
+
+        if (bloque.muestreadas & bit) {
+            uint64_t indice = bloque.muestrasAntes + contarBits(bloque.muestreadas & mascaraHasta(desplazamiento));
+            return muestras[indice] + pasos;
+        }
+
+        int codigo = ((bloque.planoBajo & bit) ? 1 : 0) | ((bloque.planoAlto & bit) ? 2 : 0);
+        fila = anteriores[codigo] + rank(codigo, fila);
+        pasos++;
+    }
+}
+
+size_t IndiceFM::contar(std::string_view patron) const {
+    uint64_t desde = 0;
+    uint64_t hasta = 0;
+    rango(patron, desde, hasta);
+    return hasta - desde;
+}
+
+std::vector<OcurrenciaFM> IndiceFM::localizar(std::string_view patron) const {
+    uint64_t desde = 0;
+    uint64_t hasta = 0;
+    rango(patron, desde, hasta);
+
+    std::vector<OcurrenciaFM> ocurrencias;
+    ocurrencias.reserve(hasta - desde);
+
+    for (uint64_t fila = desde; fila < hasta; fila++) {
+        uint64_t posicion = posicionDe(fila);
+
+        // Cadena que contiene la posición: el último inicio <= posicion
+        const uint64_t* siguiente = std::upper_bound(inicios, inicios + numRegistros, posicion);
+        uint64_t registro = (siguiente - inicios) - 1;
+        ocurrencias.push_back({static_cast<uint32_t>(registro), static_cast<uint32_t>(posicion - inicios[registro])});
+    }
+
+    return ocurrencias;
+}
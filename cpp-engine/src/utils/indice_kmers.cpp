@@ -0,0 +1,417 @@
+#include "../../include/indice_kmers.h"
+#include "../../include/base_datos_binaria.h"
+#include "../../include/csv_parser.h"
+#include "../../include/cursor_bases.h"
+#include "../../include/huella_base.h"
+#include <fstream>
+#include <stdexcept>
+#include <cstring>
+#include <memory>
+#include <algorithm>
+#include <limits>
+#include <iterator>
+
+namespace {
+
+const char MAGIA[4] = {'A', 'D', 'N', 'K'};
+const uint32_t VERSION = 2;
+// Los índices de la versión 1 no guardan huella: se abren, pero nunca corresponden
+const uint32_t VERSION_SIN_HUELLA = 1;
+const uint32_t MASCARA_KMER = (1u << (2 * IndiceKmers::K)) - 1;
+
+// El directorio tiene una cubeta por cada prefijo de 16 bits del k-mer
+const int BITS_SUFIJO = 2 * IndiceKmers::K - 16;
+const size_t NUM_CUBETAS = size_t(1) << 16;
+
+struct Cabecera {
+    char magia[4];
+    uint32_t version;
+    uint32_t k;
+    uint32_t paso;
+    uint64_t numRegistros;
+    uint64_t totalBases;
+    uint64_t numKmers;
+    uint64_t offsetDirectorio;
+    uint64_t offsetListas;
+    uint64_t tamanoListas;
+    uint64_t tamanoArchivo;
+    uint64_t huella;            // Hash de las cadenas (HuellaBase)
+};
+
+static_assert(sizeof(Cabecera) == 80, "La cabecera .adnk debe ocupar 80 bytes");
+
+/**
+ * Entrega cada k-mer completo de una secuencia con su posición de inicio
+ * (el primer carácter queda en los bits altos)
+ */
+template <typename Cursor, typename Visitar>
+void recorrerKmers(Cursor cursor, size_t n, Visitar visitar) {
+    uint32_t kmer = 0;
+    int validas = 0;  // Bases válidas seguidas al final de la ventana
+
+    for (size_t i = 0; i < n; i++) {
+        int codigo = cursor.siguiente();
+        if (codigo < 0) {
+            validas = 0;
+            continue;
+        }
+        kmer = ((kmer << 2) | codigo) & MASCARA_KMER;
+        if (++validas >= IndiceKmers::K) {
+            visitar(kmer, i + 1 - IndiceKmers::K);
+        }
+    }
+}
+
+void escribirVarint(std::string& salida, uint64_t valor) {
+    while (valor >= 0x80) {
+        salida.push_back(static_cast<char>((valor & 0x7F) | 0x80));
+        valor >>= 7;
+    }
+    salida.push_back(static_cast<char>(valor));
+}
+
+uint64_t leerVarint(const unsigned char*& actual, const unsigned char* fin) {
+    uint64_t valor = 0;
+    for (int desplazamiento = 0; desplazamiento < 64; desplazamiento += 7) {
+        if (actual == fin) {
+            break;
+        }
+        unsigned char byte = *actual++;
+        valor |= static_cast<uint64_t>(byte & 0x7F) << desplazamiento;
+        if ((byte & 0x80) == 0) {
+            return valor;
+        }
+    }
+    throw std::runtime_error("Índice de k-mers inválido: lista truncada");
+}
+
+// Intersección de dos listas ordenadas de (sospechoso, inicio)
+std::vector<std::pair<uint32_t, uint32_t>> intersectar(
+    const std::vector<std::pair<uint32_t, uint32_t>>& a,
+    const std::vector<std::pair<uint32_t, uint32_t>>& b
+) {
+    std::vector<std::pair<uint32_t, uint32_t>> comunes;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(comunes));
+    return comunes;
+}
+
+}
+
+IndiceKmers::IndiceKmers(const std::string& rutaArchivo) : archivo(rutaArchivo) {
+    std::string_view contenido = archivo.contenido();
+
+    Cabecera cabecera;
+    if (contenido.size() < sizeof(cabecera)) {
+        throw std::runtime_error("Índice de k-mers inválido (archivo truncado): " + rutaArchivo);
+    }
+    std::memcpy(&cabecera, contenido.data(), sizeof(cabecera));
+
+    if (std::memcmp(cabecera.magia, MAGIA, sizeof(MAGIA)) != 0) {
+        throw std::runtime_error("El archivo no es un índice .adnk: " + rutaArchivo);
+    }
+    bool sinHuella = cabecera.version == VERSION_SIN_HUELLA;
+    if ((cabecera.version != VERSION && !sinHuella) || cabecera.k != static_cast<uint32_t>(K) || cabecera.paso != PASO) {
+        throw std::runtime_error("Versión de índice .adnk no soportada: " + std::to_string(cabecera.version));
+    }
+
+    uint64_t tamano = contenido.size();
+    bool valido = cabecera.tamanoArchivo == tamano &&
+        cabecera.offsetDirectorio <= tamano &&
+        (NUM_CUBETAS + 1) <= (tamano - cabecera.offsetDirectorio) / sizeof(uint64_t) &&
+        cabecera.offsetListas <= tamano && cabecera.tamanoListas <= tamano - cabecera.offsetListas;
+
+    if (!valido) {
+        throw std::runtime_error("Índice de k-mers inválido (secciones fuera del archivo): " + rutaArchivo);
+    }
+
+    numRegistros = cabecera.numRegistros;
+    tieneHuella = !sinHuella;
+    huella = HuellaBase::guardada(cabecera.numRegistros, cabecera.totalBases, cabecera.huella);
+    numEntradas = cabecera.numKmers;
+    directorio = contenido.data() + cabecera.offsetDirectorio;
+    listas = contenido.data() + cabecera.offsetListas;
+    tamanoListas = cabecera.tamanoListas;
+}
+
+size_t IndiceKmers::construir(const std::string& rutaBase, const std::string& rutaSalida) {
+    // La base se abre una vez y se recorre dos veces (contar y llenar)
+    std::unique_ptr<BaseDatosBinaria> base;
+    std::unique_ptr<CSVMapeado> csv;
+    if (BaseDatosBinaria::esRutaBinaria(rutaBase)) {
+        base.reset(new BaseDatosBinaria(rutaBase));
+    } else {
+        csv.reset(new CSVMapeado(rutaBase));
+    }
+
+    uint64_t numRegistros = base ? base->size() : csv->sospechosos().size();
+
+    // Solo se indexan los k-mers que empiezan en múltiplos de PASO
+    auto recorrerBase = [&](auto visitar) {
+        for (size_t fila = 0; fila < numRegistros; fila++) {
+            auto visitarFila = [&](uint32_t kmer, size_t posicion) {
+                if (posicion % PASO == 0) {
+                    visitar(kmer, fila, posicion);
+                }
+            };
+
+            if (base && base->empaquetada()) {
+                SecuenciaEmpaquetada cadena = base->registroEmpaquetado(fila).cadenaADN;
+                recorrerKmers(CursorEmpaquetado{cadena, 0, 0}, cadena.longitud(), visitarFila);
+            } else {
+                std::string_view cadena = base ? base->registro(fila).cadenaADN : csv->sospechosos()[fila].cadenaADN;
+                recorrerKmers(CursorTexto{cadena.data()}, cadena.length(), visitarFila);
+            }
+        }
+    };
+
+    // Pasada 1: apariciones de cada k-mer
+    std::vector<uint32_t> inicioKmer(static_cast<size_t>(MASCARA_KMER) + 2, 0);
+    uint64_t totalApariciones = 0;
+    recorrerBase([&](uint32_t kmer, size_t, size_t) {
+        inicioKmer[kmer + 1]++;
+        totalApariciones++;
+    });
+
+    if (numRegistros > std::numeric_limits<uint32_t>::max() ||
+        totalApariciones > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("La base es demasiado grande para un índice .adnk");
+    }
+
+    HuellaBase huella;
+    for (size_t fila = 0; fila < numRegistros; fila++) {
+        if (base && base->empaquetada()) {
+            huella.agregar(base->registroEmpaquetado(fila).cadenaADN);
+        } else {
+            huella.agregar(base ? base->registro(fila).cadenaADN : csv->sospechosos()[fila].cadenaADN);
+        }
+    }
+
+    for (size_t kmer = 1; kmer < inicioKmer.size(); kmer++) {
+        inicioKmer[kmer] += inicioKmer[kmer - 1];
+    }
+
+    // Pasada 2: (sospechoso, posición) de cada aparición, ya ordenadas por k-mer
+    // y, dentro de cada k-mer, por sospechoso y posición
+    std::vector<uint64_t> apariciones(totalApariciones);
+    std::vector<uint32_t> siguiente(inicioKmer.begin(), inicioKmer.end() - 1);
+    recorrerBase([&](uint32_t kmer, size_t fila, size_t posicion) {
+        apariciones[siguiente[kmer]++] = (static_cast<uint64_t>(fila) << 32) | posicion;
+    });
+
+    // Directorio (inicio de cada cubeta) y listas comprimidas. Cada k-mer
+    // presente se guarda en su cubeta como: sufijo (1 byte), apariciones,
+    // bytes de la lista y la lista
+    std::vector<uint64_t> cubetas(NUM_CUBETAS + 1, 0);
+    std::string comprimidas;
+    std::string lista;
+    size_t numKmers = 0;
+
+    for (uint32_t kmer = 0; kmer <= MASCARA_KMER; kmer++) {
+        if ((kmer & ((1u << BITS_SUFIJO) - 1)) == 0) {
+            cubetas[kmer >> BITS_SUFIJO] = comprimidas.size();
+        }
+
+        uint32_t desde = inicioKmer[kmer];
+        uint32_t hasta = inicioKmer[kmer + 1];
+        if (desde == hasta) {
+            continue;
+        }
+
+        lista.clear();
+        uint64_t filaAnterior = 0;
+        uint64_t posicionAnterior = 0;
+        for (uint32_t i = desde; i < hasta; i++) {
+            uint64_t fila = apariciones[i] >> 32;
+            uint64_t posicion = apariciones[i] & 0xFFFFFFFF;
+
+            escribirVarint(lista, fila - filaAnterior);
+            escribirVarint(lista, fila == filaAnterior ? posicion - posicionAnterior : posicion);
+            filaAnterior = fila;
+            posicionAnterior = posicion;
+        }
+
+        comprimidas.push_back(static_cast<char>(kmer & ((1u << BITS_SUFIJO) - 1)));
+        escribirVarint(comprimidas, hasta - desde);
+        escribirVarint(comprimidas, lista.size());
+        comprimidas += lista;
+        numKmers++;
+    }
+    cubetas[NUM_CUBETAS] = comprimidas.size();
+
+    Cabecera cabecera;
+    std::memset(&cabecera, 0, sizeof(cabecera));
+    std::memcpy(cabecera.magia, MAGIA, sizeof(MAGIA));
+    cabecera.version = VERSION;
+    cabecera.k = K;
+    cabecera.paso = PASO;
+    cabecera.numRegistros = numRegistros;
+    cabecera.totalBases = huella.bases();
+    cabecera.huella = huella.hash();
+    cabecera.numKmers = numKmers;
+    cabecera.offsetDirectorio = sizeof(Cabecera);
+    cabecera.offsetListas = cabecera.offsetDirectorio + cubetas.size() * sizeof(uint64_t);
+    cabecera.tamanoListas = comprimidas.size();
+    cabecera.tamanoArchivo = cabecera.offsetListas + comprimidas.size();
+
+    std::ofstream salida(rutaSalida, std::ios::binary | std::ios::trunc);
+    if (!salida.is_open()) {
+        throw std::runtime_error("No se pudo crear el archivo: " + rutaSalida);
+    }
+
+    salida.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+    salida.write(reinterpret_cast<const char*>(cubetas.data()), cubetas.size() * sizeof(uint64_t));
+    salida.write(comprimidas.data(), comprimidas.size());
+
+    if (!salida.good()) {
+        throw std::runtime_error("Error al escribir el archivo: " + rutaSalida);
+    }
+
+    return numKmers;
+}
+
+bool IndiceKmers::corresponde(const HuellaBase& base) const {
+    return tieneHuella && huella == base;
+}
+
+uint32_t IndiceKmers::frecuencia(uint32_t kmer, uint64_t& inicioLista) const {
+    uint64_t limites[2];
+    std::memcpy(limites, directorio + (kmer >> BITS_SUFIJO) * sizeof(uint64_t), sizeof(limites));
+    if (limites[0] > limites[1] || limites[1] > tamanoListas) {
+        throw std::runtime_error("Índice de k-mers inválido: cubeta fuera de rango");
+    }
+
+    // Recorrer los k-mers de la cubeta (ordenados por sufijo) saltando sus listas
+    const unsigned char* actual = reinterpret_cast<const unsigned char*>(listas) + limites[0];
+    const unsigned char* fin = reinterpret_cast<const unsigned char*>(listas) + limites[1];
+    unsigned sufijo = kmer & ((1u << BITS_SUFIJO) - 1);
+
+    while (actual < fin) {
+        unsigned sufijoActual = *actual++;
+        uint64_t apariciones = leerVarint(actual, fin);
+        uint64_t bytesLista = leerVarint(actual, fin);
+        if (bytesLista > static_cast<uint64_t>(fin - actual)) {
+            throw std::runtime_error("Índice de k-mers inválido: lista truncada");
+        }
+
+        if (sufijoActual == sufijo) {
+            inicioLista = actual - reinterpret_cast<const unsigned char*>(listas);
+            return static_cast<uint32_t>(apariciones);
+        }
+        if (sufijoActual > sufijo) {
+            break;
+        }
+        actual += bytesLista;
+    }
+
+    return 0;
+}
+
+std::vector<std::pair<uint32_t, uint32_t>> IndiceKmers::alineaciones(
+    uint64_t inicioLista,
+    uint32_t apariciones,
+    uint32_t desplazamiento
+) const {
+    const unsigned char* actual = reinterpret_cast<const unsigned char*>(listas) + inicioLista;
+    const unsigned char* fin = reinterpret_cast<const unsigned char*>(listas) + tamanoListas;
+
+    std::vector<std::pair<uint32_t, uint32_t>> resultado;
+    resultado.reserve(apariciones);
+
+    uint64_t fila = 0;
+    uint64_t posicion = 0;
+    for (uint32_t i = 0; i < apariciones; i++) {
+        uint64_t diferenciaFila = leerVarint(actual, fin);
+        uint64_t valorPosicion = leerVarint(actual, fin);
+        fila += diferenciaFila;
+        posicion = diferenciaFila == 0 ? posicion + valorPosicion : valorPosicion;
+
+        if (posicion >= desplazamiento) {
+            resultado.push_back({static_cast<uint32_t>(fila), static_cast<uint32_t>(posicion - desplazamiento)});
+        }
+    }
+
+    return resultado;
+}
+
+bool IndiceKmers::planificar(const std::vector<std::string>& patrones, std::vector<size_t>& filas) const {
+    std::vector<size_t> candidatas;
+
+    struct KmerPatron {
+        uint32_t apariciones;
+        uint32_t desplazamiento;   // Dentro del patrón
+        uint64_t inicioLista;
+    };
+
+    for (const auto& patron : patrones) {
+        // Cada clase de desplazamiento necesita al menos un k-mer
+        if (patron.length() + 1 < static_cast<size_t>(K + PASO)) {
+            return false;
+        }
+
+        // Una coincidencia que empieza en s tiene indexados los k-mers del
+        // patrón en los desplazamientos j con (s + j) % PASO == 0: se agrupan
+        // por j % PASO y cada grupo propone los inicios de su clase
+        std::vector<std::vector<KmerPatron>> clases(PASO);
+        recorrerKmers(CursorTexto{patron.data()}, patron.length(), [&](uint32_t kmer, size_t posicion) {
+            uint64_t inicioLista = 0;
+            uint32_t apariciones = frecuencia(kmer, inicioLista);
+            clases[posicion % PASO].push_back({apariciones, static_cast<uint32_t>(posicion), inicioLista});
+        });
+
+        for (auto& kmers : clases) {
+            // Los más raros que no se solapan entre sí
+            std::stable_sort(kmers.begin(), kmers.end(), [](const KmerPatron& a, const KmerPatron& b) {
+                return a.apariciones < b.apariciones;
+            });
+
+            // Un k-mer que no está en la base: ninguna coincidencia de esta clase
+            if (kmers[0].apariciones == 0) {
+                continue;
+            }
+
+            // Ni el k-mer más raro es selectivo: recorrer toda la base
+            if (kmers[0].apariciones > numRegistros) {
+                return false;
+            }
+
+            std::vector<KmerPatron> elegidos;
+            for (const auto& kmer : kmers) {
+                if (static_cast<int>(elegidos.size()) == KMERS_POR_PATRON) break;
+
+                bool solapa = false;
+                for (const auto& elegido : elegidos) {
+                    uint32_t distancia = kmer.desplazamiento > elegido.desplazamiento
+                        ? kmer.desplazamiento - elegido.desplazamiento
+                        : elegido.desplazamiento - kmer.desplazamiento;
+                    solapa = solapa || distancia < static_cast<uint32_t>(K);
+                }
+                if (!solapa) {
+                    elegidos.push_back(kmer);
+                }
+            }
+
+            // Inicios de alineación en los que coinciden todos los k-mers elegidos
+            std::vector<std::pair<uint32_t, uint32_t>> acuerdo = alineaciones(
+                elegidos[0].inicioLista, elegidos[0].apariciones, elegidos[0].desplazamiento);
+            for (size_t i = 1; i < elegidos.size() && !acuerdo.empty(); i++) {
+                acuerdo = intersectar(acuerdo, alineaciones(
+                    elegidos[i].inicioLista, elegidos[i].apariciones, elegidos[i].desplazamiento));
+            }
+
+            for (const auto& alineacion : acuerdo) {
+                candidatas.push_back(alineacion.first);
+            }
+        }
+    }
+
+    std::sort(candidatas.begin(), candidatas.end());
+    candidatas.erase(std::unique(candidatas.begin(), candidatas.end()), candidatas.end());
+
+    // Con muchos candidatos, verificarlos cuesta casi lo mismo que recorrer todo
+    if (candidatas.size() > numRegistros / 4) {
+        return false;
+    }
+
+    filas = std::move(candidatas);
+    return true;
+}
@@ -0,0 +1,149 @@
+#include "../../include/instantanea.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+/**
+ * Vista a un sospechoso que ya no se va a mover
+ */
+SospechosoEmpaquetadoVista vistaDe(const SospechosoEmpaquetado& sospechoso) {
+    return {
+        sospechoso.nombreCompleto,
+        sospechoso.cedula,
+        SecuenciaEmpaquetada::vista(sospechoso.cadenaADN.datos(), sospechoso.cadenaADN.longitud())
+    };
+}
+
+}
+
+std::shared_ptr<const Instantanea> Instantanea::cargar(const std::string& ruta, uint64_t version) {
+    auto instantanea = std::make_shared<Instantanea>();
+    instantanea->numeroVersion = version;
+
+    std::vector<Registro> registros;
+
+    if (BaseDatosBinaria::esRutaBinaria(ruta)) {
+        auto base = std::make_shared<const BaseDatosBinaria>(ruta);
+
+        if (base->empaquetada()) {
+            // Las vistas apuntan al mapeo, que vive mientras algún registro lo use
+            for (size_t i = 0; i < base->size(); i++) {
+                registros.push_back({base->registroEmpaquetado(i), base});
+            }
+        } else {
+            std::vector<SospechosoEmpaquetado> empaquetados;
+            for (size_t i = 0; i < base->size(); i++) {
+                SospechosoVista vista = base->registro(i);
+                empaquetados.push_back({
+                    std::string(vista.nombreCompleto),
+                    std::string(vista.cedula),
+                    SecuenciaEmpaquetada(vista.cadenaADN)
+                });
+            }
+            auto datos = std::make_shared<const std::vector<SospechosoEmpaquetado>>(std::move(empaquetados));
+            for (const auto& sospechoso : *datos) {
+                registros.push_back({vistaDe(sospechoso), datos});
+            }
+        }
+    } else {
+        // Todos los registros comparten el vector: lo que se quita después
+        // se libera con la próxima carga (o cuando no quede ninguno)
+        auto datos = std::make_shared<const std::vector<SospechosoEmpaquetado>>(CSVParser::parsearEmpaquetado(ruta));
+        for (const auto& sospechoso : *datos) {
+            registros.push_back({vistaDe(sospechoso), datos});
+        }
+    }
+
+    for (size_t inicio = 0; inicio < registros.size(); inicio += TAMANO_SEGMENTO) {
+        size_t fin = std::min(inicio + TAMANO_SEGMENTO, registros.size());
+        instantanea->segmentos.push_back(std::make_shared<const Segmento>(
+            std::make_move_iterator(registros.begin() + inicio),
+            std::make_move_iterator(registros.begin() + fin)
+        ));
+    }
+    instantanea->indexar();
+    return instantanea;
+}
+
+Instantanea::Registro Instantanea::crearRegistro(SospechosoEmpaquetado sospechoso) {
+    auto dueno = std::make_shared<const SospechosoEmpaquetado>(std::move(sospechoso));
+    return {vistaDe(*dueno), dueno};
+}
+
+std::shared_ptr<const Instantanea> Instantanea::agregar(const std::vector<Registro>& registros) const {
+    auto nueva = std::make_shared<Instantanea>(*this);
+    nueva->numeroVersion = numeroVersion + 1;
+
+    for (const Registro& registro : registros) {
+        // Solo se copia el último segmento mientras tenga lugar
+        if (nueva->segmentos.empty() || nueva->segmentos.back()->size() >= TAMANO_SEGMENTO) {
+            nueva->segmentos.push_back(std::make_shared<const Segmento>(1, registro));
+        } else {
+            auto ultimo = std::make_shared<Segmento>(*nueva->segmentos.back());
+            ultimo->push_back(registro);
+            nueva->segmentos.back() = std::move(ultimo);
+        }
+    }
+
+    nueva->indexar();
+    return nueva;
+}
+
+std::shared_ptr<const Instantanea> Instantanea::quitar(
+    std::string_view cedula,
+    std::vector<Registro>& quitados
+) const {
+    std::shared_ptr<Instantanea> nueva;
+
+    for (size_t s = 0; s < segmentos.size(); s++) {
+        const Segmento& segmento = *segmentos[s];
+        bool contiene = std::any_of(segmento.begin(), segmento.end(),
+                                    [&](const Registro& registro) { return registro.vista.cedula == cedula; });
+        if (!contiene) {
+            continue;
+        }
+
+        if (!nueva) {
+            nueva = std::make_shared<Instantanea>(*this);
+            nueva->numeroVersion = numeroVersion + 1;
+        }
+
+        // Copia del segmento sin los registros de la cédula
+        auto restante = std::make_shared<Segmento>();
+        for (const Registro& registro : segmento) {
+            if (registro.vista.cedula == cedula) {
+                quitados.push_back(registro);
+            } else {
+                restante->push_back(registro);
+            }
+        }
+        nueva->segmentos[s] = std::move(restante);
+    }
+
+    if (!nueva) {
+        return nullptr;
+    }
+
+    // Los segmentos que quedaron vacíos se descartan
+    auto& nuevos = nueva->segmentos;
+    nuevos.erase(std::remove_if(nuevos.begin(), nuevos.end(),
+                                [](const std::shared_ptr<const Segmento>& segmento) { return segmento->empty(); }),
+                 nuevos.end());
+    nueva->indexar();
+    return nueva;
+}
+
+const SospechosoEmpaquetadoVista& Instantanea::operator[](size_t i) const {
+    size_t s = std::upper_bound(inicios.begin(), inicios.end(), i) - inicios.begin() - 1;
+    return (*segmentos[s])[i - inicios[s]].vista;
+}
+
+void Instantanea::indexar() {
+    inicios.clear();
+    total = 0;
+    for (const auto& segmento : segmentos) {
+        inicios.push_back(total);
+        total += segmento->size();
+    }
+}
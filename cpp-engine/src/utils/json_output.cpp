@@ -8,8 +8,11 @@ std::string JSONOutput::generarExito(
     const std::string& criterioSeleccion,
     int totalProcesados,
     const std::vector<Coincidencia>& coincidencias,
-    long tiempoEjecucionMs
+    long tiempoEjecucionMs,
+    bool cacheHit,
+    const Metricas* metricas
 ) {
+    Cronometro cronometro;
     std::ostringstream json;
 
     json << "{\n";
@@ -39,7 +42,9 @@ std::string JSONOutput::generarExito(
         json << "      \"cedula\": \"" << escaparJSON(coincidencias[i].cedula) << "\",\n";
         json << "      \"patron_id\": " << coincidencias[i].patronId << ",\n";
         json << "      \"patron\": \"" << escaparJSON(coincidencias[i].patron) << "\",\n";
-        json << "      \"posicion\": " << coincidencias[i].posicion << "\n";
+        json << "      \"posicion\": " << coincidencias[i].posicion << ",\n";
+        json << "      \"distancia\": " << coincidencias[i].distancia << ",\n";
+        json << "      \"hebra\": \"" << coincidencias[i].hebra << "\"\n";
         json << "    }";
 
         if (i < coincidencias.size() - 1) {
@@ -49,12 +54,162 @@ std::string JSONOutput::generarExito(
     }
     json << "  ],\n";
 
+    json << "  \"cache_hit\": " << (cacheHit ? "true" : "false") << ",\n";
+    json << "  \"tiempo_ejecucion_ms\": " << tiempoEjecucionMs;
+
+    if (metricas != nullptr) {
+        Metricas conSerializacion = *metricas;
+        conSerializacion.serializacionNs += cronometro.nanosegundos();
+        json << ",\n  \"metricas\": " << generarMetricas(conSerializacion);
+    }
+
+    json << "\n}";
+
+    return json.str();
+}
+
+std::string JSONOutput::generarBaseConstruida(
+    const std::string& rutaSalida,
+    size_t totalRegistros,
+    bool empaquetada,
+    long tiempoEjecucionMs
+) {
+    std::ostringstream json;
+
+    json << "{\n";
+    json << "  \"exito\": true,\n";
+    json << "  \"base_datos\": \"" << escaparJSON(rutaSalida) << "\",\n";
+    json << "  \"total_registros\": " << totalRegistros << ",\n";
+    json << "  \"adn_empaquetado\": " << (empaquetada ? "true" : "false") << ",\n";
     json << "  \"tiempo_ejecucion_ms\": " << tiempoEjecucionMs << "\n";
     json << "}";
 
     return json.str();
 }
 
+std::string JSONOutput::generarIndiceConstruido(
+    const std::string& rutaSalida,
+    size_t numKmers,
+    long tiempoEjecucionMs
+) {
+    std::ostringstream json;
+
+    json << "{\n";
+    json << "  \"exito\": true,\n";
+    json << "  \"indice\": \"" << escaparJSON(rutaSalida) << "\",\n";
+    json << "  \"kmers_distintos\": " << numKmers << ",\n";
+    json << "  \"tiempo_ejecucion_ms\": " << tiempoEjecucionMs << "\n";
+    json << "}";
+
+    return json.str();
+}
+
+std::string JSONOutput::generarIndiceFMConstruido(
+    const std::string& rutaSalida,
+    size_t totalRegistros,
+    long tiempoEjecucionMs
+) {
+    std::ostringstream json;
+
+    json << "{\n";
+    json << "  \"exito\": true,\n";
+    json << "  \"indice_fm\": \"" << escaparJSON(rutaSalida) << "\",\n";
+    json << "  \"total_registros\": " << totalRegistros << ",\n";
+    json << "  \"tiempo_ejecucion_ms\": " << tiempoEjecucionMs << "\n";
+    json << "}";
+
+    return json.str();
+}
+
+std::string JSONOutput::generarPerfilCalibrado(
+    const std::string& rutaSalida,
+    long tiempoEjecucionMs
+) {
+    std::ostringstream json;
+
+    json << "{\n";
+    json << "  \"exito\": true,\n";
+    json << "  \"perfil\": \"" << escaparJSON(rutaSalida) << "\",\n";
+    json << "  \"tiempo_ejecucion_ms\": " << tiempoEjecucionMs << "\n";
+    json << "}";
+
+    return json.str();
+}
+
+std::string JSONOutput::generarResultadoLote(
+    const std::string& id,
+    const std::vector<std::string>& patrones,
+    const std::string& algoritmoUsado,
+    const std::string& criterioSeleccion,
+    int totalProcesados,
+    const std::vector<Coincidencia>& coincidencias,
+    long tiempoEjecucionMs
+) {
+    std::ostringstream json;
+
+    json << "{\"id\":\"" << escaparJSON(id) << "\",\"exito\":true,\"patrones\":[";
+    for (size_t i = 0; i < patrones.size(); i++) {
+        if (i > 0) json << ",";
+        json << "\"" << escaparJSON(patrones[i]) << "\"";
+    }
+    json << "],\"num_patrones\":" << patrones.size();
+    json << ",\"algoritmo_usado\":\"" << algoritmoUsado << "\"";
+    json << ",\"criterio_seleccion\":\"" << escaparJSON(criterioSeleccion) << "\"";
+    json << ",\"total_procesados\":" << totalProcesados;
+    json << ",\"total_coincidencias\":" << coincidencias.size();
+
+    json << ",\"coincidencias\":[";
+    for (size_t i = 0; i < coincidencias.size(); i++) {
+        if (i > 0) json << ",";
+        json << "{\"nombre\":\"" << escaparJSON(coincidencias[i].nombre) << "\"";
+        json << ",\"cedula\":\"" << escaparJSON(coincidencias[i].cedula) << "\"";
+        json << ",\"patron_id\":" << coincidencias[i].patronId;
+        json << ",\"patron\":\"" << escaparJSON(coincidencias[i].patron) << "\"";
+        json << ",\"posicion\":" << coincidencias[i].posicion;
+        json << ",\"distancia\":" << coincidencias[i].distancia;
+        json << ",\"hebra\":\"" << coincidencias[i].hebra << "\"}";
+    }
+    json << "],\"cache_hit\":false,\"tiempo_ejecucion_ms\":" << tiempoEjecucionMs << "}";
+
+    return json.str();
+}
+
+std::string JSONOutput::generarErrorLote(
+    const std::string& id,
+    const std::string& mensajeError,
+    const std::string& codigoError,
+    const std::string& detalles
+) {
+    std::ostringstream json;
+
+    json << "{\"id\":\"" << escaparJSON(id) << "\",\"exito\":false";
+    json << ",\"error\":\"" << escaparJSON(mensajeError) << "\"";
+    json << ",\"codigo_error\":\"" << codigoError << "\"";
+    json << ",\"detalles\":\"" << escaparJSON(detalles) << "\"}";
+
+    return json.str();
+}
+
+std::string JSONOutput::generarMetricas(const Metricas& metricas) {
+    std::ostringstream json;
+
+    json << "{\"tiempos_ns\":{";
+    json << "\"parseo_argumentos\":" << metricas.parseoArgumentosNs;
+    json << ",\"ingesta\":" << metricas.ingestaNs;
+    json << ",\"validacion\":" << metricas.validacionNs;
+    json << ",\"construccion\":" << metricas.construccionNs;
+    json << ",\"recorrido\":" << metricas.recorridoNs;
+    json << ",\"serializacion\":" << metricas.serializacionNs;
+    json << "},\"bases_recorridas\":" << metricas.basesRecorridas;
+    json << ",\"sospechosos_omitidos\":" << metricas.sospechososOmitidos;
+    json << ",\"estados_automata\":" << metricas.estadosAutomata;
+    json << ",\"saltos_enlace_fallo\":" << metricas.saltosEnlaceFallo;
+    json << ",\"colisiones_hash\":" << metricas.colisionesHash;
+    json << ",\"pico_memoria_bytes\":" << metricas.picoMemoriaBytes << "}";
+
+    return json.str();
+}
+
 std::string JSONOutput::generarError(
     const std::string& mensajeError,
     const std::string& codigoError,
@@ -73,35 +228,36 @@ std::string JSONOutput::generarError(
 }
 
 std::string JSONOutput::escaparJSON(const std::string& str) {
-    std::ostringstream escapado;
+    std::string escapado;
+    escapado.reserve(str.size());
 
     for (char c : str) {
         switch (c) {
             case '"':
-                escapado << "\\\"";
+                escapado += "\\\"";
                 break;
             case '\\':
-                escapado << "\\\\";
+                escapado += "\\\\";
                 break;
             case '\b':
-                escapado << "\\b";
+                escapado += "\\b";
                 break;
             case '\f':
-                escapado << "\\f";
+                escapado += "\\f";
                 break;
             case '\n':
-                escapado << "\\n";
+                escapado += "\\n";
                 break;
             case '\r':
-                escapado << "\\r";
+                escapado += "\\r";
                 break;
             case '\t':
-                escapado << "\\t";
+                escapado += "\\t";
                 break;
             default:
-                escapado << c;
+                escapado += c;
         }
     }
 
-    return escapado.str();
+    return escapado;
 }
@@ -0,0 +1,247 @@
+#include "../../include/lote_consultas.h"
+#include "../../include/archivo_mapeado.h"
+#include "../../include/motor_busqueda.h"
+#include <cctype>
+#include <stdexcept>
+
+namespace {
+
+bool esEspacio(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/**
+ * Lector JSON mínimo para una línea de consulta: objetos, arreglos,
+ * cadenas, números y literales (los valores que no se usan se saltan)
+ */
+class LectorJSON {
+public:
+    explicit LectorJSON(std::string_view texto) : texto(texto) {}
+
+    void saltarEspacios() {
+        while (pos < texto.size() && esEspacio(texto[pos])) {
+            pos++;
+        }
+    }
+
+    bool terminado() {
+        saltarEspacios();
+        return pos >= texto.size();
+    }
+
+    char siguiente() {
+        saltarEspacios();
+        if (pos >= texto.size()) {
+            throw std::runtime_error("JSON incompleto");
+        }
+        return texto[pos];
+    }
+
+    void esperar(char c) {
+        if (siguiente() != c) {
+            throw std::runtime_error(std::string("se esperaba '") + c + "' en la columna " + std::to_string(pos + 1));
+        }
+        pos++;
+    }
+
+    bool consumir(char c) {
+        if (siguiente() == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    std::string leerCadena() {
+        esperar('"');
+        std::string valor;
+        while (true) {
+            if (pos >= texto.size()) {
+                throw std::runtime_error("cadena sin cerrar");
+            }
+            char c = texto[pos++];
+            if (c == '"') {
+                return valor;
+            }
+            if (c != '\\') {
+                valor += c;
+                continue;
+            }
+            if (pos >= texto.size()) {
+                throw std::runtime_error("cadena sin cerrar");
+            }
+            char escape = texto[pos++];
+            switch (escape) {
+                case '"':  valor += '"'; break;
+                case '\\': valor += '\\'; break;
+                case '/':  valor += '/'; break;
+                case 'b':  valor += '\b'; break;
+                case 'f':  valor += '\f'; break;
+                case 'n':  valor += '\n'; break;
+                case 'r':  valor += '\r'; break;
+                case 't':  valor += '\t'; break;
+                case 'u':  valor += leerUnicode(); break;
+                default:
+                    throw std::runtime_error(std::string("escape inválido \\") + escape);
+            }
+        }
+    }
+
+    /**
+     * Número o literal (true, false, null) tal como está escrito
+     */
+    std::string leerAtomo() {
+        saltarEspacios();
+        size_t inicio = pos;
+        while (pos < texto.size() && !esEspacio(texto[pos]) &&
+               texto[pos] != ',' && texto[pos] != '}' && texto[pos] != ']') {
+            pos++;
+        }
+        if (pos == inicio) {
+            throw std::runtime_error("valor vacío en la columna " + std::to_string(pos + 1));
+        }
+        return std::string(texto.substr(inicio, pos - inicio));
+    }
+
+    void saltarValor() {
+        char c = siguiente();
+        if (c == '"') {
+            leerCadena();
+        } else if (c == '{' || c == '[') {
+            char cierre = c == '{' ? '}' : ']';
+            pos++;
+            if (consumir(cierre)) return;
+            do {
+                if (cierre == '}') {
+                    leerCadena();
+                    esperar(':');
+                }
+                saltarValor();
+            } while (consumir(','));
+            esperar(cierre);
+        } else {
+            leerAtomo();
+        }
+    }
+
+private:
+    std::string_view texto;
+    size_t pos = 0;
+
+    /**
+     * \uXXXX en UTF-8 (los patrones son ASCII; basta con el plano básico)
+     */
+    std::string leerUnicode() {
+        if (pos + 4 > texto.size()) {
+            throw std::runtime_error("escape \\u incompleto");
+        }
+        unsigned codigo = 0;
+        for (size_t i = 0; i < 4; i++) {
+            char c = texto[pos++];
+            int digito = std::isxdigit(static_cast<unsigned char>(c))
+                ? (std::isdigit(static_cast<unsigned char>(c)) ? c - '0' : (std::tolower(c) - 'a' + 10))
+                : -1;
+            if (digito < 0) {
+                throw std::runtime_error("escape \\u inválido");
+            }
+            codigo = codigo * 16 + digito;
+        }
+
+        std::string utf8;
+        if (codigo < 0x80) {
+            utf8 += static_cast<char>(codigo);
+        } else if (codigo < 0x800) {
+            utf8 += static_cast<char>(0xC0 | (codigo >> 6));
+            utf8 += static_cast<char>(0x80 | (codigo & 0x3F));
+        } else {
+            utf8 += static_cast<char>(0xE0 | (codigo >> 12));
+            utf8 += static_cast<char>(0x80 | ((codigo >> 6) & 0x3F));
+            utf8 += static_cast<char>(0x80 | (codigo & 0x3F));
+        }
+        return utf8;
+    }
+};
+
+}
+
+std::vector<ConsultaLote> LoteConsultas::leer(const std::string& rutaArchivo) {
+    ArchivoMapeado archivo(rutaArchivo);
+    std::string_view contenido = archivo.contenido();
+
+    std::vector<ConsultaLote> consultas;
+    int numeroLinea = 0;
+    size_t inicio = 0;
+    while (inicio < contenido.size()) {
+        size_t fin = contenido.find('\n', inicio);
+        if (fin == std::string_view::npos) fin = contenido.size();
+        std::string_view linea = contenido.substr(inicio, fin - inicio);
+        inicio = fin + 1;
+        numeroLinea++;
+
+        if (linea.find_first_not_of(" \t\r") == std::string_view::npos) {
+            continue;
+        }
+
+        try {
+            consultas.push_back(interpretarLinea(linea, numeroLinea));
+        } catch (const std::exception& e) {
+            ConsultaLote consulta;
+            consulta.id = std::to_string(numeroLinea);
+            consulta.error = "Línea " + std::to_string(numeroLinea) + ": " + e.what();
+            consultas.push_back(consulta);
+        }
+    }
+
+    if (consultas.empty()) {
+        throw std::runtime_error("El archivo de consultas no contiene consultas: " + rutaArchivo);
+    }
+    return consultas;
+}
+
+ConsultaLote LoteConsultas::interpretarLinea(std::string_view linea, int numeroLinea) {
+    LectorJSON lector(linea);
+    ConsultaLote consulta;
+    consulta.id = std::to_string(numeroLinea);
+    bool tienePatrones = false;
+
+    lector.esperar('{');
+    if (!lector.consumir('}')) {
+        do {
+            std::string clave = lector.leerCadena();
+            lector.esperar(':');
+
+            if (clave == "id") {
+                consulta.id = lector.siguiente() == '"' ? lector.leerCadena() : lector.leerAtomo();
+            } else if (clave == "patrones") {
+                tienePatrones = true;
+                if (lector.siguiente() == '"') {
+                    consulta.patrones = MotorBusqueda::dividirPatrones(lector.leerCadena());
+                } else {
+                    lector.esperar('[');
+                    if (!lector.consumir(']')) {
+                        do {
+                            // Mismo recorte de espacios que en la línea de comandos
+                            std::string patron = lector.leerCadena();
+                            size_t inicio = patron.find_first_not_of(" \t\r\n");
+                            size_t fin = patron.find_last_not_of(" \t\r\n");
+                            consulta.patrones.push_back(
+                                inicio == std::string::npos ? std::string() : patron.substr(inicio, fin - inicio + 1));
+                        } while (lector.consumir(','));
+                        lector.esperar(']');
+                    }
+                }
+            } else {
+                lector.saltarValor();
+            }
+        } while (lector.consumir(','));
+        lector.esperar('}');
+    }
+
+    if (!lector.terminado()) {
+        throw std::runtime_error("texto de más después del objeto");
+    }
+    if (!tienePatrones) {
+        throw std::runtime_error("falta \"patrones\"");
+    }
+    return consulta;
+}
@@ -0,0 +1,29 @@
+#include "../../include/metricas.h"
+
+#ifdef _WIN32
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+uint64_t Metricas::leerPicoMemoria() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS contadores;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &contadores, sizeof(contadores))) {
+        return 0;
+    }
+    return contadores.PeakWorkingSetSize;
+#else
+    rusage uso;
+    if (getrusage(RUSAGE_SELF, &uso) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<uint64_t>(uso.ru_maxrss);         // macOS: bytes
+#else
+    return static_cast<uint64_t>(uso.ru_maxrss) * 1024;  // Linux: KiB
+#endif
+#endif
+}
@@ -0,0 +1,1054 @@
+#include "../../include/motor_busqueda.h"
+#include "../../include/kmp.h"
+#include "../../include/rabin_karp.h"
+#include "../../include/aho_corasick.h"
+#include "../../include/busqueda_simd.h"
+#include "../../include/algorithm_selector.h"
+#include "../../include/pool_hilos.h"
+#include "../../include/base_datos_binaria.h"
+#include "../../include/instantanea.h"
+#include "../../include/indice_fm.h"
+#include "../../include/perfil_costos.h"
+#include "../../include/traza.h"
+#include "../../include/almacen_sospechosos.h"
+#include <sstream>
+#include <set>
+#include <algorithm>
+#include <tuple>
+#include <map>
+#include <atomic>
+#include <type_traits>
+
+std::vector<std::string> MotorBusqueda::dividirPatrones(const std::string& entrada) {
+    std::vector<std::string> resultado;
+    std::stringstream ss(entrada);
+    std::string item;
+
+    while (std::getline(ss, item, ',')) {
+        // Eliminar espacios en blanco, tabs, retornos de carro y saltos de línea
+        size_t inicio = item.find_first_not_of(" \t\r\n");
+        size_t fin = item.find_last_not_of(" \t\r\n");
+
+        if (inicio != std::string::npos && fin != std::string::npos) {
+            resultado.push_back(item.substr(inicio, fin - inicio + 1));
+        }
+    }
+
+    return resultado;
+}
+
+std::string MotorBusqueda::complementoInverso(const std::string& patron) {
+    std::string complemento(patron.rbegin(), patron.rend());
+    for (char& base : complemento) {
+        switch (base) {
+            case 'A': base = 'T'; break;
+            case 'T': base = 'A'; break;
+            case 'C': base = 'G'; break;
+            case 'G': base = 'C'; break;
+        }
+    }
+    return complemento;
+}
+
+std::vector<std::string> MotorBusqueda::patronesDeBusqueda(const std::vector<std::string>& patrones,
+                                                           const OpcionesBusqueda& opciones) {
+    std::vector<std::string> busqueda = patrones;
+    if (opciones.ambasHebras) {
+        for (const auto& patron : patrones) {
+            busqueda.push_back(complementoInverso(patron));
+        }
+    }
+    return busqueda;
+}
+
+void MotorBusqueda::validarPatrones(const std::vector<std::string>& patrones) {
+    if (patrones.empty()) {
+        throw ErrorBusqueda(
+            "No se especificaron patrones",
+            "EMPTY_PATTERN",
+            "Debe proporcionar al menos un patrón de ADN"
+        );
+    }
+
+    for (size_t i = 0; i < patrones.size(); i++) {
+        const std::string& patron = patrones[i];
+
+        if (!CSVParser::validarCadenaADN(patron)) {
+            std::ostringstream msg;
+            msg << "Patrón " << (i + 1) << " inválido: \"" << patron << "\"";
+            throw ErrorBusqueda(
+                msg.str(),
+                "INVALID_PATTERN",
+                "Los patrones solo pueden contener los caracteres A, T, C, G"
+            );
+        }
+
+        if (patron.length() < 100 || patron.length() > 1000) {
+            std::ostringstream msg;
+            msg << "Patrón " << (i + 1) << " tiene longitud inválida: " << patron.length();
+            throw ErrorBusqueda(
+                msg.str(),
+                "INVALID_PATTERN_LENGTH",
+                "Cada patrón debe tener entre 100 y 1000 caracteres"
+            );
+        }
+    }
+}
+
+void MotorBusqueda::validarOpciones(const std::vector<std::string>& patrones, const OpcionesBusqueda& opciones) {
+    size_t longitudMinima = patrones.empty() ? 0 : patrones[0].length();
+    for (const auto& patron : patrones) {
+        longitudMinima = std::min(longitudMinima, patron.length());
+    }
+
+    // Con k >= longitud, cualquier texto coincidiría
+    if (opciones.maxErrores >= 0 && static_cast<size_t>(opciones.maxErrores) >= longitudMinima) {
+        std::ostringstream msg;
+        msg << "Número máximo de errores inválido: " << opciones.maxErrores;
+        throw ErrorBusqueda(
+            msg.str(),
+            "INVALID_MAX_ERRORS",
+            "--max-errors debe ser menor que la longitud del patrón más corto (" +
+                std::to_string(longitudMinima) + ")"
+        );
+    }
+}
+
+namespace {
+
+// Sospechosos por tramo en streaming: las coincidencias de un tramo salen
+// antes de recorrer el siguiente
+const size_t SOSPECHOSOS_POR_TRAMO = 16384;
+
+// Una cadena larga se parte en ~TRAMOS_POR_HILO tramos por hilo, de al
+// menos BASES_MINIMAS_POR_TRAMO (el solapamiento es < 1000 bases)
+const size_t TRAMOS_POR_HILO = 4;
+const size_t BASES_MINIMAS_POR_TRAMO = 1 << 16;
+
+// Coincidencia guardada por un hilo antes de unir los resultados
+struct CoincidenciaEncontrada {
+    size_t indice;     // Posición del sospechoso en el vector de entrada
+    int patronId;
+    int posicion;
+    int distancia;
+};
+
+// Contadores de un hilo del recorrido (en su propia línea de caché)
+struct alignas(64) ContadoresHilo {
+    uint64_t bases = 0;
+    uint64_t saltosEnlace = 0;
+    uint64_t colisiones = 0;
+};
+
+void sumarContadores(const ContadoresHilo& contadores, Metricas& metricas) {
+    metricas.basesRecorridas += contadores.bases;
+    metricas.saltosEnlaceFallo += contadores.saltosEnlace;
+    metricas.colisionesHash += contadores.colisiones;
+}
+
+// Registros de una base .adnb vistos como colección
+struct RegistrosTexto {
+    const BaseDatosBinaria& base;
+    size_t size() const { return base.size(); }
+    SospechosoVista operator[](size_t i) const { return base.registro(i); }
+};
+
+struct RegistrosEmpaquetados {
+    const BaseDatosBinaria& base;
+    size_t size() const { return base.size(); }
+    SospechosoEmpaquetadoVista operator[](size_t i) const { return base.registroEmpaquetado(i); }
+};
+
+// Solo las filas elegidas por el índice de k-mers, en el mismo orden
+template <typename TColeccion>
+struct Subconjunto {
+    const TColeccion& base;
+    const std::vector<size_t>& filas;
+    size_t size() const { return filas.size(); }
+    decltype(auto) operator[](size_t i) const { return base[filas[i]]; }
+};
+
+/**
+ * Cédulas ya reportadas. Las numéricas canónicas (ver TextoCedula) van a
+ * una tabla plana de enteros; solo las demás se guardan como texto. Un
+ * texto numérico canónico y su número son la misma cédula.
+ */
+class ConjuntoCedulas {
+public:
+    /**
+     * @return false si la cédula ya estaba
+     */
+    bool insertar(std::string_view cedula) {
+        uint64_t numero;
+        if (TextoCedula::leerNumero(cedula, numero)) {
+            return insertarNumero(numero);
+        }
+        return textos.insert(std::string(cedula)).second;
+    }
+
+    bool insertar(const TextoCedula& cedula) {
+        if (cedula.esNumerica()) {
+            return insertarNumero(cedula.numero());
+        }
+        return insertar(static_cast<std::string_view>(cedula));
+    }
+
+private:
+    // Cada casilla guarda número + 1 (0 es una casilla libre)
+    std::vector<uint64_t> casillas;
+    size_t ocupadas = 0;
+    std::set<std::string> textos;
+
+    static size_t mezclar(uint64_t valor) {
+        valor ^= valor >> 33;
+        valor *= 0xFF51AFD7ED558CCDULL;
+        valor ^= valor >> 33;
+        return static_cast<size_t>(valor);
+    }
+
+    bool insertarNumero(uint64_t numero) {
+        // Se duplica al pasar de la mitad de carga
+        if ((ocupadas + 1) * 2 > casillas.size()) {
+            std::vector<uint64_t> anteriores(std::max<size_t>(casillas.size() * 2, 64), 0);
+            anteriores.swap(casillas);
+            for (uint64_t clave : anteriores) {
+                if (clave != 0) {
+                    ubicar(clave) = clave;
+                }
+            }
+        }
+
+        uint64_t& casilla = ubicar(numero + 1);
+        if (casilla != 0) {
+            return false;
+        }
+        casilla = numero + 1;
+        ocupadas++;
+        return true;
+    }
+
+    // Casilla de la clave, o la libre donde iría (sondeo lineal)
+    uint64_t& ubicar(uint64_t clave) {
+        size_t mascara = casillas.size() - 1;
+        size_t i = mezclar(clave) & mascara;
+        while (casillas[i] != 0 && casillas[i] != clave) {
+            i = (i + 1) & mascara;
+        }
+        return casillas[i];
+    }
+};
+
+/**
+ * Pasa las coincidencias (ordenadas por sospechoso) al resultado, o al
+ * receptor si la búsqueda es en streaming
+ * @param patrones Los de la consulta: un patronId >= patrones.size() es el
+ *        complemento inverso del patrón patronId - patrones.size()
+ * @param cedulasEncontradas Cédulas ya reportadas (se conserva entre tramos)
+ */
+template <typename TColeccion>
+void entregarCoincidencias(
+    const std::vector<std::string>& patrones,
+    const TColeccion& sospechosos,
+    const std::vector<CoincidenciaEncontrada>& encontradas,
+    ConjuntoCedulas& cedulasEncontradas,
+    const OpcionesBusqueda& opciones,
+    ResultadoBusqueda& resultado
+) {
+    bool multiplesPatrones = patrones.size() >= 2;
+
+    for (const auto& encontrada : encontradas) {
+        decltype(auto) sospechoso = sospechosos[encontrada.indice];
+        bool inversa = encontrada.patronId >= static_cast<int>(patrones.size());
+        int patronId = inversa ? encontrada.patronId - static_cast<int>(patrones.size()) : encontrada.patronId;
+        char hebra = inversa ? '-' : '+';
+
+        // Con múltiples patrones, cada persona se reporta una sola vez
+        if (multiplesPatrones && !cedulasEncontradas.insertar(sospechoso.cedula)) {
+            continue;
+        }
+
+        if (opciones.receptor != nullptr) {
+            opciones.receptor->coincidencia({
+                sospechoso.nombreCompleto,
+                sospechoso.cedula,
+                patronId,
+                encontrada.posicion,
+                encontrada.distancia,
+                hebra
+            });
+            continue;
+        }
+
+        Coincidencia coincidencia;
+        coincidencia.nombre = std::string(sospechoso.nombreCompleto);
+        coincidencia.cedula = std::string(sospechoso.cedula);
+        coincidencia.patronId = patronId;
+        coincidencia.patron = patrones[patronId];
+        coincidencia.posicion = encontrada.posicion;
+        coincidencia.distancia = encontrada.distancia;
+        coincidencia.hebra = hebra;
+        resultado.coincidencias.push_back(coincidencia);
+    }
+}
+
+uint64_t longitudCadena(std::string_view cadenaADN) { return cadenaADN.length(); }
+uint64_t longitudCadena(const SecuenciaEmpaquetada& cadenaADN) { return cadenaADN.longitud(); }
+
+/**
+ * Vista a las bases [inicio, inicio + largo) de una cadena (en una
+ * empaquetada, inicio debe ser múltiplo de 32)
+ */
+std::string_view tramoDe(std::string_view cadenaADN, size_t inicio, size_t largo) {
+    return cadenaADN.substr(inicio, largo);
+}
+SecuenciaEmpaquetada tramoDe(const SecuenciaEmpaquetada& cadenaADN, size_t inicio, size_t largo) {
+    return SecuenciaEmpaquetada::vista(cadenaADN.datos() + inicio / 32, largo);
+}
+
+/**
+ * Carga de trabajo de los patrones (sin la base) para el modelo de costos
+ */
+CargaTrabajo cargaDePatrones(const std::vector<std::string>& patrones) {
+    CargaTrabajo carga;
+    carga.numPatrones = patrones.size();
+    std::set<size_t> longitudes;
+    for (const auto& patron : patrones) {
+        carga.longitudTotalPatrones += patron.length();
+        longitudes.insert(patron.length());
+    }
+    carga.numLongitudes = longitudes.size();
+    carga.longitudMinimaPatron = longitudes.empty() ? 0 : *longitudes.begin();
+    return carga;
+}
+
+/**
+ * Carga de trabajo de recorrer la colección para el modelo de costos
+ */
+template <typename TColeccion>
+CargaTrabajo medirCarga(const std::vector<std::string>& patrones, const TColeccion& sospechosos) {
+    CargaTrabajo carga = cargaDePatrones(patrones);
+    carga.numSecuencias = sospechosos.size();
+    for (size_t i = 0; i < sospechosos.size(); i++) {
+        uint64_t longitud = longitudCadena(sospechosos[i].cadenaADN);
+        carga.totalBases += longitud;
+        if (longitud >= carga.longitudMinimaPatron) {
+            carga.basesRecorridas += longitud;
+        }
+    }
+    return carga;
+}
+
+/**
+ * Primera coincidencia de un patrón con un motor de un solo patrón
+ */
+template <typename TCadena, typename TPatron>
+int buscarPatron(AlgorithmSelector::Algorithm algoritmo, const TCadena& cadenaADN, const TPatron& patron,
+                 ContadoresHilo& contadores) {
+    switch (algoritmo) {
+        case AlgorithmSelector::KMP:
+            return KMP::buscar(cadenaADN, patron);
+
+        case AlgorithmSelector::RABIN_KARP:
+            return RabinKarp::buscar(cadenaADN, patron, &contadores.colisiones);
+
+        case AlgorithmSelector::SIMD:
+            return BusquedaSIMD::buscar(cadenaADN, patron);
+
+        default:
+            // AHO_CORASICK usa el autómata; MYERS y HAMMING solo la búsqueda aproximada
+            return -1;
+    }
+}
+
+/**
+ * Búsqueda sobre sospechosos en texto o empaquetados
+ * @param consulta Los patrones pedidos (los que se reportan)
+ * @param patrones Los que se buscan (ver MotorBusqueda::patronesDeBusqueda)
+ * @param patronesBusqueda Los patrones en la misma representación que las cadenas
+ * @param lotes Recorre la base: lotes(alLote) llama a alLote(sospechosos,
+ *        primero) con cada lote, en orden. sospechosos es cualquier
+ *        colección con size() y operator[] cuyos elementos tengan
+ *        nombreCompleto, cedula y cadenaADN (una base en memoria es un solo lote)
+ * @param carga Carga de la base completa (los lotes pueden ser solo el
+ *        subconjunto elegido por el índice): con ella se elige el algoritmo
+ */
+template <typename TPatron, typename TLotes>
+ResultadoBusqueda ejecutarSobre(
+    const std::vector<std::string>& consulta,
+    const std::vector<std::string>& patrones,
+    const std::vector<TPatron>& patronesBusqueda,
+    TLotes lotes,
+    const CargaTrabajo& carga,
+    const OpcionesBusqueda& opciones
+) {
+    Cronometro cronometro;
+    ResultadoBusqueda resultado;
+    const PerfilCostos& perfil = opciones.perfil != nullptr ? *opciones.perfil : PerfilCostos::porDefecto();
+
+    // Seleccionar algoritmo óptimo (la búsqueda aproximada la decide el usuario)
+    bool aproximada = opciones.maxErrores >= 0;
+    AlgorithmSelector::Algorithm algoritmoSeleccionado = !aproximada
+        ? AlgorithmSelector::seleccionar(carga, perfil)
+        : opciones.distancia == BusquedaAproximada::HAMMING
+        ? AlgorithmSelector::HAMMING
+        : AlgorithmSelector::MYERS;
+
+    resultado.algoritmo = AlgorithmSelector::toString(algoritmoSeleccionado);
+    resultado.criterio = AlgorithmSelector::obtenerCriterio(algoritmoSeleccionado, carga, perfil);
+    resultado.totalProcesados = carga.numSecuencias;
+
+    // El autómata se construye una sola vez para todos los sospechosos
+    // (y solo si se va a usar)
+    AhoCorasick automata(algoritmoSeleccionado == AlgorithmSelector::AHO_CORASICK
+                             ? patrones : std::vector<std::string>());
+    RabinKarpMultiple rabinKarpMultiple(algoritmoSeleccionado == AlgorithmSelector::RABIN_KARP_MULTIPLE
+                                            ? patrones : std::vector<std::string>());
+
+    std::vector<BusquedaAproximada> buscadoresAproximados;
+    if (aproximada) {
+        for (const auto& patron : patrones) {
+            buscadoresAproximados.emplace_back(patron, opciones.maxErrores, opciones.distancia);
+        }
+    }
+
+    if (opciones.metricas != nullptr) {
+        opciones.metricas->construccionNs += cronometro.reiniciar();
+        if (algoritmoSeleccionado == AlgorithmSelector::AHO_CORASICK) {
+            opciones.metricas->estadosAutomata += automata.numEstados();
+        }
+    }
+
+    // Primera coincidencia en una cadena (o en un tramo de ella): posición -1 si no hay
+    auto buscarEnCadena = [&](const auto& cadenaADN, ContadoresHilo& contadores) {
+        contadores.bases += longitudCadena(cadenaADN);
+        int patronId = 0;
+        int posicion = -1;
+        int distancia = 0;
+
+        if (aproximada) {
+            // CASO: --max-errors → la coincidencia aproximada más a la izquierda
+            for (size_t id = 0; id < buscadoresAproximados.size(); id++) {
+                CoincidenciaAproximada c = buscadoresAproximados[id].buscarEn(cadenaADN);
+                if (c.posicion != -1 && (posicion == -1 || c.posicion < posicion)) {
+                    patronId = id;
+                    posicion = c.posicion;
+                    distancia = c.distancia;
+                }
+            }
+        } else if (algoritmoSeleccionado == AlgorithmSelector::AHO_CORASICK) {
+            // Todos los patrones en una pasada (búsqueda simultánea)
+            // Solo se registra la PRIMERA coincidencia: el recorrido se corta ahí
+            automata.buscarEn(cadenaADN, AhoCorasick::PRIMERA, [&](const CoincidenciaMultiple& c) {
+                patronId = c.patronId;
+                posicion = c.posicion;
+            }, &contadores.saltosEnlace);
+        } else if (algoritmoSeleccionado == AlgorithmSelector::RABIN_KARP_MULTIPLE) {
+            // Todos los patrones en una pasada, con el mismo criterio que Aho-Corasick
+            CoincidenciaMultiple c;
+            if (rabinKarpMultiple.buscarPrimera(cadenaADN, c, &contadores.colisiones)) {
+                patronId = c.patronId;
+                posicion = c.posicion;
+            }
+        } else {
+            // Motor de un solo patrón: una pasada por patrón. Gana la misma
+            // coincidencia que reportaría Aho-Corasick: la que termina primero,
+            // a igual final la más larga y luego el patrón de menor índice
+            size_t mejorFin = 0;
+            for (size_t id = 0; id < patronesBusqueda.size(); id++) {
+                int encontrada = buscarPatron(algoritmoSeleccionado, cadenaADN, patronesBusqueda[id], contadores);
+                if (encontrada == -1) continue;
+
+                size_t fin = encontrada + patrones[id].length();
+                bool mejora = posicion == -1 || fin < mejorFin ||
+                    (fin == mejorFin && patrones[id].length() > patrones[patronId].length());
+                if (mejora) {
+                    patronId = id;
+                    posicion = encontrada;
+                    mejorFin = fin;
+                }
+            }
+        }
+
+        return CoincidenciaEncontrada{0, patronId, posicion, distancia};
+    };
+
+    // Cadenas largas: se reparten en tramos entre todos los hilos (solo
+    // búsqueda exacta; la aproximada sigue recorriendo cada cadena entera)
+    int numHilos = opciones.numHilos < 1 ? 1 : opciones.numHilos;
+    bool dividirLargas = !aproximada && numHilos > 1 && opciones.umbralDivision > 0;
+    size_t longitudMaxima = 0;
+    for (const auto& patron : patrones) {
+        longitudMaxima = std::max(longitudMaxima, patron.length());
+    }
+
+    /**
+     * Tramos de inicio [t * largoTramo, (t + 1) * largoTramo), cada uno
+     * recorrido con longitudMaxima - 1 bases más: toda aparición queda
+     * entera en el tramo donde empieza. Gana la menor según (fin,
+     * -longitud, patronId), igual que en el recorrido completo.
+     */
+    auto buscarPorTramos = [&](const auto& cadenaADN, std::vector<ContadoresHilo>& contadoresHilos) {
+        size_t n = longitudCadena(cadenaADN);
+        size_t largoTramo = std::max<size_t>(BASES_MINIMAS_POR_TRAMO,
+                                             (n + numHilos * TRAMOS_POR_HILO - 1) / (numHilos * TRAMOS_POR_HILO));
+        largoTramo = (largoTramo + 31) / 32 * 32;   // Las vistas empaquetadas empiezan en una palabra
+        size_t numTramos = (n + largoTramo - 1) / largoTramo;
+        TRAZA(Traza::DEPURACION, "Cadena de " << n << " bases en " << numTramos << " tramos");
+
+        std::vector<CoincidenciaEncontrada> porTramo(numTramos, CoincidenciaEncontrada{0, 0, -1, 0});
+        std::atomic<size_t> mejorFin(static_cast<size_t>(-1));
+
+        PoolHilos::paraCada(numTramos, numHilos, [&](size_t t, int hilo) {
+            size_t inicio = t * largoTramo;
+
+            // Lo que empieza aquí termina después de un fin ya encontrado
+            if (inicio >= mejorFin.load(std::memory_order_relaxed)) {
+                return;
+            }
+
+            size_t largo = std::min(n - inicio, largoTramo + longitudMaxima - 1);
+            CoincidenciaEncontrada c = buscarEnCadena(tramoDe(cadenaADN, inicio, largo), contadoresHilos[hilo]);
+            if (c.posicion == -1) {
+                return;
+            }
+
+            c.posicion += inicio;
+            porTramo[t] = c;
+            size_t fin = c.posicion + patrones[c.patronId].length();
+            size_t actual = mejorFin.load(std::memory_order_relaxed);
+            while (fin < actual && !mejorFin.compare_exchange_weak(actual, fin, std::memory_order_relaxed)) {
+            }
+        });
+
+        CoincidenciaEncontrada mejor{0, 0, -1, 0};
+        auto clave = [&](const CoincidenciaEncontrada& c) {
+            int longitud = patrones[c.patronId].length();
+            return std::make_tuple(c.posicion + longitud, -longitud, c.patronId);
+        };
+        for (const auto& c : porTramo) {
+            if (c.posicion != -1 && (mejor.posicion == -1 || clave(c) < clave(mejor))) {
+                mejor = c;
+            }
+        }
+        return mejor;
+    };
+
+    auto buscarEnSospechoso = [&](const auto& sospechosos, size_t indice,
+                                  std::vector<CoincidenciaEncontrada>& buffer, ContadoresHilo& contadores) {
+        CoincidenciaEncontrada c = buscarEnCadena(sospechosos[indice].cadenaADN, contadores);
+        if (c.posicion != -1) {
+            c.indice = indice;
+            buffer.push_back(c);
+        }
+    };
+
+    // Recorre los sospechosos [desde, hasta): cada hilo acumula sus
+    // coincidencias en su propio buffer. Las cadenas largas se dejan para
+    // después, de a una y repartidas en tramos, así no fijan la latencia
+    std::vector<ContadoresHilo> contadores(numHilos);
+    auto recorrer = [&](const auto& sospechosos, size_t desde, size_t hasta) {
+        std::vector<std::vector<CoincidenciaEncontrada>> buffers(numHilos);
+        std::vector<std::vector<size_t>> largas(numHilos);
+
+        PoolHilos::paraCada(hasta - desde, numHilos, [&](size_t i, int hilo) {
+            if (dividirLargas && longitudCadena(sospechosos[desde + i].cadenaADN) >= opciones.umbralDivision) {
+                largas[hilo].push_back(desde + i);
+                return;
+            }
+            buscarEnSospechoso(sospechosos, desde + i, buffers[hilo], contadores[hilo]);
+        });
+
+        for (const auto& largasHilo : largas) {
+            for (size_t indice : largasHilo) {
+                CoincidenciaEncontrada c = buscarPorTramos(sospechosos[indice].cadenaADN, contadores);
+                if (c.posicion != -1) {
+                    c.indice = indice;
+                    buffers[0].push_back(c);
+                }
+            }
+        }
+
+        // Unir los buffers en el orden de los sospechosos (mismo orden que la ejecución secuencial)
+        std::vector<CoincidenciaEncontrada> encontradas;
+        for (const auto& buffer : buffers) {
+            encontradas.insert(encontradas.end(), buffer.begin(), buffer.end());
+        }
+        std::sort(encontradas.begin(), encontradas.end(),
+                  [](const CoincidenciaEncontrada& a, const CoincidenciaEncontrada& b) {
+                      return a.indice < b.indice;
+                  });
+        return encontradas;
+    };
+
+    // En streaming las coincidencias de cada tramo se entregan antes de
+    // recorrer el siguiente; si no, cada lote es un solo tramo. Las cédulas
+    // reportadas valen para todos los lotes
+    ConjuntoCedulas cedulasEncontradas;
+    size_t porTramo = opciones.receptor != nullptr ? SOSPECHOSOS_POR_TRAMO : static_cast<size_t>(-1);
+    if (opciones.receptor != nullptr) {
+        opciones.receptor->encabezado(consulta, resultado);
+    }
+
+    // La lectura de cada lote cuenta como ingesta, no como recorrido
+    uint64_t lecturaNs = 0;
+    uint64_t recorridoNs = 0;
+    lotes([&](const auto& sospechosos, size_t) {
+        lecturaNs += cronometro.reiniciar();
+        for (size_t desde = 0; desde < sospechosos.size();) {
+            size_t hasta = desde + std::min(porTramo, sospechosos.size() - desde);
+            entregarCoincidencias(consulta, sospechosos, recorrer(sospechosos, desde, hasta),
+                                  cedulasEncontradas, opciones, resultado);
+            desde = hasta;
+        }
+        recorridoNs += cronometro.reiniciar();
+    });
+
+    // Los contadores y el tiempo de recorrido se suman al terminar
+    if (opciones.metricas != nullptr) {
+        for (const auto& contadoresHilo : contadores) {
+            sumarContadores(contadoresHilo, *opciones.metricas);
+        }
+        opciones.metricas->ingestaNs += lecturaNs;
+        opciones.metricas->recorridoNs += recorridoNs;
+    }
+    return resultado;
+}
+
+/**
+ * Búsqueda exacta con el índice FM: se ubican todas las apariciones de
+ * cada patrón y, por sospechoso, se conserva la que reportaría el
+ * recorrido completo (la primera en terminar; a igual final la más larga
+ * y luego el patrón de menor índice, como Aho-Corasick)
+ */
+template <typename TLotes>
+ResultadoBusqueda ejecutarConIndiceFM(
+    const std::vector<std::string>& consulta,
+    const std::vector<std::string>& patrones,
+    size_t numSecuencias,
+    TLotes lotes,
+    const IndiceFM& indice,
+    const OpcionesBusqueda& opciones
+) {
+    Cronometro cronometro;
+    ResultadoBusqueda resultado;
+
+    // Con índice no hace falta medir la base: el selector no compara costos
+    CargaTrabajo carga;
+    carga.numPatrones = patrones.size();
+    carga.numSecuencias = numSecuencias;
+    const PerfilCostos& perfil = PerfilCostos::porDefecto();
+
+    AlgorithmSelector::Algorithm algoritmoSeleccionado = AlgorithmSelector::seleccionar(carga, perfil, true);
+    resultado.algoritmo = AlgorithmSelector::toString(algoritmoSeleccionado);
+    resultado.criterio = AlgorithmSelector::obtenerCriterio(algoritmoSeleccionado, carga, perfil);
+    resultado.totalProcesados = carga.numSecuencias;
+
+    std::vector<CoincidenciaEncontrada> apariciones;
+    for (size_t id = 0; id < patrones.size(); id++) {
+        for (const OcurrenciaFM& ocurrencia : indice.localizar(patrones[id])) {
+            apariciones.push_back({ocurrencia.fila, static_cast<int>(id), static_cast<int>(ocurrencia.posicion), 0});
+        }
+    }
+
+    auto clave = [&](const CoincidenciaEncontrada& c) {
+        int longitud = patrones[c.patronId].length();
+        return std::make_tuple(c.indice, c.posicion + longitud, -longitud, c.patronId);
+    };
+    std::sort(apariciones.begin(), apariciones.end(),
+              [&](const CoincidenciaEncontrada& a, const CoincidenciaEncontrada& b) {
+                  return clave(a) < clave(b);
+              });
+
+    std::vector<CoincidenciaEncontrada> encontradas;
+    for (const auto& aparicion : apariciones) {
+        if (encontradas.empty() || encontradas.back().indice != aparicion.indice) {
+            encontradas.push_back(aparicion);
+        }
+    }
+
+    if (opciones.receptor != nullptr) {
+        opciones.receptor->encabezado(consulta, resultado);
+    }
+
+    // Cada lote recibe las coincidencias de sus sospechosos (solo hacen
+    // falta su nombre y cédula)
+    ConjuntoCedulas cedulasEncontradas;
+    size_t siguiente = 0;
+    lotes([&](const auto& sospechosos, size_t primero) {
+        std::vector<CoincidenciaEncontrada> delLote;
+        for (; siguiente < encontradas.size() && encontradas[siguiente].indice < primero + sospechosos.size(); siguiente++) {
+            delLote.push_back(encontradas[siguiente]);
+            delLote.back().indice -= primero;
+        }
+        entregarCoincidencias(consulta, sospechosos, delLote, cedulasEncontradas, opciones, resultado);
+    });
+
+    // Ningún sospechoso se recorre: el índice da las posiciones
+    if (opciones.metricas != nullptr) {
+        opciones.metricas->recorridoNs += cronometro.nanosegundos();
+        opciones.metricas->sospechososOmitidos += numSecuencias;
+    }
+    return resultado;
+}
+
+/**
+ * Usa el índice FM si lo hay o recorre todos los sospechosos o solo los
+ * que eligió el índice de k-mers
+ * @tparam TPatron Representación de los patrones que corresponde a las
+ *         cadenas (std::string o SecuenciaEmpaquetada)
+ * @param numSecuencias Sospechosos de la base
+ * @param lotes Recorre la base de a lotes (ver ejecutarSobre); primero es
+ *        el índice en la base del primer sospechoso del lote
+ * @param medirCarga (patrones) → carga de la base completa (con el índice
+ *        FM no hace falta)
+ */
+template <typename TPatron, typename TLotes, typename TMedirCarga>
+ResultadoBusqueda ejecutarSegunPlanPorLotes(
+    const std::vector<std::string>& consulta,
+    size_t numSecuencias,
+    TLotes lotes,
+    TMedirCarga medirCarga,
+    const OpcionesBusqueda& opciones
+) {
+    std::vector<std::string> patrones = MotorBusqueda::patronesDeBusqueda(consulta, opciones);
+    if (opciones.indiceFM != nullptr && opciones.maxErrores < 0) {
+        return ejecutarConIndiceFM(consulta, patrones, numSecuencias, lotes, *opciones.indiceFM, opciones);
+    }
+    std::vector<TPatron> patronesBusqueda(patrones.begin(), patrones.end());
+
+    // El algoritmo se elige por la base completa
+    Cronometro cronometro;
+    CargaTrabajo carga = medirCarga(patrones);
+    carga.representacion = std::is_same<TPatron, SecuenciaEmpaquetada>::value
+        ? CargaTrabajo::EMPAQUETADA : CargaTrabajo::TEXTO;
+    if (opciones.metricas != nullptr) {
+        opciones.metricas->construccionNs += cronometro.nanosegundos();
+    }
+
+    if (opciones.filas == nullptr) {
+        return ejecutarSobre(consulta, patrones, patronesBusqueda, lotes, carga, opciones);
+    }
+
+    if (opciones.metricas != nullptr) {
+        opciones.metricas->sospechososOmitidos += numSecuencias - opciones.filas->size();
+    }
+
+    // De cada lote, solo las filas elegidas que caen en él
+    const std::vector<size_t>& filas = *opciones.filas;
+    auto candidatos = [&](auto alLote) {
+        size_t siguiente = 0;
+        lotes([&](const auto& sospechosos, size_t primero) {
+            std::vector<size_t> filasLote;
+            for (; siguiente < filas.size() && filas[siguiente] < primero + sospechosos.size(); siguiente++) {
+                filasLote.push_back(filas[siguiente] - primero);
+            }
+            using TColeccion = std::decay_t<decltype(sospechosos)>;
+            alLote(Subconjunto<TColeccion>{sospechosos, filasLote}, primero);
+        });
+    };
+    return ejecutarSobre(consulta, patrones, patronesBusqueda, candidatos, carga, opciones);
+}
+
+/**
+ * ejecutarSegunPlanPorLotes sobre una colección en memoria (un solo lote)
+ */
+template <typename TPatron, typename TColeccion>
+ResultadoBusqueda ejecutarSegunPlan(
+    const std::vector<std::string>& consulta,
+    const TColeccion& sospechosos,
+    const OpcionesBusqueda& opciones
+) {
+    return ejecutarSegunPlanPorLotes<TPatron>(
+        consulta, sospechosos.size(),
+        [&](auto alLote) { alLote(sospechosos, 0); },
+        [&](const std::vector<std::string>& patrones) { return medirCarga(patrones, sospechosos); },
+        opciones);
+}
+
+// Coincidencia de una consulta del lote
+struct CoincidenciaLote {
+    size_t consulta;
+    size_t indice;
+    int patronId;
+    int posicion;
+};
+
+/**
+ * Todas las consultas exactas del lote en una pasada: el autómata tiene
+ * cada patrón distinto una sola vez y entrega la primera aparición de
+ * cada uno. De ellas, cada consulta se queda con la que ganaría en su
+ * propia búsqueda: la que termina primero, a igual final la del patrón
+ * más largo y luego la de menor índice (como AhoCorasick::PRIMERA).
+ */
+template <typename TColeccion>
+std::vector<ResultadoBusqueda> ejecutarLoteSobre(
+    const std::vector<std::vector<std::string>>& consultas,
+    const TColeccion& sospechosos,
+    const OpcionesBusqueda& opciones
+) {
+    Cronometro cronometro;
+
+    // Patrones distintos del lote (con los complementos si se buscan ambas
+    // hebras) y en qué (consulta, patronId) aparece cada uno
+    std::map<std::string, int> idPorPatron;
+    std::vector<std::string> distintos;
+    std::vector<std::vector<std::pair<int, int>>> usos;
+    for (size_t consulta = 0; consulta < consultas.size(); consulta++) {
+        std::vector<std::string> patrones = MotorBusqueda::patronesDeBusqueda(consultas[consulta], opciones);
+        for (size_t id = 0; id < patrones.size(); id++) {
+            auto insertado = idPorPatron.emplace(patrones[id], static_cast<int>(distintos.size()));
+            if (insertado.second) {
+                distintos.push_back(patrones[id]);
+                usos.emplace_back();
+            }
+            usos[insertado.first->second].emplace_back(static_cast<int>(consulta), static_cast<int>(id));
+        }
+    }
+
+    AhoCorasick automata(distintos);
+    if (opciones.metricas != nullptr) {
+        opciones.metricas->construccionNs += cronometro.reiniciar();
+        opciones.metricas->estadosAutomata += automata.numEstados();
+    }
+
+    // Mejor coincidencia de cada consulta en el sospechoso actual (por hilo)
+    struct Mejor {
+        size_t fin;
+        int longitud;
+        int patronId;
+        int posicion;
+    };
+    const size_t NINGUNA = static_cast<size_t>(-1);
+    struct EstadoHilo {
+        std::vector<Mejor> mejores;
+        std::vector<int> tocadas;
+        std::vector<CoincidenciaLote> encontradas;
+        ContadoresHilo contadores;
+    };
+
+    int numHilos = opciones.numHilos < 1 ? 1 : opciones.numHilos;
+    std::vector<EstadoHilo> estados(numHilos);
+    for (auto& estado : estados) {
+        estado.mejores.assign(consultas.size(), {NINGUNA, 0, 0, 0});
+    }
+
+    PoolHilos::paraCada(sospechosos.size(), numHilos, [&](size_t indice, int hilo) {
+        EstadoHilo& estado = estados[hilo];
+        decltype(auto) cadenaADN = sospechosos[indice].cadenaADN;
+        estado.contadores.bases += longitudCadena(cadenaADN);
+
+        automata.buscarEn(cadenaADN, AhoCorasick::PRIMERA_POR_PATRON,
+                          [&](const CoincidenciaMultiple& c) {
+            int longitud = distintos[c.patronId].length();
+            size_t fin = c.posicion + longitud;
+
+            for (const auto& uso : usos[c.patronId]) {
+                Mejor& mejor = estado.mejores[uso.first];
+                if (mejor.fin == NINGUNA) {
+                    estado.tocadas.push_back(uso.first);
+                } else {
+                    bool mejora = fin < mejor.fin || (fin == mejor.fin &&
+                        (longitud > mejor.longitud || (longitud == mejor.longitud && uso.second < mejor.patronId)));
+                    if (!mejora) continue;
+                }
+                mejor = {fin, longitud, uso.second, c.posicion};
+            }
+        }, &estado.contadores.saltosEnlace);
+
+        for (int consulta : estado.tocadas) {
+            Mejor& mejor = estado.mejores[consulta];
+            estado.encontradas.push_back({static_cast<size_t>(consulta), indice, mejor.patronId, mejor.posicion});
+            mejor.fin = NINGUNA;
+        }
+        estado.tocadas.clear();
+    });
+
+    // Por consulta y en el orden de los sospechosos (igual que con un hilo)
+    std::vector<CoincidenciaLote> encontradas;
+    for (const auto& estado : estados) {
+        encontradas.insert(encontradas.end(), estado.encontradas.begin(), estado.encontradas.end());
+    }
+    std::sort(encontradas.begin(), encontradas.end(),
+              [](const CoincidenciaLote& a, const CoincidenciaLote& b) {
+                  return std::tie(a.consulta, a.indice) < std::tie(b.consulta, b.indice);
+              });
+
+    OpcionesBusqueda sinReceptor = opciones;
+    sinReceptor.receptor = nullptr;
+
+    std::vector<ResultadoBusqueda> resultados(consultas.size());
+    auto siguiente = encontradas.begin();
+    for (size_t consulta = 0; consulta < consultas.size(); consulta++) {
+        ResultadoBusqueda& resultado = resultados[consulta];
+        resultado.algoritmo = AlgorithmSelector::toString(AlgorithmSelector::AHO_CORASICK);
+        resultado.criterio = "lote_automata_combinado: " + std::to_string(consultas.size()) + " consultas, " +
+                             std::to_string(distintos.size()) + " patrones distintos";
+        resultado.totalProcesados = sospechosos.size();
+
+        std::vector<CoincidenciaEncontrada> deLaConsulta;
+        for (; siguiente != encontradas.end() && siguiente->consulta == consulta; ++siguiente) {
+            deLaConsulta.push_back({siguiente->indice, siguiente->patronId, siguiente->posicion, 0});
+        }
+
+        ConjuntoCedulas cedulasEncontradas;
+        entregarCoincidencias(consultas[consulta], sospechosos, deLaConsulta, cedulasEncontradas, sinReceptor, resultado);
+    }
+
+    if (opciones.metricas != nullptr) {
+        for (const auto& estado : estados) {
+            sumarContadores(estado.contadores, *opciones.metricas);
+        }
+        opciones.metricas->recorridoNs += cronometro.nanosegundos();
+    }
+    return resultados;
+}
+
+/**
+ * Lote exacto en una pasada o, si es aproximado, una búsqueda por consulta
+ */
+template <typename TColeccion, typename EjecutarUna>
+std::vector<ResultadoBusqueda> ejecutarLoteSegunModo(
+    const std::vector<std::vector<std::string>>& consultas,
+    const TColeccion& sospechosos,
+    const OpcionesBusqueda& opciones,
+    EjecutarUna ejecutarUna
+) {
+    OpcionesBusqueda recorridoCompleto = opciones;
+    recorridoCompleto.filas = nullptr;
+    recorridoCompleto.indiceFM = nullptr;
+    recorridoCompleto.receptor = nullptr;
+
+    if (opciones.maxErrores < 0) {
+        return ejecutarLoteSobre(consultas, sospechosos, recorridoCompleto);
+    }
+
+    // Myers y Hamming no tienen versión multipatrón: cada consulta aparte
+    std::vector<ResultadoBusqueda> resultados;
+    for (const auto& patrones : consultas) {
+        resultados.push_back(ejecutarUna(patrones, recorridoCompleto));
+    }
+    return resultados;
+}
+
+}
+
+ResultadoBusqueda MotorBusqueda::ejecutar(
+    const std::vector<std::string>& patrones,
+    const std::vector<Sospechoso>& sospechosos,
+    const OpcionesBusqueda& opciones
+) {
+    return ejecutarSegunPlan<std::string>(patrones, sospechosos, opciones);
+}
+
+ResultadoBusqueda MotorBusqueda::ejecutar(
+    const std::vector<std::string>& patrones,
+    const std::vector<SospechosoEmpaquetado>& sospechosos,
+    const OpcionesBusqueda& opciones
+) {
+    return ejecutarSegunPlan<SecuenciaEmpaquetada>(patrones, sospechosos, opciones);
+}
+
+ResultadoBusqueda MotorBusqueda::ejecutar(
+    const std::vector<std::string>& patrones,
+    const AlmacenSospechosos& sospechosos,
+    const OpcionesBusqueda& opciones
+) {
+    return ejecutarSegunPlan<SecuenciaEmpaquetada>(patrones, sospechosos, opciones);
+}
+
+ResultadoBusqueda MotorBusqueda::ejecutar(
+    const std::vector<std::string>& patrones,
+    const std::vector<SospechosoVista>& sospechosos,
+    const OpcionesBusqueda& opciones
+) {
+    return ejecutarSegunPlan<std::string>(patrones, sospechosos, opciones);
+}
+
+ResultadoBusqueda MotorBusqueda::ejecutar(
+    const std::vector<std::string>& patrones,
+    const CSVPorLotes& csv,
+    const OpcionesBusqueda& opciones
+) {
+    return ejecutarSegunPlanPorLotes<std::string>(
+        patrones, csv.size(),
+        [&](auto alLote) {
+            csv.recorrer([&](const std::vector<SospechosoVista>& lote, size_t primero) {
+                alLote(lote, primero);
+            });
+        },
+        [&](const std::vector<std::string>& patronesBusqueda) {
+            // Medida en la primera pasada por el archivo
+            CargaTrabajo carga = cargaDePatrones(patronesBusqueda);
+            carga.numSecuencias = csv.size();
+            carga.totalBases = csv.totalBases();
+            carga.basesRecorridas = csv.basesDesde(carga.longitudMinimaPatron);
+            return carga;
+        },
+        opciones);
+}
+
+ResultadoBusqueda MotorBusqueda::ejecutar(
+    const std::vector<std::string>& patrones,
+    const BaseDatosBinaria& base,
+    const OpcionesBusqueda& opciones
+) {
+    if (base.empaquetada()) {
+        return ejecutarSegunPlan<SecuenciaEmpaquetada>(patrones, RegistrosEmpaquetados{base}, opciones);
+    }
+    return ejecutarSegunPlan<std::string>(patrones, RegistrosTexto{base}, opciones);
+}
+
+ResultadoBusqueda MotorBusqueda::ejecutar(
+    const std::vector<std::string>& patrones,
+    const Instantanea& instantanea,
+    const OpcionesBusqueda& opciones
+) {
+    return ejecutarSegunPlan<SecuenciaEmpaquetada>(patrones, instantanea, opciones);
+}
+
+std::vector<ResultadoBusqueda> MotorBusqueda::ejecutarLote(
+    const std::vector<std::vector<std::string>>& consultas,
+    const std::vector<SospechosoVista>& sospechosos,
+    const OpcionesBusqueda& opciones
+) {
+    return ejecutarLoteSegunModo(consultas, sospechosos, opciones,
+        [&](const std::vector<std::string>& patrones, const OpcionesBusqueda& opcionesConsulta) {
+            return ejecutar(patrones, sospechosos, opcionesConsulta);
+        });
+}
+
+std::vector<ResultadoBusqueda> MotorBusqueda::ejecutarLote(
+    const std::vector<std::vector<std::string>>& consultas,
+    const std::vector<SospechosoEmpaquetado>& sospechosos,
+    const OpcionesBusqueda& opciones
+) {
+    return ejecutarLoteSegunModo(consultas, sospechosos, opciones,
+        [&](const std::vector<std::string>& patrones, const OpcionesBusqueda& opcionesConsulta) {
+            return ejecutar(patrones, sospechosos, opcionesConsulta);
+        });
+}
+
+std::vector<ResultadoBusqueda> MotorBusqueda::ejecutarLote(
+    const std::vector<std::vector<std::string>>& consultas,
+    const AlmacenSospechosos& sospechosos,
+    const OpcionesBusqueda& opciones
+) {
+    return ejecutarLoteSegunModo(consultas, sospechosos, opciones,
+        [&](const std::vector<std::string>& patrones, const OpcionesBusqueda& opcionesConsulta) {
+            return ejecutar(patrones, sospechosos, opcionesConsulta);
+        });
+}
+
+std::vector<ResultadoBusqueda> MotorBusqueda::ejecutarLote(
+    const std::vector<std::vector<std::string>>& consultas,
+    const BaseDatosBinaria& base,
+    const OpcionesBusqueda& opciones
+) {
+    auto ejecutarUna = [&](const std::vector<std::string>& patrones, const OpcionesBusqueda& opcionesConsulta) {
+        return ejecutar(patrones, base, opcionesConsulta);
+    };
+    if (base.empaquetada()) {
+        return ejecutarLoteSegunModo(consultas, RegistrosEmpaquetados{base}, opciones, ejecutarUna);
+    }
+    return ejecutarLoteSegunModo(consultas, RegistrosTexto{base}, opciones, ejecutarUna);
+}
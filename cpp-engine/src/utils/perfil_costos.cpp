@@ -0,0 +1,408 @@
+#include "../../include/perfil_costos.h"
+#include "../../include/kmp.h"
+#include "../../include/rabin_karp.h"
+#include "../../include/busqueda_simd.h"
+#include "../../include/aho_corasick.h"
+#include "../../include/secuencia_empaquetada.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+const int VERSION = 3;
+const int NUM_COEFICIENTES = 4;
+const int REPETICIONES_MEDICION = 3;
+
+// Carga sintética de la calibración
+struct CargaCalibracion {
+    size_t numSecuencias;
+    size_t longitudSecuencia;
+    size_t numPatrones;
+    size_t longitudPatron;     // El patrón i mide longitudPatron + (i % numLongitudes) * PASO_LONGITUD
+    size_t numLongitudes;
+};
+
+const size_t PASO_LONGITUD = 10;
+
+size_t longitudPatron(const CargaCalibracion& carga, size_t i) {
+    return carga.longitudPatron + (i % carga.numLongitudes) * PASO_LONGITUD;
+}
+
+// Variadas para separar los cuatro términos del modelo; los patrones son
+// siempre más cortos que las secuencias (si no, los motores ni las recorren)
+const CargaCalibracion CARGAS[] = {
+    {6000, 150, 1, 100, 1},
+    {1000, 1000, 1, 100, 1},
+    {250, 4000, 1, 100, 1},
+    {250, 4000, 1, 1000, 1},
+    {1000, 1000, 4, 250, 1},
+    {6000, 150, 4, 120, 1},
+    {250, 4000, 8, 500, 1},
+    {20, 2500, 16, 1000, 1},
+    {200, 1000, 64, 200, 4},
+    {100, 1000, 256, 120, 2},
+};
+
+std::string cadenaAlAzar(std::mt19937_64& azar, size_t longitud) {
+    static const char BASES[4] = {'A', 'T', 'C', 'G'};
+    std::string cadena(longitud, 'A');
+    for (char& c : cadena) {
+        c = BASES[azar() % 4];
+    }
+    return cadena;
+}
+
+/**
+ * Variables del modelo para una carga (mismo orden que Coeficientes)
+ */
+std::vector<double> variables(AlgorithmSelector::Algorithm algoritmo, const CargaCalibracion& carga) {
+    double pasadas = AlgorithmSelector::pasadasPor(algoritmo, carga.numPatrones, carga.numLongitudes);
+    double bases = static_cast<double>(carga.numSecuencias) * carga.longitudSecuencia;
+    double basesPatrones = 0;
+    for (size_t i = 0; i < carga.numPatrones; i++) {
+        basesPatrones += longitudPatron(carga, i);
+    }
+
+    return {
+        bases * pasadas,
+        carga.numSecuencias * pasadas,
+        carga.numSecuencias * basesPatrones,
+        basesPatrones
+    };
+}
+
+/**
+ * Tiempo (ns) de un motor sobre una carga, el menor de varias mediciones
+ * @tparam TCadena std::string o SecuenciaEmpaquetada (secuencias y
+ *         patronesBusqueda, en la representación a medir)
+ */
+template <typename TCadena>
+double medir(
+    AlgorithmSelector::Algorithm algoritmo,
+    const std::vector<TCadena>& secuencias,
+    const std::vector<std::string>& patrones,
+    const std::vector<TCadena>& patronesBusqueda
+) {
+    double mejor = 0;
+    long encontrados = 0;  // Evita que el compilador descarte las búsquedas
+
+    for (int repeticion = 0; repeticion < REPETICIONES_MEDICION; repeticion++) {
+        auto inicio = std::chrono::steady_clock::now();
+
+        if (algoritmo == AlgorithmSelector::AHO_CORASICK) {
+            AhoCorasick automata(patrones);
+            for (const auto& secuencia : secuencias) {
+                automata.buscarEn(secuencia, AhoCorasick::PRIMERA, [&](const CoincidenciaMultiple&) {
+                    encontrados++;
+                });
+            }
+        } else if (algoritmo == AlgorithmSelector::RABIN_KARP_MULTIPLE) {
+            RabinKarpMultiple buscador(patrones);
+            CoincidenciaMultiple coincidencia;
+            for (const auto& secuencia : secuencias) {
+                encontrados += buscador.buscarPrimera(secuencia, coincidencia);
+            }
+        } else {
+            for (const auto& patron : patronesBusqueda) {
+                for (const auto& secuencia : secuencias) {
+                    int posicion = algoritmo == AlgorithmSelector::KMP ? KMP::buscar(secuencia, patron)
+                        : algoritmo == AlgorithmSelector::RABIN_KARP ? RabinKarp::buscar(secuencia, patron)
+                        : BusquedaSIMD::buscar(secuencia, patron);
+                    encontrados += posicion != -1;
+                }
+            }
+        }
+
+        auto fin = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(fin - inicio).count();
+        mejor = repeticion == 0 ? ns : std::min(mejor, ns);
+    }
+
+    return mejor + (encontrados < 0 ? 1 : 0);
+}
+
+/**
+ * Resuelve el sistema a·x = b (Gauss con pivoteo parcial)
+ * @return false si es singular
+ */
+bool resolver(std::vector<std::vector<double>> a, std::vector<double> b, std::vector<double>& x) {
+    size_t n = b.size();
+    for (size_t columna = 0; columna < n; columna++) {
+        size_t pivote = columna;
+        for (size_t fila = columna + 1; fila < n; fila++) {
+            if (std::fabs(a[fila][columna]) > std::fabs(a[pivote][columna])) pivote = fila;
+        }
+        if (std::fabs(a[pivote][columna]) < 1e-300) return false;
+        std::swap(a[columna], a[pivote]);
+        std::swap(b[columna], b[pivote]);
+
+        for (size_t fila = columna + 1; fila < n; fila++) {
+            double factor = a[fila][columna] / a[columna][columna];
+            for (size_t k = columna; k < n; k++) a[fila][k] -= factor * a[columna][k];
+            b[fila] -= factor * b[columna];
+        }
+    }
+
+    x.assign(n, 0);
+    for (size_t i = n; i-- > 0;) {
+        double suma = b[i];
+        for (size_t k = i + 1; k < n; k++) suma -= a[i][k] * x[k];
+        x[i] = suma / a[i][i];
+    }
+    return true;
+}
+
+/**
+ * Mínimos cuadrados con coeficientes >= 0, minimizando el error relativo
+ * (cada fila se divide por su tiempo). Si un coeficiente sale negativo se
+ * fija en 0 y se vuelve a ajustar sin esa variable.
+ */
+std::vector<double> ajustar(const std::vector<std::vector<double>>& filas, const std::vector<double>& tiempos) {
+    std::vector<bool> activa(NUM_COEFICIENTES, true);
+    std::vector<double> coeficientes(NUM_COEFICIENTES, 0);
+
+    for (int intento = 0; intento < NUM_COEFICIENTES; intento++) {
+        std::vector<int> indices;
+        for (int j = 0; j < NUM_COEFICIENTES; j++) {
+            if (activa[j]) indices.push_back(j);
+        }
+        if (indices.empty()) break;
+
+        // Ecuaciones normales sobre las variables activas
+        size_t n = indices.size();
+        std::vector<std::vector<double>> ata(n, std::vector<double>(n, 0));
+        std::vector<double> atb(n, 0);
+        for (size_t f = 0; f < filas.size(); f++) {
+            double peso = 1.0 / tiempos[f];
+            for (size_t i = 0; i < n; i++) {
+                double xi = filas[f][indices[i]] * peso;
+                atb[i] += xi * tiempos[f] * peso;
+                for (size_t k = 0; k < n; k++) {
+                    ata[i][k] += xi * filas[f][indices[k]] * peso;
+                }
+            }
+        }
+
+        std::vector<double> solucion;
+        if (!resolver(ata, atb, solucion)) break;
+
+        size_t masNegativo = n;
+        for (size_t i = 0; i < n; i++) {
+            if (solucion[i] < 0 && (masNegativo == n || solucion[i] < solucion[masNegativo])) {
+                masNegativo = i;
+            }
+        }
+
+        std::fill(coeficientes.begin(), coeficientes.end(), 0);
+        if (masNegativo == n) {
+            for (size_t i = 0; i < n; i++) coeficientes[indices[i]] = solucion[i];
+            break;
+        }
+        activa[indices[masNegativo]] = false;
+    }
+
+    return coeficientes;
+}
+
+const CargaTrabajo::Representacion REPRESENTACIONES[] = {CargaTrabajo::TEXTO, CargaTrabajo::EMPAQUETADA};
+
+/**
+ * Clave de un motor en el archivo de perfil: "simd" o "simd-empaquetado"
+ */
+std::string nombreEnPerfil(AlgorithmSelector::Algorithm algoritmo, CargaTrabajo::Representacion representacion) {
+    return AlgorithmSelector::toString(algoritmo) + (representacion == CargaTrabajo::EMPAQUETADA ? "-empaquetado" : "");
+}
+
+std::vector<double> comoVector(const PerfilCostos::Coeficientes& c) {
+    return {c.porBase, c.porSecuencia, c.porSecuenciaYBasePatron, c.porBasePatron};
+}
+
+PerfilCostos::Coeficientes desdeVector(const std::vector<double>& v) {
+    PerfilCostos::Coeficientes c;
+    c.porBase = v[0];
+    c.porSecuencia = v[1];
+    c.porSecuenciaYBasePatron = v[2];
+    c.porBasePatron = v[3];
+    return c;
+}
+
+}
+
+const std::vector<AlgorithmSelector::Algorithm>& PerfilCostos::algoritmosExactos() {
+    static const std::vector<AlgorithmSelector::Algorithm> algoritmos = {
+        AlgorithmSelector::KMP,
+        AlgorithmSelector::RABIN_KARP,
+        AlgorithmSelector::SIMD,
+        AlgorithmSelector::AHO_CORASICK,
+        AlgorithmSelector::RABIN_KARP_MULTIPLE
+    };
+    return algoritmos;
+}
+
+const PerfilCostos& PerfilCostos::porDefecto() {
+    static const PerfilCostos perfil = []() {
+        PerfilCostos referencia;
+        auto fijar = [&](AlgorithmSelector::Algorithm algoritmo, CargaTrabajo::Representacion representacion,
+                         const std::vector<double>& valores) {
+            referencia.coeficientesPorMotor[{algoritmo, representacion}] = desdeVector(valores);
+        };
+        fijar(AlgorithmSelector::KMP, CargaTrabajo::TEXTO, {7.3, 320.0, 0.0, 2.0});
+        fijar(AlgorithmSelector::RABIN_KARP, CargaTrabajo::TEXTO, {2.2, 0.0, 1.1, 2.5});
+        fijar(AlgorithmSelector::SIMD, CargaTrabajo::TEXTO, {0.14, 140.0, 0.0, 0.0});
+        fijar(AlgorithmSelector::AHO_CORASICK, CargaTrabajo::TEXTO, {3.6, 9.6, 0.12, 70.0});
+        fijar(AlgorithmSelector::RABIN_KARP_MULTIPLE, CargaTrabajo::TEXTO, {2.6, 0.0, 0.0, 11.0});
+        // Cadenas empaquetadas
+        fijar(AlgorithmSelector::KMP, CargaTrabajo::EMPAQUETADA, {3.5, 30.0, 4.2, 0.0});
+        fijar(AlgorithmSelector::RABIN_KARP, CargaTrabajo::EMPAQUETADA, {2.7, 0.0, 0.0, 2.5});
+        fijar(AlgorithmSelector::SIMD, CargaTrabajo::EMPAQUETADA, {0.2, 55.0, 0.0, 0.0});
+        fijar(AlgorithmSelector::AHO_CORASICK, CargaTrabajo::EMPAQUETADA, {3.6, 26.0, 0.02, 60.0});
+        fijar(AlgorithmSelector::RABIN_KARP_MULTIPLE, CargaTrabajo::EMPAQUETADA, {3.4, 0.0, 0.03, 3.7});
+        return referencia;
+    }();
+    return perfil;
+}
+
+const PerfilCostos::Coeficientes& PerfilCostos::coeficientes(
+    AlgorithmSelector::Algorithm algoritmo,
+    CargaTrabajo::Representacion representacion
+) const {
+    auto it = coeficientesPorMotor.find({algoritmo, representacion});
+    if (it == coeficientesPorMotor.end()) {
+        throw std::runtime_error("El perfil de costos no tiene el motor " + nombreEnPerfil(algoritmo, representacion));
+    }
+    return it->second;
+}
+
+PerfilCostos PerfilCostos::calibrar() {
+    std::mt19937_64 azar(20240601);
+    PerfilCostos perfil;
+    perfil.esCalibrado = true;
+
+    std::vector<std::vector<std::string>> secuencias;
+    std::vector<std::vector<std::string>> patrones;
+    for (const CargaCalibracion& carga : CARGAS) {
+        secuencias.emplace_back();
+        for (size_t i = 0; i < carga.numSecuencias; i++) {
+            secuencias.back().push_back(cadenaAlAzar(azar, carga.longitudSecuencia));
+        }
+        patrones.emplace_back();
+        for (size_t i = 0; i < carga.numPatrones; i++) {
+            patrones.back().push_back(cadenaAlAzar(azar, longitudPatron(carga, i)));
+        }
+    }
+
+    // Las mismas cargas, empaquetadas
+    std::vector<std::vector<SecuenciaEmpaquetada>> secuenciasEmpaquetadas;
+    std::vector<std::vector<SecuenciaEmpaquetada>> patronesEmpaquetados;
+    for (size_t i = 0; i < secuencias.size(); i++) {
+        secuenciasEmpaquetadas.emplace_back(secuencias[i].begin(), secuencias[i].end());
+        patronesEmpaquetados.emplace_back(patrones[i].begin(), patrones[i].end());
+    }
+
+    for (AlgorithmSelector::Algorithm algoritmo : algoritmosExactos()) {
+        std::vector<std::vector<double>> filas;
+        std::vector<double> tiemposTexto;
+        std::vector<double> tiemposEmpaquetados;
+
+        for (size_t i = 0; i < secuencias.size(); i++) {
+            filas.push_back(variables(algoritmo, CARGAS[i]));
+            tiemposTexto.push_back(std::max(1.0, medir(algoritmo, secuencias[i], patrones[i], patrones[i])));
+            tiemposEmpaquetados.push_back(std::max(1.0, medir(
+                algoritmo, secuenciasEmpaquetadas[i], patrones[i], patronesEmpaquetados[i])));
+        }
+
+        perfil.coeficientesPorMotor[{algoritmo, CargaTrabajo::TEXTO}] = desdeVector(ajustar(filas, tiemposTexto));
+        perfil.coeficientesPorMotor[{algoritmo, CargaTrabajo::EMPAQUETADA}] =
+            desdeVector(ajustar(filas, tiemposEmpaquetados));
+    }
+
+    return perfil;
+}
+
+void PerfilCostos::guardar(const std::string& rutaArchivo) const {
+    std::ofstream salida(rutaArchivo, std::ios::trunc);
+    if (!salida.is_open()) {
+        throw std::runtime_error("No se pudo crear el archivo: " + rutaArchivo);
+    }
+
+    salida << "# Perfil de costos de busqueda_adn (nanosegundos)\n";
+    salida << "# motor por_base por_secuencia por_secuencia_y_base_patron por_base_patron\n";
+    salida << "# (motor-empaquetado: sobre cadenas a 2 bits por base)\n";
+    salida << "version " << VERSION << "\n";
+    salida.precision(6);
+    for (CargaTrabajo::Representacion representacion : REPRESENTACIONES) {
+        for (AlgorithmSelector::Algorithm algoritmo : algoritmosExactos()) {
+            salida << nombreEnPerfil(algoritmo, representacion);
+            for (double valor : comoVector(coeficientes(algoritmo, representacion))) {
+                salida << " " << valor;
+            }
+            salida << "\n";
+        }
+    }
+
+    if (!salida.good()) {
+        throw std::runtime_error("Error al escribir el archivo: " + rutaArchivo);
+    }
+}
+
+PerfilCostos PerfilCostos::cargar(const std::string& rutaArchivo) {
+    std::ifstream entrada(rutaArchivo);
+    if (!entrada.is_open()) {
+        throw std::runtime_error("No se pudo abrir el perfil de costos: " + rutaArchivo);
+    }
+
+    PerfilCostos perfil;
+    perfil.esCalibrado = true;
+    int version = -1;
+    std::string linea;
+
+    while (std::getline(entrada, linea)) {
+        if (linea.empty() || linea[0] == '#') continue;
+
+        std::istringstream campos(linea);
+        std::string clave;
+        campos >> clave;
+
+        if (clave == "version") {
+            campos >> version;
+            continue;
+        }
+
+        bool conocido = false;
+        for (CargaTrabajo::Representacion representacion : REPRESENTACIONES) {
+            for (AlgorithmSelector::Algorithm algoritmo : algoritmosExactos()) {
+                if (nombreEnPerfil(algoritmo, representacion) != clave) continue;
+
+                std::vector<double> valores(NUM_COEFICIENTES);
+                for (double& valor : valores) campos >> valor;
+                if (campos.fail() || std::any_of(valores.begin(), valores.end(), [](double v) { return !(v >= 0); })) {
+                    throw std::runtime_error("Perfil de costos inválido, línea: " + linea);
+                }
+                perfil.coeficientesPorMotor[{algoritmo, representacion}] = desdeVector(valores);
+                conocido = true;
+            }
+        }
+        if (!conocido) {
+            throw std::runtime_error("Perfil de costos inválido, motor desconocido: " + clave);
+        }
+    }
+
+    if (version != VERSION) {
+        throw std::runtime_error("Versión de perfil de costos no soportada: " + rutaArchivo);
+    }
+    for (CargaTrabajo::Representacion representacion : REPRESENTACIONES) {
+        for (AlgorithmSelector::Algorithm algoritmo : algoritmosExactos()) {
+            if (!perfil.coeficientesPorMotor.count({algoritmo, representacion})) {
+                throw std::runtime_error("Al perfil de costos le falta el motor " +
+                                         nombreEnPerfil(algoritmo, representacion));
+            }
+        }
+    }
+
+    return perfil;
+}
@@ -0,0 +1,213 @@
+#include "../../include/pool_hilos.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <cstdint>
+#include <vector>
+#include <exception>
+#include <algorithm>
+
+namespace {
+
+// Cola de bloques de un hilo: el dueño toma del frente, los demás roban del final
+struct ColaBloques {
+    std::mutex mutex;
+    std::deque<size_t> bloques;
+
+    bool tomarFrente(size_t& bloque) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (bloques.empty()) return false;
+        bloque = bloques.front();
+        bloques.pop_front();
+        return true;
+    }
+
+    bool robarFinal(size_t& bloque) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (bloques.empty()) return false;
+        bloque = bloques.back();
+        bloques.pop_back();
+        return true;
+    }
+};
+
+// Una llamada a paraCada: el rango, su tarea y el primer error
+struct Trabajo {
+    size_t total;
+    int numHilos;
+    size_t tamBloque;
+    const std::function<void(size_t indice, int hilo)>* tarea;
+    std::mutex mutexError;
+    std::exception_ptr primerError;
+};
+
+// Verdadero en los hilos del pool y en quien está repartiendo un trabajo:
+// un paraCada anidado se ejecuta ahí mismo en lugar de esperar al pool
+thread_local bool dentroDelPool = false;
+
+/**
+ * Hilos trabajadores de todo el proceso: se crean la primera vez que hacen
+ * falta y esperan el siguiente trabajo hasta que el proceso termina. Cada
+ * hilo h tiene su cola de bloques (la del hilo 0 es la de quien llama).
+ */
+class Trabajadores {
+public:
+    ~Trabajadores() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cerrando = true;
+        }
+        hayTrabajo.notify_all();
+        for (auto& hilo : hilos) {
+            hilo.join();
+        }
+    }
+
+    void ejecutar(Trabajo& trabajo) {
+        // De a un trabajo: todos usan las mismas colas y los mismos hilos
+        std::lock_guard<std::mutex> enCurso(mutexTrabajo);
+        asegurarHilos(trabajo.numHilos);
+
+        size_t numBloques = (trabajo.total + trabajo.tamBloque - 1) / trabajo.tamBloque;
+        for (int h = 0; h < trabajo.numHilos; h++) {
+            colas[h]->bloques.clear();
+        }
+        for (size_t b = 0; b < numBloques; b++) {
+            colas[b * trabajo.numHilos / numBloques]->bloques.push_back(b);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            actual = &trabajo;
+            pendientes = trabajo.numHilos - 1;
+            generacion++;
+        }
+        hayTrabajo.notify_all();
+
+        dentroDelPool = true;
+        trabajar(trabajo, 0);
+        dentroDelPool = false;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        terminado.wait(lock, [&]() { return pendientes == 0; });
+        actual = nullptr;
+    }
+
+private:
+    std::mutex mutexTrabajo;
+    std::mutex mutex;
+    std::condition_variable hayTrabajo;
+    std::condition_variable terminado;
+    std::vector<std::thread> hilos;                  // El hilo h + 1 del trabajo
+    std::vector<std::unique_ptr<ColaBloques>> colas;
+    Trabajo* actual = nullptr;
+    uint64_t generacion = 0;
+    int pendientes = 0;
+    bool cerrando = false;
+
+    void asegurarHilos(int numHilos) {
+        while (colas.size() < static_cast<size_t>(numHilos)) {
+            colas.emplace_back(new ColaBloques());
+        }
+        while (hilos.size() + 1 < static_cast<size_t>(numHilos)) {
+            int hilo = static_cast<int>(hilos.size()) + 1;
+            hilos.emplace_back([this, hilo]() { esperarTrabajos(hilo); });
+        }
+    }
+
+    void esperarTrabajos(int hilo) {
+        dentroDelPool = true;
+        uint64_t visto = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            hayTrabajo.wait(lock, [&]() { return cerrando || generacion != visto; });
+            if (cerrando) {
+                return;
+            }
+            visto = generacion;
+
+            // Un trabajo con menos hilos no usa a este (y puede haber
+            // terminado antes de que este hilo despertara)
+            Trabajo* trabajo = actual;
+            if (trabajo == nullptr || hilo >= trabajo->numHilos) {
+                continue;
+            }
+
+            lock.unlock();
+            trabajar(*trabajo, hilo);
+            lock.lock();
+            if (--pendientes == 0) {
+                terminado.notify_one();
+            }
+        }
+    }
+
+    void trabajar(Trabajo& trabajo, int hilo) {
+        try {
+            size_t bloque;
+            while (true) {
+                bool hayBloque = colas[hilo]->tomarFrente(bloque);
+
+                // Cola propia vacía: robar a los demás hilos
+                for (int k = 1; !hayBloque && k < trabajo.numHilos; k++) {
+                    hayBloque = colas[(hilo + k) % trabajo.numHilos]->robarFinal(bloque);
+                }
+
+                if (!hayBloque) {
+                    break;  // No se crean bloques nuevos: todo está repartido
+                }
+
+                size_t inicio = bloque * trabajo.tamBloque;
+                size_t fin = std::min(trabajo.total, inicio + trabajo.tamBloque);
+                for (size_t i = inicio; i < fin; i++) {
+                    (*trabajo.tarea)(i, hilo);
+                }
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(trabajo.mutexError);
+            if (!trabajo.primerError) {
+                trabajo.primerError = std::current_exception();
+            }
+        }
+    }
+};
+
+}
+
+void PoolHilos::paraCada(
+    size_t total,
+    int numHilos,
+    const std::function<void(size_t indice, int hilo)>& tarea
+) {
+    if (numHilos <= 1 || total <= 1 || dentroDelPool) {
+        for (size_t i = 0; i < total; i++) {
+            tarea(i, 0);
+        }
+        return;
+    }
+
+    if (static_cast<size_t>(numHilos) > total) {
+        numHilos = total;
+    }
+
+    // ~16 bloques por hilo: suficientes para robar sin saturar los mutex
+    Trabajo trabajo;
+    trabajo.total = total;
+    trabajo.numHilos = numHilos;
+    trabajo.tamBloque = std::max<size_t>(1, total / (static_cast<size_t>(numHilos) * 16));
+    trabajo.tarea = &tarea;
+
+    static Trabajadores trabajadores;
+    trabajadores.ejecutar(trabajo);
+
+    if (trabajo.primerError) {
+        std::rethrow_exception(trabajo.primerError);
+    }
+}
+
+int PoolHilos::hilosDisponibles() {
+    unsigned int n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : static_cast<int>(n);
+}
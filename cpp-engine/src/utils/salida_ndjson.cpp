@@ -0,0 +1,127 @@
+#include "../../include/salida_ndjson.h"
+#include <charconv>
+#include <cstring>
+
+SalidaNDJSON::SalidaNDJSON(std::FILE* destino, size_t capacidad)
+    : destino(destino), buffer(capacidad < 256 ? 256 : capacidad) {}
+
+SalidaNDJSON::~SalidaNDJSON() {
+    vaciar();
+}
+
+void SalidaNDJSON::encabezado(const std::vector<std::string>& patrones, const ResultadoBusqueda& resultado) {
+    escribir("{\"tipo\":\"encabezado\",\"exito\":true,\"patrones\":[");
+    for (size_t i = 0; i < patrones.size(); i++) {
+        if (i > 0) escribir(",");
+        escribirCadena(patrones[i]);
+    }
+    escribir("],\"num_patrones\":");
+    escribirNumero(patrones.size());
+    escribir(",\"algoritmo_usado\":");
+    escribirCadena(resultado.algoritmo);
+    escribir(",\"criterio_seleccion\":");
+    escribirCadena(resultado.criterio);
+    escribir(",\"total_procesados\":");
+    escribirNumero(resultado.totalProcesados);
+    escribir("}\n");
+
+    // El encabezado sale enseguida: el cliente sabe que la búsqueda empezó
+    vaciar();
+}
+
+void SalidaNDJSON::coincidencia(const CoincidenciaVista& coincidencia) {
+    escribir("{\"tipo\":\"coincidencia\",\"nombre\":");
+    escribirCadena(coincidencia.nombre);
+    escribir(",\"cedula\":");
+    escribirCadena(coincidencia.cedula);
+    escribir(",\"patron_id\":");
+    escribirNumero(coincidencia.patronId);
+    escribir(",\"posicion\":");
+    escribirNumero(coincidencia.posicion);
+    escribir(",\"distancia\":");
+    escribirNumero(coincidencia.distancia);
+    escribir(",\"hebra\":\"");
+    escribir(std::string_view(&coincidencia.hebra, 1));
+    escribir("\"}\n");
+    totalCoincidencias++;
+}
+
+void SalidaNDJSON::resumen(long tiempoEjecucionMs, const Metricas* metricas) {
+    escribir("{\"tipo\":\"resumen\",\"exito\":true,\"total_coincidencias\":");
+    escribirNumero(totalCoincidencias);
+    escribir(",\"tiempo_ejecucion_ms\":");
+    escribirNumero(tiempoEjecucionMs);
+    if (metricas != nullptr) {
+        escribir(",\"metricas\":");
+        escribir(JSONOutput::generarMetricas(*metricas));
+    }
+    escribir("}\n");
+    vaciar();
+}
+
+void SalidaNDJSON::error(const std::string& mensajeError, const std::string& codigoError, const std::string& detalles) {
+    escribir("{\"tipo\":\"error\",\"exito\":false,\"error\":");
+    escribirCadena(mensajeError);
+    escribir(",\"codigo_error\":");
+    escribirCadena(codigoError);
+    escribir(",\"detalles\":");
+    escribirCadena(detalles);
+    escribir("}\n");
+    vaciar();
+}
+
+void SalidaNDJSON::vaciar() {
+    if (usado > 0) {
+        std::fwrite(buffer.data(), 1, usado, destino);
+        usado = 0;
+    }
+    std::fflush(destino);
+}
+
+void SalidaNDJSON::escribir(std::string_view texto) {
+    if (usado + texto.size() > buffer.size()) {
+        vaciar();
+        // Un texto más grande que el buffer va directo al destino
+        if (texto.size() > buffer.size()) {
+            std::fwrite(texto.data(), 1, texto.size(), destino);
+            return;
+        }
+    }
+    std::memcpy(buffer.data() + usado, texto.data(), texto.size());
+    usado += texto.size();
+}
+
+void SalidaNDJSON::escribirCadena(std::string_view texto) {
+    static const char HEX[] = "0123456789abcdef";
+
+    escribir("\"");
+    size_t pendiente = 0;  // Inicio del tramo que no necesita escape
+    for (size_t i = 0; i < texto.size(); i++) {
+        unsigned char c = texto[i];
+        if (c != '"' && c != '\\' && c >= 0x20) continue;
+
+        escribir(texto.substr(pendiente, i - pendiente));
+        pendiente = i + 1;
+        switch (c) {
+            case '"':  escribir("\\\""); break;
+            case '\\': escribir("\\\\"); break;
+            case '\b': escribir("\\b"); break;
+            case '\f': escribir("\\f"); break;
+            case '\n': escribir("\\n"); break;
+            case '\r': escribir("\\r"); break;
+            case '\t': escribir("\\t"); break;
+            default: {
+                char unicode[6] = {'\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0xF]};
+                escribir(std::string_view(unicode, sizeof(unicode)));
+            }
+        }
+    }
+    escribir(texto.substr(pendiente));
+    escribir("\"");
+}
+
+void SalidaNDJSON::escribirNumero(long long valor) {
+    char digitos[24];
+    auto fin = std::to_chars(digitos, digitos + sizeof(digitos), valor).ptr;
+    escribir(std::string_view(digitos, fin - digitos));
+}
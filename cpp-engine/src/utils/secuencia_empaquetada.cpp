@@ -0,0 +1,140 @@
+#include "../../include/secuencia_empaquetada.h"
+#include "../../include/validacion_adn.h"
+#include <algorithm>
+#include <utility>
+
+SecuenciaEmpaquetada::SecuenciaEmpaquetada() : almacen(1, 0), palabras(almacen.data()), numBases(0) {}
+
+SecuenciaEmpaquetada::SecuenciaEmpaquetada(std::string_view cadenaADN)
+    : almacen(palabrasNecesarias(cadenaADN.length()), 0), numBases(cadenaADN.length()) {
+
+    // Una cadena con otros caracteres se empaqueta base a base (como 0)
+    if (!ValidacionADN::validarYEmpaquetar(cadenaADN, almacen.data())) {
+        std::fill(almacen.begin(), almacen.end(), 0);
+        for (size_t i = 0; i < numBases; i++) {
+            almacen[i >> 5] |= static_cast<uint64_t>(codificar(cadenaADN[i])) << ((i & 31) * 2);
+        }
+    }
+    palabras = almacen.data();
+}
+
+bool SecuenciaEmpaquetada::empaquetarValidando(std::string_view cadenaADN, SecuenciaEmpaquetada& destino) {
+    std::vector<uint64_t> almacen(palabrasNecesarias(cadenaADN.length()), 0);
+    if (!ValidacionADN::validarYEmpaquetar(cadenaADN, almacen.data())) {
+        return false;
+    }
+
+    destino.almacen = std::move(almacen);
+    destino.palabras = destino.almacen.data();
+    destino.numBases = cadenaADN.length();
+    return true;
+}
+
+SecuenciaEmpaquetada::SecuenciaEmpaquetada(const SecuenciaEmpaquetada& otra)
+    : almacen(otra.almacen),
+      palabras(almacen.empty() ? otra.palabras : almacen.data()),
+      numBases(otra.numBases) {}
+
+SecuenciaEmpaquetada::SecuenciaEmpaquetada(SecuenciaEmpaquetada&& otra) noexcept
+    : almacen(std::move(otra.almacen)),
+      palabras(almacen.empty() ? otra.palabras : almacen.data()),
+      numBases(otra.numBases) {}
+
+SecuenciaEmpaquetada& SecuenciaEmpaquetada::operator=(const SecuenciaEmpaquetada& otra) {
+    if (this != &otra) {
+        almacen = otra.almacen;
+        palabras = almacen.empty() ? otra.palabras : almacen.data();
+        numBases = otra.numBases;
+    }
+    return *this;
+}
+
+SecuenciaEmpaquetada& SecuenciaEmpaquetada::operator=(SecuenciaEmpaquetada&& otra) noexcept {
+    if (this != &otra) {
+        const uint64_t* palabrasOtra = otra.palabras;
+        almacen = std::move(otra.almacen);
+        palabras = almacen.empty() ? palabrasOtra : almacen.data();
+        numBases = otra.numBases;
+    }
+    return *this;
+}
+
+SecuenciaEmpaquetada::SecuenciaEmpaquetada(const uint64_t* palabras, size_t numBases)
+    : palabras(palabras), numBases(numBases) {}
+
+SecuenciaEmpaquetada SecuenciaEmpaquetada::vista(const uint64_t* palabras, size_t numBases) {
+    return SecuenciaEmpaquetada(palabras, numBases);
+}
+
+size_t SecuenciaEmpaquetada::coincidenciaDesde(
+    size_t posicion,
+    const SecuenciaEmpaquetada& patron,
+    size_t desde
+) const {
+    size_t m = patron.numBases;
+    size_t j = desde;
+
+    while (j < m) {
+        uint64_t diferencia = ventana(posicion + j) ^ patron.ventana(j);
+        size_t restantes = m - j;
+
+        // Ignorar las bases que pasan del final del patrón
+        if (restantes < 32) {
+            diferencia &= (1ULL << (2 * restantes)) - 1;
+        }
+
+        if (diferencia != 0) {
+            return j + primeraDiferencia(diferencia);
+        }
+
+        j += restantes < 32 ? restantes : 32;
+    }
+
+    return m;
+}
+
+size_t SecuenciaEmpaquetada::diferenciasDesde(
+    size_t posicion,
+    const SecuenciaEmpaquetada& patron,
+    size_t limite
+) const {
+    size_t m = patron.numBases;
+    size_t diferencias = 0;
+
+    for (size_t j = 0; j < m && diferencias <= limite; j += 32) {
+        uint64_t diferencia = ventana(posicion + j) ^ patron.ventana(j);
+        size_t restantes = m - j;
+
+        // Ignorar las bases que pasan del final del patrón
+        if (restantes < 32) {
+            diferencia &= (1ULL << (2 * restantes)) - 1;
+        }
+
+        diferencias += contarDiferencias(diferencia);
+    }
+
+    return diferencias;
+}
+
+std::string SecuenciaEmpaquetada::desempaquetar() const {
+    std::string cadena(numBases, 'A');
+    for (size_t i = 0; i < numBases; i++) {
+        cadena[i] = decodificar(base(i));
+    }
+    return cadena;
+}
+
+uint8_t SecuenciaEmpaquetada::codificar(char c) {
+    switch (c) {
+        case 'A': return 0;
+        case 'T': return 1;
+        case 'C': return 2;
+        case 'G': return 3;
+        default: return 0; // Por si acaso, aunque no debería pasar
+    }
+}
+
+char SecuenciaEmpaquetada::decodificar(uint8_t codigo) {
+    static const char BASES[4] = {'A', 'T', 'C', 'G'};
+    return BASES[codigo & 3];
+}
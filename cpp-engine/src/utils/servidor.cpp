@@ -0,0 +1,443 @@
+#include "../../include/servidor.h"
+#include "../../include/motor_busqueda.h"
+#include "../../include/json_output.h"
+#include <iostream>
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+#include <cctype>
+#include <utility>
+#include <atomic>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <cerrno>
+#include <cstring>
+#include <list>
+#include <memory>
+
+namespace {
+
+// Extremo de escritura de la tubería que despierta al bucle de accept
+// cuando llega SIGINT o SIGTERM (-1 fuera de atenderSocket)
+volatile sig_atomic_t avisoCierreFd = -1;
+
+void pedirCierre(int) {
+    int fd = avisoCierreFd;
+    if (fd >= 0) {
+        int errnoAnterior = errno;
+        ssize_t escrito = write(fd, "x", 1);
+        (void)escrito;
+        errno = errnoAnterior;
+    }
+}
+
+// Un cliente del socket: su hilo y si ya terminó (para unirlo)
+struct Cliente {
+    int fd;
+    std::thread hilo;
+    std::shared_ptr<std::atomic<bool>> terminado;
+};
+
+// Une los hilos de los clientes que ya cerraron y libera sus sockets
+void unirTerminados(std::list<Cliente>& clientes) {
+    for (auto it = clientes.begin(); it != clientes.end();) {
+        if (it->terminado->load()) {
+            it->hilo.join();
+            close(it->fd);
+            it = clientes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+}
+#endif
+
+Servidor::Servidor(const std::string& rutaCSV, const OpcionesBusqueda& opciones, size_t presupuestoCache)
+    : rutaCSV(rutaCSV), opciones(opciones), cache(presupuestoCache) {
+    cargar();
+}
+
+void Servidor::cargar() {
+    std::lock_guard<std::mutex> bloqueo(escritura);
+
+    // La versión sigue creciendo: una recarga nunca repite la de una
+    // instantánea anterior
+    std::shared_ptr<const Instantanea> anterior = std::atomic_load(&instantanea);
+    publicar(Instantanea::cargar(rutaCSV, anterior ? anterior->version() + 1 : 1));
+    inactivos.clear();
+}
+
+void Servidor::publicar(std::shared_ptr<const Instantanea> nueva) {
+    // Las búsquedas en curso conservan su referencia a la anterior
+    std::atomic_store(&instantanea, std::move(nueva));
+}
+
+void Servidor::atenderStdin() {
+    std::string linea;
+    std::string respuesta;
+
+    while (std::getline(std::cin, linea)) {
+        bool continuar = procesarLinea(linea, respuesta);
+
+        if (!respuesta.empty()) {
+            std::cout << respuesta << std::endl;
+        }
+
+        if (!continuar) {
+            break;
+        }
+    }
+}
+
+void Servidor::atenderSocket(const std::string& rutaSocket) {
+#ifdef _WIN32
+    (void)rutaSocket;
+    throw std::runtime_error("Los sockets Unix no están disponibles en Windows, use stdin");
+#else
+    int servidorFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (servidorFd < 0) {
+        throw std::runtime_error("No se pudo crear el socket: " + rutaSocket);
+    }
+
+    sockaddr_un direccion;
+    std::memset(&direccion, 0, sizeof(direccion));
+    direccion.sun_family = AF_UNIX;
+
+    if (rutaSocket.length() >= sizeof(direccion.sun_path)) {
+        close(servidorFd);
+        throw std::runtime_error("Ruta de socket demasiado larga: " + rutaSocket);
+    }
+    std::strncpy(direccion.sun_path, rutaSocket.c_str(), sizeof(direccion.sun_path) - 1);
+
+    // Eliminar un socket anterior que haya quedado en disco
+    unlink(rutaSocket.c_str());
+
+    if (bind(servidorFd, reinterpret_cast<sockaddr*>(&direccion), sizeof(direccion)) < 0 ||
+        listen(servidorFd, 8) < 0) {
+        close(servidorFd);
+        throw std::runtime_error("No se pudo escuchar en el socket: " + rutaSocket);
+    }
+
+    // SIGINT/SIGTERM escriben en la tubería: poll despierta y el bucle termina
+    int avisoCierre[2];
+    if (pipe(avisoCierre) < 0) {
+        close(servidorFd);
+        unlink(rutaSocket.c_str());
+        throw std::runtime_error("No se pudo crear la tubería de cierre del servidor");
+    }
+    fcntl(avisoCierre[1], F_SETFL, O_NONBLOCK);
+
+    // Sin bloquear en accept: una conexión que se cae entre poll y accept
+    // no debe dejar el bucle esperando la siguiente
+    fcntl(servidorFd, F_SETFL, fcntl(servidorFd, F_GETFL) | O_NONBLOCK);
+
+    avisoCierreFd = avisoCierre[1];
+    struct sigaction accion;
+    std::memset(&accion, 0, sizeof(accion));
+    accion.sa_handler = pedirCierre;
+    sigemptyset(&accion.sa_mask);
+    struct sigaction anteriorInt, anteriorTerm;
+    sigaction(SIGINT, &accion, &anteriorInt);
+    sigaction(SIGTERM, &accion, &anteriorTerm);
+
+    // El servidor sigue activo aunque un cliente envíe SALIR. Cada cliente
+    // tiene su hilo: una búsqueda larga no demora a los demás
+    std::list<Cliente> clientes;
+    std::string errorFatal;
+    int esperaMs = 0;  // Espera tras quedarse sin descriptores o memoria
+
+    while (true) {
+        // Durante la espera solo se mira la tubería: la conexión pendiente
+        // deja al socket listo y poll volvería de inmediato
+        pollfd eventos[2] = {
+            {avisoCierre[0], POLLIN, 0},
+            {servidorFd, POLLIN, 0}
+        };
+        if (poll(eventos, esperaMs > 0 ? 1 : 2, esperaMs > 0 ? esperaMs : -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            errorFatal = std::string("poll: ") + std::strerror(errno);
+            break;
+        }
+        if (eventos[0].revents != 0) {
+            break;
+        }
+
+        unirTerminados(clientes);
+
+        int clienteFd = accept(servidorFd, nullptr, nullptr);
+        if (clienteFd < 0) {
+            int error = errno;
+            if (error == EINTR || error == ECONNABORTED || error == EAGAIN || error == EWOULDBLOCK) {
+                continue;
+            }
+            if (error == EMFILE || error == ENFILE || error == ENOBUFS || error == ENOMEM) {
+                // Sin recursos la conexión sigue pendiente: reintentar en
+                // seguida solo giraría. Se espera a que cierre algún cliente
+                esperaMs = esperaMs == 0 ? 50 : std::min(esperaMs * 2, 1000);
+                continue;
+            }
+            errorFatal = std::string("accept: ") + std::strerror(error);
+            break;
+        }
+        esperaMs = 0;
+
+        // Algunos sistemas heredan O_NONBLOCK del socket que escucha
+        fcntl(clienteFd, F_SETFL, fcntl(clienteFd, F_GETFL) & ~O_NONBLOCK);
+
+        auto terminado = std::make_shared<std::atomic<bool>>(false);
+        clientes.push_back({clienteFd, std::thread([this, clienteFd, terminado]() {
+            atenderCliente(clienteFd);
+            terminado->store(true);
+        }), terminado});
+    }
+
+    // Cierre: no se aceptan más conexiones y cada cliente termina al
+    // responder la línea en curso (su read devuelve fin de entrada)
+    sigaction(SIGINT, &anteriorInt, nullptr);
+    sigaction(SIGTERM, &anteriorTerm, nullptr);
+    avisoCierreFd = -1;
+    close(avisoCierre[0]);
+    close(avisoCierre[1]);
+    close(servidorFd);
+    unlink(rutaSocket.c_str());
+
+    for (auto& cliente : clientes) {
+        shutdown(cliente.fd, SHUT_RDWR);
+    }
+    for (auto& cliente : clientes) {
+        cliente.hilo.join();
+        close(cliente.fd);
+    }
+
+    if (!errorFatal.empty()) {
+        throw std::runtime_error("El servidor dejó de aceptar conexiones (" + errorFatal + ")");
+    }
+#endif
+}
+
+void Servidor::atenderCliente(int clienteFd) {
+#ifdef _WIN32
+    (void)clienteFd;
+#else
+    // Leer bytes y procesar cada línea completa
+    std::string pendiente;
+    std::string respuesta;
+    std::vector<char> buffer(65536);
+    ssize_t leidos;
+    bool activo = true;
+
+    while (activo && (leidos = read(clienteFd, buffer.data(), buffer.size())) > 0) {
+        pendiente.append(buffer.data(), leidos);
+
+        size_t finLinea;
+        while (activo && (finLinea = pendiente.find('\n')) != std::string::npos) {
+            std::string linea = pendiente.substr(0, finLinea);
+            pendiente.erase(0, finLinea + 1);
+
+            activo = procesarLinea(linea, respuesta);
+
+            if (!respuesta.empty()) {
+                respuesta += '\n';
+                size_t enviados = 0;
+                while (enviados < respuesta.length()) {
+                    ssize_t n = write(clienteFd, respuesta.data() + enviados,
+                                      respuesta.length() - enviados);
+                    if (n <= 0) break;
+                    enviados += n;
+                }
+            }
+        }
+    }
+
+    // El socket lo cierra atenderSocket al unir este hilo
+#endif
+}
+
+bool Servidor::procesarLinea(const std::string& linea, std::string& respuesta) {
+    respuesta.clear();
+
+    // Quitar espacios y retorno de carro (clientes Windows)
+    size_t inicio = linea.find_first_not_of(" \t\r\n");
+    size_t fin = linea.find_last_not_of(" \t\r\n");
+
+    if (inicio == std::string::npos) {
+        return true;  // Línea vacía: no hay respuesta
+    }
+
+    std::string comando = linea.substr(inicio, fin - inicio + 1);
+
+    if (comando == "SALIR") {
+        return false;
+    }
+
+    if (comando == "RECARGAR") {
+        try {
+            cargar();
+            size_t total = std::atomic_load(&instantanea)->size();
+            respuesta = JSONOutput::generarExito({}, "", "recarga", total, {}, 0);
+        } catch (const std::exception& e) {
+            respuesta = JSONOutput::generarError(
+                "Error al leer archivo CSV",
+                "FILE_ERROR",
+                std::string(e.what())
+            );
+        }
+        return true;
+    }
+
+    // Cambios: "COMANDO argumento"
+    size_t espacio = comando.find(' ');
+    std::string palabra = comando.substr(0, espacio);
+    if (palabra == "AGREGAR" || palabra == "DESACTIVAR" || palabra == "ACTIVAR" || palabra == "ELIMINAR") {
+        std::string_view argumento;
+        if (espacio != std::string::npos) {
+            argumento = std::string_view(comando).substr(espacio + 1);
+        }
+        respuesta = responderCambio(palabra, argumento);
+        return true;
+    }
+
+    respuesta = responderBusqueda(comando);
+    return true;
+}
+
+std::string Servidor::responderBusqueda(const std::string& patronesInput) {
+    auto inicio = std::chrono::high_resolution_clock::now();
+    Cronometro cronometro;
+    Metricas metricas;   // Sin ingesta: los sospechosos ya están en memoria
+
+    try {
+        std::vector<std::string> patrones = MotorBusqueda::dividirPatrones(patronesInput);
+        metricas.parseoArgumentosNs = cronometro.reiniciar();
+        MotorBusqueda::validarPatrones(patrones);
+        MotorBusqueda::validarOpciones(patrones, opciones);
+        metricas.validacionNs = cronometro.reiniciar();
+
+        // La instantánea vigente al empezar: los cambios que lleguen
+        // mientras tanto no afectan esta búsqueda
+        std::shared_ptr<const Instantanea> actual = std::atomic_load(&instantanea);
+
+        // Misma consulta sobre la misma versión: no hace falta recorrer
+        std::string clave = CacheResultados::clave(patrones, opciones, actual->version());
+        ResultadoBusqueda resultado;
+        bool cacheHit = cache.buscar(clave, patrones, resultado);
+        if (!cacheHit) {
+            OpcionesBusqueda conMetricas = opciones;
+            conMetricas.metricas = &metricas;
+            resultado = MotorBusqueda::ejecutar(patrones, *actual, conMetricas);
+            cache.guardar(clave, patrones, resultado);
+        }
+
+        auto fin = std::chrono::high_resolution_clock::now();
+        auto duracion = std::chrono::duration_cast<std::chrono::milliseconds>(fin - inicio);
+        metricas.picoMemoriaBytes = Metricas::leerPicoMemoria();
+
+        return JSONOutput::generarExito(
+            patrones,
+            resultado.algoritmo,
+            resultado.criterio,
+            resultado.totalProcesados,
+            resultado.coincidencias,
+            duracion.count(),
+            cacheHit,
+            &metricas
+        );
+
+    } catch (const ErrorBusqueda& e) {
+        return JSONOutput::generarError(e.what(), e.codigo, e.detalles);
+    } catch (const std::exception& e) {
+        return JSONOutput::generarError(
+            "Error inesperado",
+            "UNEXPECTED_ERROR",
+            std::string(e.what())
+        );
+    }
+}
+
+std::string Servidor::responderCambio(const std::string& comando, std::string_view argumento) {
+    size_t inicio = argumento.find_first_not_of(" \t");
+    argumento = inicio == std::string_view::npos ? std::string_view() : argumento.substr(inicio);
+
+    if (argumento.empty()) {
+        return JSONOutput::generarError(
+            "Falta el argumento de " + comando,
+            "INVALID_ARGUMENTS",
+            comando == "AGREGAR" ? "AGREGAR nombre,cedula,adn" : comando + " cedula"
+        );
+    }
+
+    // El registro se valida antes de tomar el lock
+    std::vector<Instantanea::Registro> nuevos;
+    if (comando == "AGREGAR") {
+        try {
+            nuevos.push_back(Instantanea::crearRegistro(CSVParser::parsearRegistro(argumento)));
+        } catch (const std::exception& e) {
+            return JSONOutput::generarError(
+                "Sospechoso inválido",
+                "INVALID_SUSPECT",
+                std::string(e.what())
+            );
+        }
+    }
+
+    std::lock_guard<std::mutex> bloqueo(escritura);
+    std::shared_ptr<const Instantanea> actual = std::atomic_load(&instantanea);
+    std::shared_ptr<const Instantanea> nueva;
+
+    if (comando == "AGREGAR") {
+        nueva = actual->agregar(nuevos);
+    } else if (comando == "ACTIVAR") {
+        auto rango = inactivos.equal_range(argumento);
+        for (auto it = rango.first; it != rango.second; ++it) {
+            nuevos.push_back(it->second);
+        }
+        if (!nuevos.empty()) {
+            inactivos.erase(rango.first, rango.second);
+            nueva = actual->agregar(nuevos);
+        }
+    } else {
+        std::vector<Instantanea::Registro> quitados;
+        nueva = actual->quitar(argumento, quitados);
+
+        if (comando == "DESACTIVAR") {
+            for (auto& registro : quitados) {
+                inactivos.emplace(std::string(registro.vista.cedula), std::move(registro));
+            }
+        } else {
+            // ELIMINAR también alcanza a los desactivados
+            auto rango = inactivos.equal_range(argumento);
+            if (rango.first != rango.second) {
+                inactivos.erase(rango.first, rango.second);
+                if (!nueva) {
+                    nueva = actual;
+                }
+            }
+        }
+    }
+
+    if (!nueva) {
+        return JSONOutput::generarError(
+            "Sospechoso no encontrado",
+            "SUSPECT_NOT_FOUND",
+            std::string(argumento)
+        );
+    }
+
+    publicar(nueva);
+
+    std::string criterio = comando;
+    std::transform(criterio.begin(), criterio.end(), criterio.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return JSONOutput::generarExito({}, "", criterio, nueva->size(), {}, 0);
+}
@@ -0,0 +1,20 @@
+#include "../../include/traza.h"
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+
+Traza::Nivel Traza::leerNivel(const std::string& nombre) {
+    if (nombre == "off") return APAGADA;
+    if (nombre == "info") return INFORMACION;
+    if (nombre == "debug") return DEPURACION;
+    throw std::invalid_argument("Nivel de traza desconocido: " + nombre);
+}
+
+void Traza::escribir(Nivel nivel, const std::string& mensaje) {
+    static std::mutex mutex;
+
+    std::string linea = (nivel == DEPURACION ? "[DEBUG] " : "[INFO] ") + mensaje + "\n";
+
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    std::fwrite(linea.data(), 1, linea.size(), stderr);
+}
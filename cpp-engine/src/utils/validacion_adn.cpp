@@ -0,0 +1,150 @@
+#include "../../include/validacion_adn.h"
+#include "../../include/busqueda_simd.h"
+#include "../../include/cursor_bases.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VALIDACION_ADN_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define OBJETIVO_AVX2 __attribute__((target("avx2")))
+#define OBJETIVO_SSE2 __attribute__((target("sse2")))
+#else
+#define OBJETIVO_AVX2
+#define OBJETIVO_SSE2
+#endif
+
+namespace {
+
+/**
+ * Lleva el bit k de x al bit 2k (los bits impares quedan en cero)
+ */
+uint64_t intercalar(uint32_t x) {
+    uint64_t v = x;
+    v = (v | (v << 16)) & 0x0000FFFF0000FFFFULL;
+    v = (v | (v << 8)) & 0x00FF00FF00FF00FFULL;
+    v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    v = (v | (v << 2)) & 0x3333333333333333ULL;
+    v = (v | (v << 1)) & 0x5555555555555555ULL;
+    return v;
+}
+
+/**
+ * Palabra con los códigos de 32 bases a partir de las máscaras de sus
+ * bits 2 (bit bajo del código) y 1 (bit alto) del ASCII
+ */
+uint64_t palabraDesdeMascaras(uint32_t bitsBajos, uint32_t bitsAltos) {
+    return intercalar(bitsBajos) | (intercalar(bitsAltos) << 1);
+}
+
+// Base a base (el resto que no llena un bloque, o CPUs sin SSE2)
+bool validarEscalar(const char* texto, size_t n, uint64_t* palabras) {
+    uint64_t palabra = 0;
+    for (size_t i = 0; i < n; i++) {
+        int codigo = codigoBase(texto[i]);
+        if (codigo < 0) {
+            return false;
+        }
+        palabra |= static_cast<uint64_t>(codigo) << ((i & 31) * 2);
+
+        if ((i & 31) == 31 || i + 1 == n) {
+            if (palabras != nullptr) {
+                palabras[i >> 5] = palabra;
+            }
+            palabra = 0;
+        }
+    }
+    return true;
+}
+
+#ifdef VALIDACION_ADN_X86
+
+OBJETIVO_AVX2
+bool validarAVX2(const char* texto, size_t n, uint64_t* palabras) {
+    const __m256i a = _mm256_set1_epi8('A');
+    const __m256i t = _mm256_set1_epi8('T');
+    const __m256i c = _mm256_set1_epi8('C');
+    const __m256i g = _mm256_set1_epi8('G');
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i bloque = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(texto + i));
+        __m256i validas = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(bloque, a), _mm256_cmpeq_epi8(bloque, t)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(bloque, c), _mm256_cmpeq_epi8(bloque, g)));
+
+        if (static_cast<uint32_t>(_mm256_movemask_epi8(validas)) != 0xFFFFFFFFu) {
+            return false;
+        }
+
+        if (palabras != nullptr) {
+            // Desplazar 5 (o 6) lleva el bit 2 (o 1) de cada byte a su bit 7
+            palabras[i >> 5] = palabraDesdeMascaras(
+                static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_slli_epi16(bloque, 5))),
+                static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_slli_epi16(bloque, 6))));
+        }
+    }
+
+    return validarEscalar(texto + i, n - i, palabras != nullptr ? palabras + (i >> 5) : nullptr);
+}
+
+OBJETIVO_SSE2
+bool validarSSE2(const char* texto, size_t n, uint64_t* palabras) {
+    const __m128i a = _mm_set1_epi8('A');
+    const __m128i t = _mm_set1_epi8('T');
+    const __m128i c = _mm_set1_epi8('C');
+    const __m128i g = _mm_set1_epi8('G');
+
+    auto validas = [&](__m128i bloque) {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(bloque, a), _mm_cmpeq_epi8(bloque, t)),
+            _mm_or_si128(_mm_cmpeq_epi8(bloque, c), _mm_cmpeq_epi8(bloque, g)))));
+    };
+
+    // Dos bloques de 16 por palabra empaquetada
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m128i bajo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(texto + i));
+        __m128i alto = _mm_loadu_si128(reinterpret_cast<const __m128i*>(texto + i + 16));
+
+        if ((validas(bajo) & validas(alto)) != 0xFFFFu) {
+            return false;
+        }
+
+        if (palabras != nullptr) {
+            uint32_t bitsBajos = static_cast<uint32_t>(_mm_movemask_epi8(_mm_slli_epi16(bajo, 5))) |
+                                 static_cast<uint32_t>(_mm_movemask_epi8(_mm_slli_epi16(alto, 5))) << 16;
+            uint32_t bitsAltos = static_cast<uint32_t>(_mm_movemask_epi8(_mm_slli_epi16(bajo, 6))) |
+                                 static_cast<uint32_t>(_mm_movemask_epi8(_mm_slli_epi16(alto, 6))) << 16;
+            palabras[i >> 5] = palabraDesdeMascaras(bitsBajos, bitsAltos);
+        }
+    }
+
+    return validarEscalar(texto + i, n - i, palabras != nullptr ? palabras + (i >> 5) : nullptr);
+}
+
+#endif
+
+bool recorrer(std::string_view cadenaADN, uint64_t* palabras) {
+    switch (BusquedaSIMD::instruccionesDisponibles()) {
+#ifdef VALIDACION_ADN_X86
+        case BusquedaSIMD::AVX2:
+            return validarAVX2(cadenaADN.data(), cadenaADN.length(), palabras);
+        case BusquedaSIMD::SSE2:
+            return validarSSE2(cadenaADN.data(), cadenaADN.length(), palabras);
+#endif
+        default:
+            return validarEscalar(cadenaADN.data(), cadenaADN.length(), palabras);
+    }
+}
+
+}
+
+bool ValidacionADN::validar(std::string_view cadenaADN) {
+    return recorrer(cadenaADN, nullptr);
+}
+
+bool ValidacionADN::validarYEmpaquetar(std::string_view cadenaADN, uint64_t* palabras) {
+    return recorrer(cadenaADN, palabras);
+}
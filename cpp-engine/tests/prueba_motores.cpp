@@ -0,0 +1,395 @@
+/**
+ * Prueba diferencial de los motores de búsqueda (ctest -R motores)
+ *
+ * Cada motor, sobre texto y sobre cadenas empaquetadas, se ejecuta con
+ * textos de ADN al azar y con entradas adversas (una sola base repetida,
+ * patrones periódicos, alfabetos de dos bases, patrones que son prefijo
+ * o sufijo de otros, apariciones en los bordes de las palabras de 32
+ * bases) y sus posiciones se comparan con las de ReferenciaIngenua.
+ *
+ * Uso: prueba_motores [--semilla S] [--casos N]
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <functional>
+#include "referencia_ingenua.h"
+#include "../include/kmp.h"
+#include "../include/rabin_karp.h"
+#include "../include/aho_corasick.h"
+#include "../include/busqueda_simd.h"
+#include "../include/busqueda_aproximada.h"
+#include "../include/secuencia_empaquetada.h"
+using namespace std;
+
+// Se muestran solo los primeros fallos (el total se informa al final)
+const int FALLOS_MOSTRADOS = 20;
+
+/**
+ * Entrada de una prueba: un texto y los patrones que se buscan en él
+ */
+struct Caso {
+    string descripcion;
+    string texto;
+    vector<string> patrones;
+};
+
+/**
+ * Lleva la cuenta de comprobaciones y fallos
+ */
+class Verificador {
+public:
+    void comprobar(bool correcto, const Caso& caso, const string& motor, const function<string()>& detalle) {
+        comprobaciones++;
+        if (correcto) return;
+
+        fallos++;
+        if (fallos <= FALLOS_MOSTRADOS) {
+            cerr << "FALLO [" << motor << "] " << caso.descripcion << " (texto de " << caso.texto.length()
+                 << " bases, " << caso.patrones.size() << " patrones): " << detalle() << endl;
+        }
+    }
+
+    int comprobaciones = 0;
+    int fallos = 0;
+};
+
+string describir(const CoincidenciaMultiple& c) {
+    return "(patron " + to_string(c.patronId) + ", posicion " + to_string(c.posicion) + ")";
+}
+
+string describir(const vector<CoincidenciaMultiple>& coincidencias) {
+    ostringstream salida;
+    salida << coincidencias.size() << " coincidencias";
+    for (size_t i = 0; i < coincidencias.size() && i < 5; i++) {
+        salida << " " << describir(coincidencias[i]);
+    }
+    return salida.str();
+}
+
+/**
+ * Generador de casos reproducible a partir de una semilla
+ */
+class GeneradorCasos {
+public:
+    explicit GeneradorCasos(uint64_t semilla) : azar(semilla) {}
+
+    size_t entre(size_t minimo, size_t maximo) {
+        return uniform_int_distribution<size_t>(minimo, maximo)(azar);
+    }
+
+    string aleatoria(size_t n, const string& alfabeto = "ACGT") {
+        string cadena(n, 'A');
+        for (char& base : cadena) {
+            base = alfabeto[entre(0, alfabeto.length() - 1)];
+        }
+        return cadena;
+    }
+
+    /**
+     * Copia patrones dentro del texto, a veces justo en los bordes de una
+     * palabra empaquetada o al final
+     */
+    void plantar(Caso& caso, size_t veces) {
+        for (size_t i = 0; i < veces && !caso.patrones.empty(); i++) {
+            const string& patron = caso.patrones[entre(0, caso.patrones.size() - 1)];
+            if (patron.length() > caso.texto.length()) continue;
+
+            size_t maximo = caso.texto.length() - patron.length();
+            size_t posicion;
+            switch (entre(0, 3)) {
+                case 0: posicion = maximo; break;
+                case 1: posicion = min(maximo, entre(0, maximo / 32) * 32 + entre(0, 2) + 30); break;
+                default: posicion = entre(0, maximo); break;
+            }
+            caso.texto.replace(posicion, patron.length(), patron);
+        }
+    }
+
+    Caso siguiente(int numero) {
+        Caso caso;
+        switch (numero % 6) {
+            case 0: {
+                caso.descripcion = "aleatorio";
+                caso.texto = aleatoria(entre(0, 3000));
+                for (size_t i = entre(1, 6); i > 0; i--) {
+                    caso.patrones.push_back(aleatoria(entre(1, 300)));
+                }
+                plantar(caso, entre(0, 4));
+                break;
+            }
+            case 1: {
+                // Peor caso de las comparaciones directas: casi todo coincide
+                caso.descripcion = "homopolimero";
+                size_t m = entre(1, 200);
+                caso.texto = string(entre(0, 2000), 'A');
+                caso.patrones = {string(m, 'A'), string(m - 1, 'A') + "C", "C" + string(m - 1, 'A')};
+                plantar(caso, entre(0, 2));
+                break;
+            }
+            case 2: {
+                caso.descripcion = "periodico";
+                string unidad = aleatoria(entre(1, 7));
+                size_t n = entre(0, 3000);
+                while (caso.texto.length() < n) caso.texto += unidad;
+                for (size_t i = entre(1, 4); i > 0; i--) {
+                    size_t desplazamiento = entre(0, unidad.length() - 1);
+                    string patron;
+                    size_t m = entre(1, 300);
+                    while (patron.length() < m + desplazamiento) patron += unidad;
+                    patron = patron.substr(desplazamiento, m);
+                    if (entre(0, 2) == 0) patron.back() = aleatoria(1)[0];
+                    caso.patrones.push_back(patron);
+                }
+                break;
+            }
+            case 3: {
+                caso.descripcion = "dos bases";
+                caso.texto = aleatoria(entre(0, 3000), "AC");
+                for (size_t i = entre(1, 5); i > 0; i--) {
+                    caso.patrones.push_back(aleatoria(entre(1, 24), "AC"));
+                }
+                break;
+            }
+            case 4: {
+                // Prefijos, sufijos y repetidos: los empates entre patrones
+                caso.descripcion = "prefijos y sufijos";
+                caso.texto = aleatoria(entre(100, 3000));
+                string base = caso.texto.substr(entre(0, caso.texto.length() - 60), 60);
+                caso.patrones = {base, base.substr(0, entre(1, 59)), base.substr(entre(1, 59)), base,
+                                 base.substr(entre(1, 20), 30)};
+                break;
+            }
+            default: {
+                // Largo como en la aplicación (100 a 1000 bases)
+                caso.descripcion = "patrones largos";
+                caso.texto = aleatoria(entre(0, 20000));
+                for (size_t i = entre(1, 4); i > 0; i--) {
+                    caso.patrones.push_back(aleatoria(entre(100, 1000)));
+                }
+                plantar(caso, entre(0, 3));
+                break;
+            }
+        }
+        return caso;
+    }
+
+private:
+    mt19937_64 azar;
+};
+
+/**
+ * KMP, Rabin-Karp y SIMD con cada patrón por separado
+ */
+void probarUnPatron(const Caso& caso, Verificador& verificador) {
+    SecuenciaEmpaquetada texto(caso.texto);
+
+    for (const string& patron : caso.patrones) {
+        int esperada = ReferenciaIngenua::buscar(caso.texto, patron);
+        SecuenciaEmpaquetada empaquetado(patron);
+
+        vector<pair<string, int>> obtenidas = {
+            {"kmp", KMP::buscar(caso.texto, patron)},
+            {"kmp empaquetado", KMP::buscar(texto, empaquetado)},
+            {"rabin-karp", RabinKarp::buscar(caso.texto, patron)},
+            {"rabin-karp empaquetado", RabinKarp::buscar(texto, empaquetado)},
+            {"simd", BusquedaSIMD::buscar(caso.texto, patron)},
+            {"simd empaquetado", BusquedaSIMD::buscar(texto, empaquetado)},
+        };
+        for (const auto& obtenida : obtenidas) {
+            verificador.comprobar(obtenida.second == esperada, caso, obtenida.first, [&]() {
+                return "patron de " + to_string(patron.length()) + " bases: se esperaba " + to_string(esperada) +
+                       ", se obtuvo " + to_string(obtenida.second);
+            });
+        }
+    }
+}
+
+/**
+ * Aho-Corasick (las tres políticas) y Rabin-Karp múltiple
+ */
+void probarMultiplesPatrones(const Caso& caso, Verificador& verificador) {
+    SecuenciaEmpaquetada texto(caso.texto);
+    AhoCorasick automata(caso.patrones);
+    RabinKarpMultiple rabinKarp(caso.patrones);
+
+    // Todas: el orden entre apariciones con el mismo final y largo (patrones
+    // repetidos) no está definido, así que se comparan ordenadas
+    vector<CoincidenciaMultiple> esperadas = ReferenciaIngenua::todas(caso.texto, caso.patrones);
+    auto ordenar = [&](vector<CoincidenciaMultiple> coincidencias) {
+        stable_sort(coincidencias.begin(), coincidencias.end(),
+                    [&](const CoincidenciaMultiple& a, const CoincidenciaMultiple& b) {
+                        return ReferenciaIngenua::clave(caso.patrones, a) < ReferenciaIngenua::clave(caso.patrones, b);
+                    });
+        return coincidencias;
+    };
+    auto iguales = [](const vector<CoincidenciaMultiple>& a, const vector<CoincidenciaMultiple>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); i++) {
+            if (a[i].patronId != b[i].patronId || a[i].posicion != b[i].posicion) return false;
+        }
+        return true;
+    };
+
+    vector<pair<string, vector<CoincidenciaMultiple>>> todas = {
+        {"aho-corasick todas", automata.buscarEn(string_view(caso.texto))},
+        {"aho-corasick todas empaquetado", automata.buscarEn(texto)},
+    };
+    for (const auto& obtenidas : todas) {
+        verificador.comprobar(iguales(ordenar(obtenidas.second), esperadas), caso, obtenidas.first, [&]() {
+            return "se esperaban " + describir(esperadas) + "; se obtuvieron " + describir(ordenar(obtenidas.second));
+        });
+    }
+
+    // Primera
+    CoincidenciaMultiple esperada{-1, -1};
+    ReferenciaIngenua::primera(caso.texto, caso.patrones, esperada);
+
+    auto primeraAho = [&](const auto& cadena) {
+        CoincidenciaMultiple primera{-1, -1};
+        automata.buscarEn(cadena, AhoCorasick::PRIMERA, [&](const CoincidenciaMultiple& c) {
+            if (primera.posicion == -1) primera = c;
+        });
+        return primera;
+    };
+    auto primeraRabinKarp = [&](const auto& cadena) {
+        CoincidenciaMultiple primera{-1, -1};
+        if (!rabinKarp.buscarPrimera(cadena, primera)) primera = {-1, -1};
+        return primera;
+    };
+
+    vector<pair<string, CoincidenciaMultiple>> primeras = {
+        {"aho-corasick primera", primeraAho(string_view(caso.texto))},
+        {"aho-corasick primera empaquetado", primeraAho(texto)},
+        {"rabin-karp-multiple", primeraRabinKarp(string_view(caso.texto))},
+        {"rabin-karp-multiple empaquetado", primeraRabinKarp(texto)},
+    };
+    for (const auto& obtenida : primeras) {
+        bool igual = obtenida.second.posicion == esperada.posicion &&
+                     (esperada.posicion == -1 || obtenida.second.patronId == esperada.patronId);
+        verificador.comprobar(igual, caso, obtenida.first, [&]() {
+            return "se esperaba " + describir(esperada) + ", se obtuvo " + describir(obtenida.second);
+        });
+    }
+
+    // Primera de cada patrón
+    vector<int> esperadaPorPatron(caso.patrones.size());
+    for (size_t id = 0; id < caso.patrones.size(); id++) {
+        esperadaPorPatron[id] = ReferenciaIngenua::buscar(caso.texto, caso.patrones[id]);
+    }
+    auto primeraPorPatron = [&](const auto& cadena) {
+        vector<int> obtenida(caso.patrones.size(), -1);
+        bool repetida = false;
+        automata.buscarEn(cadena, AhoCorasick::PRIMERA_POR_PATRON, [&](const CoincidenciaMultiple& c) {
+            repetida |= obtenida[c.patronId] != -1;
+            obtenida[c.patronId] = c.posicion;
+        });
+        return repetida ? vector<int>() : obtenida;
+    };
+    vector<pair<string, vector<int>>> porPatron = {
+        {"aho-corasick primera por patron", primeraPorPatron(string_view(caso.texto))},
+        {"aho-corasick primera por patron empaquetado", primeraPorPatron(texto)},
+    };
+    for (const auto& obtenida : porPatron) {
+        verificador.comprobar(obtenida.second == esperadaPorPatron, caso, obtenida.first, [&]() {
+            ostringstream detalle;
+            detalle << "posiciones por patron distintas (o un patron reportado dos veces):";
+            for (size_t id = 0; id < esperadaPorPatron.size(); id++) {
+                detalle << " " << esperadaPorPatron[id] << "/"
+                        << (id < obtenida.second.size() ? to_string(obtenida.second[id]) : "?");
+            }
+            return detalle.str();
+        });
+    }
+}
+
+/**
+ * Myers (edición) y Hamming con k errores, contra la programación dinámica
+ */
+void probarAproximada(const Caso& caso, GeneradorCasos& generador, Verificador& verificador) {
+    SecuenciaEmpaquetada texto(caso.texto);
+
+    for (const string& patron : caso.patrones) {
+        if (patron.length() < 2 || patron.length() > 300) continue;
+        size_t k = generador.entre(0, min<size_t>(4, patron.length() - 1));
+
+        // Hamming: la posición más a la izquierda con <= k diferencias
+        CoincidenciaAproximada esperada{-1, 0};
+        for (size_t i = 0; i + patron.length() <= caso.texto.length(); i++) {
+            size_t diferencias = ReferenciaIngenua::diferencias(caso.texto, i, patron);
+            if (diferencias <= k) {
+                esperada = {static_cast<int>(i), static_cast<int>(diferencias)};
+                break;
+            }
+        }
+        BusquedaAproximada hamming(patron, static_cast<int>(k), BusquedaAproximada::HAMMING);
+        vector<pair<string, CoincidenciaAproximada>> obtenidas = {
+            {"hamming", hamming.buscarEn(string_view(caso.texto))},
+            {"hamming empaquetado", hamming.buscarEn(texto)},
+        };
+        for (const auto& obtenida : obtenidas) {
+            bool igual = obtenida.second.posicion == esperada.posicion &&
+                         (esperada.posicion == -1 || obtenida.second.distancia == esperada.distancia);
+            verificador.comprobar(igual, caso, obtenida.first, [&]() {
+                return "k=" + to_string(k) + ": se esperaba " + to_string(esperada.posicion) + " (" +
+                       to_string(esperada.distancia) + " errores), se obtuvo " + to_string(obtenida.second.posicion) +
+                       " (" + to_string(obtenida.second.distancia) + " errores)";
+            });
+        }
+
+        // Edición: hay coincidencia si y solo si Sellers la encuentra, y la
+        // reportada es un fragmento real con esa distancia (<= k) que no
+        // empieza después del primer final posible
+        long primerFin = ReferenciaIngenua::primerFinEdicion(caso.texto, patron, k);
+        BusquedaAproximada edicion(patron, static_cast<int>(k), BusquedaAproximada::EDICION);
+        obtenidas = {
+            {"myers", edicion.buscarEn(string_view(caso.texto))},
+            {"myers empaquetado", edicion.buscarEn(texto)},
+        };
+        for (const auto& obtenida : obtenidas) {
+            const CoincidenciaAproximada& c = obtenida.second;
+            bool correcta = (c.posicion == -1) == (primerFin == -1);
+            if (correcta && c.posicion != -1) {
+                correcta = c.distancia >= 0 && static_cast<size_t>(c.distancia) <= k &&
+                           c.posicion <= primerFin &&
+                           ReferenciaIngenua::edicionDesde(caso.texto, c.posicion, patron) <= static_cast<size_t>(c.distancia);
+            }
+            verificador.comprobar(correcta, caso, obtenida.first, [&]() {
+                return "k=" + to_string(k) + ", primer final " + to_string(primerFin) + ": se obtuvo " +
+                       to_string(c.posicion) + " (" + to_string(c.distancia) + " errores)";
+            });
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t semilla = 20240601;
+    int numCasos = 600;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string opcion = argv[i];
+        if (opcion == "--semilla") {
+            semilla = stoull(argv[i + 1]);
+        } else if (opcion == "--casos") {
+            numCasos = stoi(argv[i + 1]);
+        } else {
+            cerr << "Uso: prueba_motores [--semilla S] [--casos N]" << endl;
+            return 2;
+        }
+    }
+
+    GeneradorCasos generador(semilla);
+    Verificador verificador;
+    for (int numero = 0; numero < numCasos; numero++) {
+        Caso caso = generador.siguiente(numero);
+        probarUnPatron(caso, verificador);
+        probarMultiplesPatrones(caso, verificador);
+        probarAproximada(caso, generador, verificador);
+    }
+
+    cout << numCasos << " casos (semilla " << semilla << ", " << BusquedaSIMD::toString(BusquedaSIMD::instruccionesDisponibles())
+         << "): " << verificador.comprobaciones << " comprobaciones, " << verificador.fallos << " fallos" << endl;
+    return verificador.fallos == 0 ? 0 : 1;
+}
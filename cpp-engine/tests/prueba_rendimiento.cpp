@@ -0,0 +1,247 @@
+/**
+ * Control de regresiones de rendimiento de los motores (ctest -R rendimiento)
+ *
+ * Mide cada motor sobre un texto fijo de ADN y lo expresa como
+ * aceleración sobre el buscador ingenuo, medido intercalado con el motor
+ * (el mejor tiempo de varias repeticiones de cada uno): así la línea base
+ * guardada en el repositorio no depende de la velocidad de la máquina y
+ * las variaciones de la carga afectan a ambos por igual. Falla si algún
+ * motor queda por debajo de su línea base en más de la tolerancia.
+ *
+ * La aceleración de SIMD depende de las instrucciones de la CPU, así que
+ * la línea base guarda una por conjunto de instrucciones ("avx2 simd 32.02")
+ * y solo se compara con la de esta CPU.
+ *
+ * Uso: prueba_rendimiento <linea_base.txt> [--tolerancia F] [--actualizar]
+ *   --actualizar  Reescribe la línea base de este conjunto de instrucciones
+ *                 con las aceleraciones medidas (la menor de
+ *                 RONDAS_LINEA_BASE rondas, para que una ronda con suerte no
+ *                 deje una línea base inalcanzable); las de los demás quedan
+ *
+ * Solo tiene sentido en una compilación optimizada y con una línea base
+ * para esta CPU: si no, termina con SALTADA (77), que CTest reporta como
+ * prueba omitida.
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include "referencia_ingenua.h"
+#include "../include/kmp.h"
+#include "../include/rabin_karp.h"
+#include "../include/aho_corasick.h"
+#include "../include/busqueda_simd.h"
+#include "../include/busqueda_aproximada.h"
+#include "../include/secuencia_empaquetada.h"
+using namespace std;
+
+const int SALTADA = 77;
+
+const size_t LONGITUD_TEXTO = 4 << 20;
+const int REPETICIONES = 9;
+const double TOLERANCIA_POR_DEFECTO = 0.30;
+const int RONDAS_LINEA_BASE = 3;
+
+// Los resultados se acumulan aquí para que el compilador no descarte el cálculo
+volatile long sumidero = 0;
+
+double cronometrar(const function<long()>& prueba) {
+    auto inicio = chrono::steady_clock::now();
+    sumidero = sumidero + prueba();
+    auto fin = chrono::steady_clock::now();
+    return chrono::duration<double, nano>(fin - inicio).count();
+}
+
+/**
+ * Mejores tiempos (ns) del motor y de la referencia en REPETICIONES
+ * ejecuciones alternadas
+ */
+pair<double, double> medir(const function<long()>& motor, const function<long()>& referencia) {
+    double mejorMotor = 0;
+    double mejorReferencia = 0;
+    for (int i = 0; i < REPETICIONES; i++) {
+        double tiempoMotor = cronometrar(motor);
+        double tiempoReferencia = cronometrar(referencia);
+        if (i == 0 || tiempoMotor < mejorMotor) mejorMotor = tiempoMotor;
+        if (i == 0 || tiempoReferencia < mejorReferencia) mejorReferencia = tiempoReferencia;
+    }
+    return {mejorMotor, mejorReferencia};
+}
+
+string aleatoria(mt19937_64& azar, size_t n) {
+    const char bases[] = "ACGT";
+    string cadena(n, 'A');
+    for (char& base : cadena) {
+        base = bases[azar() & 3];
+    }
+    return cadena;
+}
+
+/**
+ * Lee "instrucciones motor aceleracion" por línea (las que empiezan con #
+ * se ignoran)
+ * @return Por conjunto de instrucciones, la aceleración de cada motor
+ */
+map<string, map<string, double>> leerLineaBase(const string& ruta) {
+    map<string, map<string, double>> lineaBase;
+    ifstream archivo(ruta);
+    string linea;
+    while (getline(archivo, linea)) {
+        if (linea.empty() || linea[0] == '#') continue;
+        istringstream campos(linea);
+        string instrucciones;
+        string motor;
+        double aceleracion;
+        if (campos >> instrucciones >> motor >> aceleracion) {
+            lineaBase[instrucciones][motor] = aceleracion;
+        }
+    }
+    return lineaBase;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Uso: prueba_rendimiento <linea_base.txt> [--tolerancia F] [--actualizar]" << endl;
+        return 2;
+    }
+    string rutaLineaBase = argv[1];
+    double tolerancia = TOLERANCIA_POR_DEFECTO;
+    bool actualizar = false;
+    for (int i = 2; i < argc; i++) {
+        string opcion = argv[i];
+        if (opcion == "--tolerancia" && i + 1 < argc) {
+            tolerancia = stod(argv[++i]);
+        } else if (opcion == "--actualizar") {
+            actualizar = true;
+        } else {
+            cerr << "Opción desconocida: " << opcion << endl;
+            return 2;
+        }
+    }
+
+#if !defined(__OPTIMIZE__) && !(defined(_MSC_VER) && defined(NDEBUG))
+    cout << "Compilación sin optimizar: la prueba de rendimiento se omite" << endl;
+    return SALTADA;
+#endif
+
+    string instrucciones = BusquedaSIMD::toString(BusquedaSIMD::instruccionesDisponibles());
+    map<string, map<string, double>> lineasBase = leerLineaBase(rutaLineaBase);
+    if (!actualizar && lineasBase[instrucciones].empty()) {
+        cout << "Sin línea base para " << instrucciones << ": la prueba de rendimiento se omite" << endl
+             << "(generarla con prueba_rendimiento " << rutaLineaBase << " --actualizar)" << endl;
+        return SALTADA;
+    }
+    const map<string, double>& lineaBase = lineasBase[instrucciones];
+
+    // Texto y patrones fijos: ninguno aparece, así se recorre todo el texto
+    mt19937_64 azar(7);
+    string texto = aleatoria(azar, LONGITUD_TEXTO);
+    SecuenciaEmpaquetada textoEmpaquetado(texto);
+    string patron = aleatoria(azar, 200);
+    SecuenciaEmpaquetada patronEmpaquetado(patron);
+    vector<string> patrones;
+    for (int i = 0; i < 16; i++) {
+        patrones.push_back(aleatoria(azar, 100 + 13 * i));
+    }
+    // Rabin-Karp múltiple, con su caso de uso: muchos patrones de un solo largo
+    vector<string> patronesMismoLargo;
+    for (int i = 0; i < 64; i++) {
+        patronesMismoLargo.push_back(aleatoria(azar, 120));
+    }
+    AhoCorasick automata(patrones);
+    RabinKarpMultiple rabinKarpMultiple(patronesMismoLargo);
+    BusquedaAproximada myers(patron.substr(0, 150), 3, BusquedaAproximada::EDICION);
+    BusquedaAproximada hamming(patron.substr(0, 150), 3, BusquedaAproximada::HAMMING);
+
+    auto primeraAho = [&](const auto& cadena) {
+        long posicion = -1;
+        automata.buscarEn(cadena, AhoCorasick::PRIMERA, [&](const CoincidenciaMultiple& c) {
+            posicion = c.posicion;
+        });
+        return posicion;
+    };
+    auto primeraRabinKarp = [&](const auto& cadena) {
+        CoincidenciaMultiple c{-1, -1};
+        rabinKarpMultiple.buscarPrimera(cadena, c);
+        return static_cast<long>(c.posicion);
+    };
+
+    vector<pair<string, function<long()>>> motores = {
+        {"kmp", [&]() { return KMP::buscar(texto, patron); }},
+        {"kmp-empaquetado", [&]() { return KMP::buscar(textoEmpaquetado, patronEmpaquetado); }},
+        {"rabin-karp", [&]() { return RabinKarp::buscar(texto, patron); }},
+        {"rabin-karp-empaquetado", [&]() { return RabinKarp::buscar(textoEmpaquetado, patronEmpaquetado); }},
+        {"simd", [&]() { return BusquedaSIMD::buscar(texto, patron); }},
+        {"simd-empaquetado", [&]() { return BusquedaSIMD::buscar(textoEmpaquetado, patronEmpaquetado); }},
+        {"aho-corasick", [&]() { return primeraAho(string_view(texto)); }},
+        {"aho-corasick-empaquetado", [&]() { return primeraAho(textoEmpaquetado); }},
+        {"rabin-karp-multiple", [&]() { return primeraRabinKarp(string_view(texto)); }},
+        {"rabin-karp-multiple-empaquetado", [&]() { return primeraRabinKarp(textoEmpaquetado); }},
+        {"myers", [&]() { return static_cast<long>(myers.buscarEn(string_view(texto)).posicion); }},
+        {"hamming", [&]() { return static_cast<long>(hamming.buscarEn(string_view(texto)).posicion); }},
+    };
+
+    auto referencia = [&]() { return static_cast<long>(ReferenciaIngenua::buscar(texto, patron)); };
+
+    map<string, double> medidas;
+    int fallos = 0;
+
+    cout << "Aceleración sobre la referencia ingenua (" << instrucciones << ", tolerancia " << fixed << setprecision(0) << tolerancia * 100 << "%)" << endl;
+
+    for (const auto& motor : motores) {
+        double aceleracion = 0;
+        double tiempo = 0;
+        for (int ronda = 0; ronda < (actualizar ? RONDAS_LINEA_BASE : 1); ronda++) {
+            pair<double, double> tiempos = medir(motor.second, referencia);
+            if (ronda == 0 || tiempos.second / tiempos.first < aceleracion) {
+                tiempo = tiempos.first;
+                aceleracion = tiempos.second / tiempos.first;
+            }
+        }
+        medidas[motor.first] = aceleracion;
+
+        cout << "  " << left << setw(32) << motor.first << right << setprecision(1) << setw(9)
+             << LONGITUD_TEXTO / tiempo * 1000 << " MB/s  x" << setprecision(2) << aceleracion;
+
+        auto base = lineaBase.find(motor.first);
+        if (base == lineaBase.end()) {
+            cout << "  (sin línea base)" << endl;
+            continue;
+        }
+        cout << "  (línea base x" << base->second << ")";
+        if (!actualizar && aceleracion < base->second * (1 - tolerancia)) {
+            cout << "  REGRESIÓN";
+            fallos++;
+        }
+        cout << endl;
+    }
+
+    if (actualizar) {
+        ofstream archivo(rutaLineaBase);
+        if (!archivo) {
+            cerr << "No se pudo escribir " << rutaLineaBase << endl;
+            return 1;
+        }
+        lineasBase[instrucciones] = medidas;
+        archivo << "# Aceleración de cada motor sobre la referencia ingenua, por conjunto de\n"
+                << "# instrucciones de la CPU (ver prueba_rendimiento.cpp)\n"
+                << "# Regenerar con: prueba_rendimiento <este archivo> --actualizar\n";
+        for (const auto& porInstrucciones : lineasBase) {
+            for (const auto& medida : porInstrucciones.second) {
+                archivo << porInstrucciones.first << " " << medida.first << " "
+                        << fixed << setprecision(2) << medida.second << "\n";
+            }
+        }
+        cout << "Línea base actualizada: " << rutaLineaBase << endl;
+        return 0;
+    }
+
+    return fallos == 0 ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+#ifndef REFERENCIA_INGENUA_H
+#define REFERENCIA_INGENUA_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include "../include/aho_corasick.h"
+
+/**
+ * Buscadores ingenuos (comparan carácter por carácter en cada posición)
+ * que sirven de referencia para las pruebas: son lentos pero obviamente
+ * correctos
+ */
+namespace ReferenciaIngenua {
+
+inline bool coincideEn(std::string_view texto, size_t posicion, std::string_view patron) {
+    if (posicion + patron.length() > texto.length()) {
+        return false;
+    }
+    for (size_t j = 0; j < patron.length(); j++) {
+        if (texto[posicion + j] != patron[j]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Primera aparición del patrón (-1 si no aparece)
+ */
+inline int buscar(std::string_view texto, std::string_view patron) {
+    if (patron.length() > texto.length()) {
+        return -1;
+    }
+    for (size_t i = 0; i + patron.length() <= texto.length(); i++) {
+        if (coincideEn(texto, i, patron)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+/**
+ * Orden de las coincidencias de varios patrones: por final, a igual final
+ * la del patrón más largo y luego la de menor índice
+ */
+inline std::tuple<size_t, long, int> clave(const std::vector<std::string>& patrones, const CoincidenciaMultiple& c) {
+    long longitud = static_cast<long>(patrones[c.patronId].length());
+    return std::make_tuple(c.posicion + longitud, -longitud, c.patronId);
+}
+
+/**
+ * Todas las apariciones de todos los patrones, en el orden de clave()
+ */
+inline std::vector<CoincidenciaMultiple> todas(std::string_view texto, const std::vector<std::string>& patrones) {
+    std::vector<CoincidenciaMultiple> resultado;
+    for (size_t id = 0; id < patrones.size(); id++) {
+        for (size_t i = 0; i + patrones[id].length() <= texto.length(); i++) {
+            if (coincideEn(texto, i, patrones[id])) {
+                resultado.push_back({static_cast<int>(id), static_cast<int>(i)});
+            }
+        }
+    }
+    std::sort(resultado.begin(), resultado.end(), [&](const CoincidenciaMultiple& a, const CoincidenciaMultiple& b) {
+        return clave(patrones, a) < clave(patrones, b);
+    });
+    return resultado;
+}
+
+/**
+ * La primera según clave() (la que reporta AhoCorasick::PRIMERA)
+ * @return false si ningún patrón aparece
+ */
+inline bool primera(std::string_view texto, const std::vector<std::string>& patrones, CoincidenciaMultiple& coincidencia) {
+    std::vector<CoincidenciaMultiple> apariciones = todas(texto, patrones);
+    if (apariciones.empty()) {
+        return false;
+    }
+    coincidencia = apariciones.front();
+    return true;
+}
+
+/**
+ * Bases distintas entre el patrón y el texto desde "posicion"
+ */
+inline size_t diferencias(std::string_view texto, size_t posicion, std::string_view patron) {
+    size_t total = 0;
+    for (size_t j = 0; j < patron.length(); j++) {
+        total += texto[posicion + j] != patron[j];
+    }
+    return total;
+}
+
+/**
+ * Distancia de edición mínima entre el patrón y algún fragmento del texto
+ * que empieza en "inicio" (programación dinámica completa)
+ */
+inline size_t edicionDesde(std::string_view texto, size_t inicio, std::string_view patron) {
+    size_t m = patron.length();
+    std::string_view resto = texto.substr(inicio);
+
+    // fila[i] = distancia entre patron[0, i) y resto[0, j)
+    std::vector<size_t> fila(m + 1);
+    for (size_t i = 0; i <= m; i++) fila[i] = i;
+    size_t mejor = fila[m];
+
+    for (size_t j = 1; j <= resto.length() && j <= 2 * m; j++) {
+        size_t diagonal = fila[0];
+        fila[0] = j;
+        for (size_t i = 1; i <= m; i++) {
+            size_t arriba = fila[i];
+            fila[i] = std::min({arriba + 1, fila[i - 1] + 1, diagonal + (patron[i - 1] != resto[j - 1])});
+            diagonal = arriba;
+        }
+        mejor = std::min(mejor, fila[m]);
+    }
+    return mejor;
+}
+
+/**
+ * Primer final (exclusivo) de un fragmento del texto a distancia de
+ * edición <= k del patrón, o -1 si no hay (algoritmo de Sellers)
+ */
+inline long primerFinEdicion(std::string_view texto, std::string_view patron, size_t k) {
+    size_t m = patron.length();
+    std::vector<size_t> columna(m + 1);
+    for (size_t i = 0; i <= m; i++) columna[i] = i;
+    if (columna[m] <= k) {
+        return 0;
+    }
+
+    for (size_t j = 1; j <= texto.length(); j++) {
+        size_t diagonal = columna[0];
+        columna[0] = 0;   // El fragmento puede empezar en cualquier lugar
+        for (size_t i = 1; i <= m; i++) {
+            size_t arriba = columna[i];
+            columna[i] = std::min({arriba + 1, columna[i - 1] + 1, diagonal + (patron[i - 1] != texto[j - 1])});
+            diagonal = arriba;
+        }
+        if (columna[m] <= k) {
+            return static_cast<long>(j);
+        }
+    }
+    return -1;
+}
+
+}
+
+#endif // REFERENCIA_INGENUA_H